@@ -0,0 +1,63 @@
+/*
+ * Arduino core functions and objects declared in shim/Arduino.h (and the network/FS shims) for host builds
+ */
+#include <chrono>
+#include <thread>
+#include "Arduino.h"
+#include "WiFi.h"
+#include "ETH.h"
+#include "LittleFS.h"
+
+// function local so it is valid while other translation units construct their globals (strip)
+static std::chrono::steady_clock::time_point bootTime(void) {
+  static const std::chrono::steady_clock::time_point t = std::chrono::steady_clock::now();
+  return t;
+}
+
+unsigned long millis(void) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - bootTime()).count();
+}
+
+unsigned long micros(void) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - bootTime()).count();
+}
+
+void delay(unsigned long ms)               { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+void delayMicroseconds(unsigned int us)    { std::this_thread::sleep_for(std::chrono::microseconds(us)); }
+void yield(void)                           {}
+
+// xorshift32, seeded like esp_random() would not be reproducible so a fixed seed is used
+static uint32_t randomState = 2463534242UL;
+static uint32_t nextRandom(void) {
+  randomState ^= randomState << 13;
+  randomState ^= randomState >> 17;
+  randomState ^= randomState << 5;
+  return randomState;
+}
+
+long random(long howbig) {
+  if (howbig <= 0) return 0;
+  return nextRandom() % howbig;
+}
+
+long random(long howsmall, long howbig) {
+  if (howsmall >= howbig) return howsmall;
+  return random(howbig - howsmall) + howsmall;
+}
+
+void randomSeed(unsigned long seed) {
+  if (seed != 0) randomState = seed;
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  if (in_max == in_min) return out_min;
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+uint32_t EspClass::getFreeHeap(void) { return 256 * 1024; } // like a freshly booted ESP32, effect RAM is limited by MAX_SEGMENT_DATA
+
+HardwareSerial Serial;
+EspClass       ESP;
+WiFiClass      WiFi;
+ETHClass       ETH;
+fs::FS         LittleFS;
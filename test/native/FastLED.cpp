@@ -0,0 +1,558 @@
+/*
+ * Non inline part of the FastLED 3.6 subset in shim/FastLED.h: HSV conversion, color fills and blends,
+ * 16 entry palettes and Perlin noise (C code paths of FastLED hsv2rgb.cpp, colorutils.cpp, colorpalettes.cpp, noise.cpp)
+ */
+#include "FastLED.h"
+
+uint16_t rand16seed = RAND16_SEED;
+
+// hsv2rgb.cpp
+void hsv2rgb_rainbow(const CHSV &hsv, CRGB &rgb) {
+  uint8_t hue = hsv.hue;
+  uint8_t sat = hsv.sat;
+  uint8_t val = hsv.val;
+
+  uint8_t offset8 = (hue & 0x1F) << 3; // position within the current section (0..248)
+  uint8_t third = scale8(offset8, (256 / 3));
+  uint8_t r, g, b;
+
+  if (!(hue & 0x80)) {
+    if (!(hue & 0x40)) {
+      if (!(hue & 0x20)) { r = 255 - third; g = third; b = 0; }        // red to orange
+      else               { r = 171; g = 85 + third; b = 0; }           // orange to yellow
+    } else {
+      if (!(hue & 0x20)) { uint8_t twothirds = scale8(offset8, ((256 * 2) / 3)); r = 171 - twothirds; g = 170 + third; b = 0; } // yellow to green
+      else               { r = 0; g = 255 - third; b = third; }        // green to aqua
+    }
+  } else {
+    if (!(hue & 0x40)) {
+      if (!(hue & 0x20)) { uint8_t twothirds = scale8(offset8, ((256 * 2) / 3)); r = 0; g = 171 - twothirds; b = 85 + twothirds; } // aqua to blue
+      else               { r = third; g = 0; b = 255 - third; }        // blue to purple
+    } else {
+      if (!(hue & 0x20)) { r = 85 + third; g = 0; b = 171 - third; }   // purple to pink
+      else               { r = 170 + third; g = 0; b = 85 - third; }   // pink to red
+    }
+  }
+
+  if (sat != 255) {
+    if (sat == 0) {
+      r = 255; b = 255; g = 255;
+    } else {
+      uint8_t desat = 255 - sat;
+      desat = scale8_video(desat, desat);
+      uint8_t satscale = 255 - desat;
+      if (r) r = scale8(r, satscale) + 1;
+      if (g) g = scale8(g, satscale) + 1;
+      if (b) b = scale8(b, satscale) + 1;
+      r += desat; g += desat; b += desat;
+    }
+  }
+
+  if (val != 255) {
+    val = scale8_video(val, val);
+    if (val == 0) {
+      r = 0; g = 0; b = 0;
+    } else {
+      if (r) r = scale8(r, val) + 1;
+      if (g) g = scale8(g, val) + 1;
+      if (b) b = scale8(b, val) + 1;
+    }
+  }
+  rgb.r = r; rgb.g = g; rgb.b = b;
+}
+
+void hsv2rgb_rainbow(const CHSV *phsv, CRGB *prgb, int numLeds) {
+  for (int i = 0; i < numLeds; i++) hsv2rgb_rainbow(phsv[i], prgb[i]);
+}
+
+void hsv2rgb_spectrum(const CHSV &hsv, CRGB &rgb) {
+  // raw spectrum conversion on a 0-191 hue range
+  uint8_t value = hsv.val;
+  uint8_t saturation = hsv.sat;
+  uint8_t invsat = 255 - saturation;
+  uint8_t brightness_floor = (value * invsat) / 256;
+  uint8_t color_amplitude = value - brightness_floor;
+  uint8_t hue = scale8(hsv.hue, 191);
+  uint8_t section = hue / 0x40;
+  uint8_t offset = hue % 0x40;
+  uint8_t rampup = offset;
+  uint8_t rampdown = (0x40 - 1) - offset;
+  uint8_t rampup_amp_adj   = (rampup   * color_amplitude) / (256 / 4);
+  uint8_t rampdown_amp_adj = (rampdown * color_amplitude) / (256 / 4);
+  uint8_t rampup_adj_with_floor   = rampup_amp_adj   + brightness_floor;
+  uint8_t rampdown_adj_with_floor = rampdown_amp_adj + brightness_floor;
+  if (section) {
+    if (section == 1) { rgb.r = brightness_floor; rgb.g = rampdown_adj_with_floor; rgb.b = rampup_adj_with_floor; }
+    else              { rgb.r = rampup_adj_with_floor; rgb.g = brightness_floor; rgb.b = rampdown_adj_with_floor; }
+  } else              { rgb.r = rampdown_adj_with_floor; rgb.g = rampup_adj_with_floor; rgb.b = brightness_floor; }
+}
+
+// plain min/max hue conversion instead of FastLED's fitted approximation (only used to seed random palettes)
+CHSV rgb2hsv_approximate(const CRGB &rgb) {
+  uint8_t mx = rgb.r > rgb.g ? rgb.r : rgb.g;
+  if (rgb.b > mx) mx = rgb.b;
+  uint8_t mn = rgb.r < rgb.g ? rgb.r : rgb.g;
+  if (rgb.b < mn) mn = rgb.b;
+  int delta = mx - mn;
+  if (delta == 0) return CHSV(0, 0, mx);
+  int hue;
+  if (mx == rgb.r)      hue =       43 * (rgb.g - rgb.b) / delta;
+  else if (mx == rgb.g) hue =  85 + 43 * (rgb.b - rgb.r) / delta;
+  else                  hue = 171 + 43 * (rgb.r - rgb.g) / delta;
+  return CHSV((uint8_t)hue, delta * 255 / mx, mx);
+}
+
+// colorutils.cpp
+CRGB &nblend(CRGB &existing, const CRGB &overlay, fract8 amountOfOverlay) {
+  if (amountOfOverlay == 0) return existing;
+  if (amountOfOverlay == 255) { existing = overlay; return existing; }
+  existing.red   = blend8(existing.red,   overlay.red,   amountOfOverlay);
+  existing.green = blend8(existing.green, overlay.green, amountOfOverlay);
+  existing.blue  = blend8(existing.blue,  overlay.blue,  amountOfOverlay);
+  return existing;
+}
+
+void nblend(CRGB *existing, const CRGB *overlay, uint16_t count, fract8 amountOfOverlay) {
+  for (uint16_t i = count; i; --i) nblend(*existing++, *overlay++, amountOfOverlay);
+}
+
+CRGB blend(const CRGB &p1, const CRGB &p2, fract8 amountOfP2) {
+  CRGB nu(p1);
+  nblend(nu, p2, amountOfP2);
+  return nu;
+}
+
+CHSV blend(const CHSV &p1, const CHSV &p2, fract8 amountOfP2) {
+  // shortest hue direction
+  CHSV nu(p1);
+  if (amountOfP2 == 0) return nu;
+  if (amountOfP2 == 255) return p2;
+  uint8_t amountOfKeep = 255 - amountOfP2;
+  uint8_t huedelta8 = p2.hue - p1.hue;
+  if (huedelta8 < 128) nu.hue = p1.hue + scale8(huedelta8, amountOfP2);
+  else                 nu.hue = p1.hue - scale8(256 - huedelta8, amountOfP2);
+  nu.sat = scale8(p1.sat, amountOfKeep) + scale8(p2.sat, amountOfP2);
+  nu.val = scale8(p1.val, amountOfKeep) + scale8(p2.val, amountOfP2);
+  return nu;
+}
+
+CRGB HeatColor(uint8_t temperature) {
+  CRGB heatcolor;
+  uint8_t t192 = scale8_video(temperature, 191);
+  uint8_t heatramp = (t192 & 0x3F) << 2;
+  if (t192 & 0x80)      { heatcolor.r = 255; heatcolor.g = 255; heatcolor.b = heatramp; } // hottest
+  else if (t192 & 0x40) { heatcolor.r = 255; heatcolor.g = heatramp; heatcolor.b = 0; }   // middle
+  else                  { heatcolor.r = heatramp; heatcolor.g = 0; heatcolor.b = 0; }     // coolest
+  return heatcolor;
+}
+
+void fill_solid(CRGB *targetArray, int numToFill, const CRGB &color) {
+  for (int i = 0; i < numToFill; i++) targetArray[i] = color;
+}
+
+void fill_rainbow(CRGB *targetArray, int numToFill, uint8_t initialhue, uint8_t deltahue) {
+  CHSV hsv(initialhue, 240, 255);
+  for (int i = 0; i < numToFill; i++) {
+    targetArray[i] = hsv;
+    hsv.hue += deltahue;
+  }
+}
+
+void fill_gradient_RGB(CRGB *leds, uint16_t startpos, CRGB startcolor, uint16_t endpos, CRGB endcolor) {
+  if (endpos < startpos) {
+    uint16_t t = endpos; endpos = startpos; startpos = t;
+    CRGB tc = endcolor; endcolor = startcolor; startcolor = tc;
+  }
+  saccum87 rdistance87 = (endcolor.r - startcolor.r) << 7;
+  saccum87 gdistance87 = (endcolor.g - startcolor.g) << 7;
+  saccum87 bdistance87 = (endcolor.b - startcolor.b) << 7;
+  uint16_t pixeldistance = endpos - startpos;
+  int16_t divisor = pixeldistance ? pixeldistance : 1;
+  saccum87 rdelta87 = (rdistance87 / divisor) * 2;
+  saccum87 gdelta87 = (gdistance87 / divisor) * 2;
+  saccum87 bdelta87 = (bdistance87 / divisor) * 2;
+  accum88 r88 = startcolor.r << 8;
+  accum88 g88 = startcolor.g << 8;
+  accum88 b88 = startcolor.b << 8;
+  for (uint16_t i = startpos; i <= endpos; ++i) {
+    leds[i] = CRGB(r88 >> 8, g88 >> 8, b88 >> 8);
+    r88 += rdelta87; g88 += gdelta87; b88 += bdelta87;
+  }
+}
+
+void fill_gradient_RGB(CRGB *leds, uint16_t numLeds, const CRGB &c1, const CRGB &c2) {
+  fill_gradient_RGB(leds, 0, c1, numLeds - 1, c2);
+}
+
+void fill_gradient_RGB(CRGB *leds, uint16_t numLeds, const CRGB &c1, const CRGB &c2, const CRGB &c3) {
+  uint16_t half = numLeds / 2;
+  uint16_t last = numLeds - 1;
+  fill_gradient_RGB(leds, 0, c1, half, c2);
+  fill_gradient_RGB(leds, half, c2, last, c3);
+}
+
+void fill_gradient_RGB(CRGB *leds, uint16_t numLeds, const CRGB &c1, const CRGB &c2, const CRGB &c3, const CRGB &c4) {
+  uint16_t onethird = numLeds / 3;
+  uint16_t twothirds = (numLeds * 2) / 3;
+  uint16_t last = numLeds - 1;
+  fill_gradient_RGB(leds, 0, c1, onethird, c2);
+  fill_gradient_RGB(leds, onethird, c2, twothirds, c3);
+  fill_gradient_RGB(leds, twothirds, c3, last, c4);
+}
+
+void nscale8_video(CRGB *leds, uint16_t num_leds, uint8_t scale) {
+  for (uint16_t i = 0; i < num_leds; i++) leds[i].nscale8_video(scale);
+}
+
+void fadeLightBy(CRGB *leds, uint16_t num_leds, uint8_t fadeBy) { nscale8_video(leds, num_leds, 255 - fadeBy); }
+
+void nscale8(CRGB *leds, uint16_t num_leds, uint8_t scale) {
+  for (uint16_t i = 0; i < num_leds; i++) leds[i].nscale8(scale);
+}
+
+void fadeToBlackBy(CRGB *leds, uint16_t num_leds, uint8_t fadeBy) { nscale8(leds, num_leds, 255 - fadeBy); }
+
+void blur1d(CRGB *leds, uint16_t numLeds, fract8 blur_amount) {
+  uint8_t keep = 255 - blur_amount;
+  uint8_t seep = blur_amount >> 1;
+  CRGB carryover = CRGB::Black;
+  for (uint16_t i = 0; i < numLeds; ++i) {
+    CRGB cur = leds[i];
+    CRGB part = cur;
+    part.nscale8(seep);
+    cur.nscale8(keep);
+    cur += carryover;
+    if (i) leds[i - 1] += part;
+    leds[i] = cur;
+    carryover = part;
+  }
+}
+
+// colorpalettes.cpp / colorutils.cpp
+CRGBPalette16 &CRGBPalette16::loadDynamicGradientPalette(TDynamicRGBGradientPalette_bytes gpal) {
+  const TRGBGradientPaletteEntryUnion *ent = (const TRGBGradientPaletteEntryUnion *)gpal;
+  TRGBGradientPaletteEntryUnion u;
+
+  // count entries
+  uint16_t count = 0;
+  do {
+    u = *(ent + count);
+    count++;
+  } while (u.index != 255);
+
+  int8_t lastSlotUsed = -1;
+  u = *ent;
+  CRGB rgbstart(u.r, u.g, u.b);
+  int indexstart = 0;
+  while (indexstart < 255) {
+    ent++;
+    u = *ent;
+    int indexend = u.index;
+    CRGB rgbend(u.r, u.g, u.b);
+    uint8_t istart8 = indexstart / 16;
+    uint8_t iend8   = indexend   / 16;
+    if (count < 16) {
+      if ((istart8 <= lastSlotUsed) && (lastSlotUsed < 15)) {
+        istart8 = lastSlotUsed + 1;
+        if (iend8 < istart8) iend8 = istart8;
+      }
+      lastSlotUsed = iend8;
+    }
+    fill_gradient_RGB(&(entries[0]), istart8, rgbstart, iend8, rgbend);
+    indexstart = indexend;
+    rgbstart = rgbend;
+  }
+  return *this;
+}
+
+CRGB ColorFromPalette(const CRGBPalette16 &pal, uint8_t index, uint8_t brightness, TBlendType blendType) {
+  if (blendType == LINEARBLEND_NOWRAP) index = map8(index, 0, 239); // blend range is affected by lo4 blend of values, remap to avoid wrapping
+  uint8_t hi4 = index >> 4;
+  uint8_t lo4 = index & 0x0F;
+
+  const CRGB *entry = &(pal[0]) + hi4;
+  uint8_t red1   = entry->red;
+  uint8_t green1 = entry->green;
+  uint8_t blue1  = entry->blue;
+
+  if (lo4 && blendType != NOBLEND) {
+    if (hi4 == 15) entry = &(pal[0]);
+    else           ++entry;
+    uint8_t f2 = lo4 << 4;
+    uint8_t f1 = 255 - f2;
+    red1   = scale8(red1,   f1) + scale8(entry->red,   f2);
+    green1 = scale8(green1, f1) + scale8(entry->green, f2);
+    blue1  = scale8(blue1,  f1) + scale8(entry->blue,  f2);
+  }
+
+  if (brightness != 255) {
+    if (brightness) {
+      ++brightness; // adjust for rounding
+      // now, since brightness is nonzero, we don't need the full scale8_video logic; we can just to scale8 and then add one (unless scale8 fixed) to all nonzero inputs
+      if (red1)   red1   = scale8(red1,   brightness);
+      if (green1) green1 = scale8(green1, brightness);
+      if (blue1)  blue1  = scale8(blue1,  brightness);
+    } else {
+      red1 = 0; green1 = 0; blue1 = 0;
+    }
+  }
+  return CRGB(red1, green1, blue1);
+}
+
+void nblendPaletteTowardPalette(CRGBPalette16 &current, CRGBPalette16 &target, uint8_t maxChanges) {
+  uint8_t *p1 = (uint8_t *)current.entries;
+  uint8_t *p2 = (uint8_t *)target.entries;
+  const uint8_t totalChannels = sizeof(CRGBPalette16);
+  uint8_t changes = 0;
+  for (uint8_t i = 0; i < totalChannels; i++) {
+    if (p1[i] == p2[i]) continue;
+    if (p1[i] < p2[i]) { p1[i]++; changes++; }
+    if (p1[i] > p2[i]) { p1[i]--; changes++; if (p1[i] > p2[i]) p1[i]--; }
+    if (changes >= maxChanges) break;
+  }
+}
+
+const TProgmemRGBPalette16 CloudColors_p PROGMEM = {
+  CRGB::Blue, CRGB::DarkBlue, CRGB::DarkBlue, CRGB::DarkBlue,
+  CRGB::DarkBlue, CRGB::DarkBlue, CRGB::DarkBlue, CRGB::DarkBlue,
+  CRGB::Blue, CRGB::DarkBlue, CRGB::SkyBlue, CRGB::SkyBlue,
+  CRGB::LightBlue, CRGB::White, CRGB::LightBlue, CRGB::SkyBlue
+};
+
+const TProgmemRGBPalette16 LavaColors_p PROGMEM = {
+  CRGB::Black, CRGB::Maroon, CRGB::Black, CRGB::Maroon,
+  CRGB::DarkRed, CRGB::DarkRed, CRGB::Maroon, CRGB::DarkRed,
+  CRGB::DarkRed, CRGB::DarkRed, CRGB::Red, CRGB::Orange,
+  CRGB::White, CRGB::Orange, CRGB::Red, CRGB::DarkRed
+};
+
+const TProgmemRGBPalette16 OceanColors_p PROGMEM = {
+  CRGB::MidnightBlue, CRGB::DarkBlue, CRGB::MidnightBlue, CRGB::Navy,
+  CRGB::DarkBlue, CRGB::MediumBlue, CRGB::SeaGreen, CRGB::Teal,
+  CRGB::CadetBlue, CRGB::Blue, CRGB::DarkCyan, CRGB::CornflowerBlue,
+  CRGB::Aquamarine, CRGB::SeaGreen, CRGB::Aqua, CRGB::LightSkyBlue
+};
+
+const TProgmemRGBPalette16 ForestColors_p PROGMEM = {
+  CRGB::DarkGreen, CRGB::DarkGreen, CRGB::DarkOliveGreen, CRGB::DarkGreen,
+  CRGB::Green, CRGB::ForestGreen, CRGB::OliveDrab, CRGB::Green,
+  CRGB::SeaGreen, CRGB::MediumAquamarine, CRGB::LimeGreen, CRGB::YellowGreen,
+  CRGB::LightGreen, CRGB::LawnGreen, CRGB::MediumAquamarine, CRGB::ForestGreen
+};
+
+const TProgmemRGBPalette16 RainbowColors_p PROGMEM = {
+  0xFF0000, 0xD52A00, 0xAB5500, 0xAB7F00,
+  0xABAB00, 0x56D500, 0x00FF00, 0x00D52A,
+  0x00AB55, 0x0056AA, 0x0000FF, 0x2A00D5,
+  0x5500AB, 0x7F0081, 0xAB0055, 0xD5002B
+};
+
+const TProgmemRGBPalette16 RainbowStripeColors_p PROGMEM = {
+  0xFF0000, 0x000000, 0xAB5500, 0x000000,
+  0xABAB00, 0x000000, 0x00FF00, 0x000000,
+  0x00AB55, 0x000000, 0x0000FF, 0x000000,
+  0x5500AB, 0x000000, 0xAB0055, 0x000000
+};
+
+const TProgmemRGBPalette16 PartyColors_p PROGMEM = {
+  0x5500AB, 0x84007C, 0xB5004B, 0xE5001B,
+  0xE81700, 0xB84700, 0xAB7700, 0xABAB00,
+  0xAB5500, 0xDD2200, 0xF2000E, 0xC2003E,
+  0x8F0071, 0x5F00A1, 0x2F00D0, 0x0007F9
+};
+
+const TProgmemRGBPalette16 HeatColors_p PROGMEM = {
+  0x000000, 0x330000, 0x660000, 0x990000, 0xCC0000, 0xFF0000,
+  0xFF3300, 0xFF6600, 0xFF9900, 0xFFCC00, 0xFFFF00,
+  0xFFFF33, 0xFFFF66, 0xFFFF99, 0xFFFFCC, 0xFFFFFF
+};
+
+// noise.cpp (Ken Perlin's improved noise in 8.8 and 16.16 fixed point)
+static const uint8_t p[] = {
+  151,160,137, 91, 90, 15,131, 13,201, 95, 96, 53,194,233,  7,225,140, 36,103, 30, 69,142,  8, 99, 37,240, 21, 10, 23,190,  6,148,
+  247,120,234, 75,  0, 26,197, 62, 94,252,219,203,117, 35, 11, 32, 57,177, 33, 88,237,149, 56, 87,174, 20,125,136,171,168, 68,175,
+   74,165, 71,134,139, 48, 27,166, 77,146,158,231, 83,111,229,122, 60,211,133,230,220,105, 92, 41, 55, 46,245, 40,244,102,143, 54,
+   65, 25, 63,161,  1,216, 80, 73,209, 76,132,187,208, 89, 18,169,200,196,135,130,116,188,159, 86,164,100,109,198,173,186,  3, 64,
+   52,217,226,250,124,123,  5,202, 38,147,118,126,255, 82, 85,212,207,206, 59,227, 47, 16, 58, 17,182,189, 28, 42,223,183,170,213,
+  119,248,152,  2, 44,154,163, 70,221,153,101,155,167, 43,172,  9,129, 22, 39,253, 19, 98,108,110, 79,113,224,232,178,185,112,104,
+  218,246, 97,228,251, 34,242,193,238,210,144, 12,191,179,162,241, 81, 51,145,235,249, 14,239,107, 49,192,214, 31,181,199,106,157,
+  184, 84,204,176,115,121, 50, 45,127,  4,150,254,138,236,205, 93,222,114, 67, 29, 24, 72,243,141,128,195, 78, 66,215, 61,156,180,
+  151
+};
+#define P(x) p[(x)]
+
+static inline int16_t grad16(uint8_t hash, int16_t x, int16_t y, int16_t z) {
+  hash = hash & 15;
+  int16_t u = hash < 8 ? x : y;
+  int16_t v = hash < 4 ? y : hash == 12 || hash == 14 ? x : z;
+  if (hash & 1) u = -u;
+  if (hash & 2) v = -v;
+  return avg15(u, v);
+}
+static inline int16_t grad16(uint8_t hash, int16_t x, int16_t y) {
+  hash = hash & 7;
+  int16_t u, v;
+  if (hash < 4) { u = x; v = y; } else { u = y; v = x; }
+  if (hash & 1) u = -u;
+  if (hash & 2) v = -v;
+  return avg15(u, v);
+}
+static inline int16_t grad16(uint8_t hash, int16_t x) {
+  hash = hash & 15;
+  int16_t u, v;
+  if (hash > 8) { u = x; v = x; }
+  else if (hash < 4) { u = x; v = 1; }
+  else { u = 1; v = x; }
+  if (hash & 1) u = -u;
+  if (hash & 2) v = -v;
+  return avg15(u, v);
+}
+static inline int8_t grad8(uint8_t hash, int8_t x, int8_t y, int8_t z) {
+  hash &= 0xF;
+  int8_t u = hash & 8 ? y : x;
+  int8_t v = hash < 4 ? y : hash == 12 || hash == 14 ? x : z;
+  if (hash & 1) u = -u;
+  if (hash & 2) v = -v;
+  return avg7(u, v);
+}
+static inline int8_t grad8(uint8_t hash, int8_t x, int8_t y) {
+  int8_t u, v;
+  if (hash & 4) { u = y; v = x; } else { u = x; v = y; }
+  if (hash & 1) u = -u;
+  if (hash & 2) v = -v;
+  return avg7(u, v);
+}
+static inline int8_t grad8(uint8_t hash, int8_t x) {
+  int8_t u, v;
+  if (hash & 8) { u = x; v = x; }
+  else if (hash & 4) { u = 1; v = x; }
+  else { u = x; v = 1; }
+  if (hash & 1) u = -u;
+  if (hash & 2) v = -v;
+  return avg7(u, v);
+}
+static inline int8_t lerp7by8(int8_t a, int8_t b, fract8 frac) {
+  return b > a ? a + (int8_t)scale8((uint8_t)(b - a), frac) : a - (int8_t)scale8((uint8_t)(a - b), frac);
+}
+
+int16_t inoise16_raw(uint32_t x, uint32_t y, uint32_t z) {
+  uint8_t X = (x >> 16) & 0xFF, Y = (y >> 16) & 0xFF, Z = (z >> 16) & 0xFF;
+  uint8_t A = P(X) + Y, AA = P(A) + Z, AB = P(A + 1) + Z;
+  uint8_t B = P(X + 1) + Y, BA = P(B) + Z, BB = P(B + 1) + Z;
+  uint16_t u = x & 0xFFFF, v = y & 0xFFFF, w = z & 0xFFFF;
+  int16_t xx = (u >> 1) & 0x7FFF, yy = (v >> 1) & 0x7FFF, zz = (w >> 1) & 0x7FFF;
+  const uint16_t N = 0x8000;
+  u = ease16InOutQuad(u); v = ease16InOutQuad(v); w = ease16InOutQuad(w);
+  int16_t X1 = lerp15by16(grad16(P(AA), xx, yy, zz), grad16(P(BA), xx - N, yy, zz), u);
+  int16_t X2 = lerp15by16(grad16(P(AB), xx, yy - N, zz), grad16(P(BB), xx - N, yy - N, zz), u);
+  int16_t X3 = lerp15by16(grad16(P(AA + 1), xx, yy, zz - N), grad16(P(BA + 1), xx - N, yy, zz - N), u);
+  int16_t X4 = lerp15by16(grad16(P(AB + 1), xx, yy - N, zz - N), grad16(P(BB + 1), xx - N, yy - N, zz - N), u);
+  int16_t Y1 = lerp15by16(X1, X2, v);
+  int16_t Y2 = lerp15by16(X3, X4, v);
+  return lerp15by16(Y1, Y2, w);
+}
+
+uint16_t inoise16(uint32_t x, uint32_t y, uint32_t z) {
+  int32_t ans = inoise16_raw(x, y, z);
+  ans = ans + 19052L;
+  uint32_t pan = ans;
+  pan *= 440L; // pan = (ans * 220L) >> 7
+  pan >>= 8;
+  return pan > 65535 ? 65535 : pan;
+}
+
+int16_t inoise16_raw(uint32_t x, uint32_t y) {
+  uint8_t X = x >> 16, Y = y >> 16;
+  uint8_t A = P(X) + Y, AA = P(A), AB = P(A + 1);
+  uint8_t B = P(X + 1) + Y, BA = P(B), BB = P(B + 1);
+  uint16_t u = x & 0xFFFF, v = y & 0xFFFF;
+  int16_t xx = (u >> 1) & 0x7FFF, yy = (v >> 1) & 0x7FFF;
+  const uint16_t N = 0x8000;
+  u = ease16InOutQuad(u); v = ease16InOutQuad(v);
+  int16_t X1 = lerp15by16(grad16(P(AA), xx, yy), grad16(P(BA), xx - N, yy), u);
+  int16_t X2 = lerp15by16(grad16(P(AB), xx, yy - N), grad16(P(BB), xx - N, yy - N), u);
+  return lerp15by16(X1, X2, v);
+}
+
+uint16_t inoise16(uint32_t x, uint32_t y) {
+  int32_t ans = inoise16_raw(x, y);
+  ans = ans + 17308L;
+  uint32_t pan = ans;
+  pan *= 484L; // pan = (ans * 242L) >> 7
+  pan >>= 8;
+  return pan > 65535 ? 65535 : pan;
+}
+
+int16_t inoise16_raw(uint32_t x) {
+  uint8_t X = x >> 16;
+  uint8_t A = P(X), AA = P(A);
+  uint8_t B = P(X + 1), BA = P(B);
+  uint16_t u = x & 0xFFFF;
+  int16_t xx = (u >> 1) & 0x7FFF;
+  const uint16_t N = 0x8000;
+  u = ease16InOutQuad(u);
+  return lerp15by16(grad16(P(AA), xx), grad16(P(BA), xx - N), u);
+}
+
+uint16_t inoise16(uint32_t x) {
+  return ((uint32_t)((int32_t)inoise16_raw(x) + 17308L)) << 1;
+}
+
+int8_t inoise8_raw(uint16_t x, uint16_t y, uint16_t z) {
+  uint8_t X = x >> 8, Y = y >> 8, Z = z >> 8;
+  uint8_t A = P(X) + Y, AA = P(A) + Z, AB = P(A + 1) + Z;
+  uint8_t B = P(X + 1) + Y, BA = P(B) + Z, BB = P(B + 1) + Z;
+  uint8_t u = x, v = y, w = z;
+  int8_t xx = ((uint8_t)(x) >> 1) & 0x7F, yy = ((uint8_t)(y) >> 1) & 0x7F, zz = ((uint8_t)(z) >> 1) & 0x7F;
+  const uint8_t N = 0x80;
+  u = ease8InOutQuad(u); v = ease8InOutQuad(v); w = ease8InOutQuad(w);
+  int8_t X1 = lerp7by8(grad8(P(AA), xx, yy, zz), grad8(P(BA), xx - N, yy, zz), u);
+  int8_t X2 = lerp7by8(grad8(P(AB), xx, yy - N, zz), grad8(P(BB), xx - N, yy - N, zz), u);
+  int8_t X3 = lerp7by8(grad8(P(AA + 1), xx, yy, zz - N), grad8(P(BA + 1), xx - N, yy, zz - N), u);
+  int8_t X4 = lerp7by8(grad8(P(AB + 1), xx, yy - N, zz - N), grad8(P(BB + 1), xx - N, yy - N, zz - N), u);
+  int8_t Y1 = lerp7by8(X1, X2, v);
+  int8_t Y2 = lerp7by8(X3, X4, v);
+  return lerp7by8(Y1, Y2, w);
+}
+
+uint8_t inoise8(uint16_t x, uint16_t y, uint16_t z) {
+  int8_t n = inoise8_raw(x, y, z); // -64..+64
+  n += 64;                         //   0..128
+  return qadd8(n, n);              //   0..255
+}
+
+int8_t inoise8_raw(uint16_t x, uint16_t y) {
+  uint8_t X = x >> 8, Y = y >> 8;
+  uint8_t A = P(X) + Y, AA = P(A), AB = P(A + 1);
+  uint8_t B = P(X + 1) + Y, BA = P(B), BB = P(B + 1);
+  uint8_t u = x, v = y;
+  int8_t xx = ((uint8_t)(x) >> 1) & 0x7F, yy = ((uint8_t)(y) >> 1) & 0x7F;
+  const uint8_t N = 0x80;
+  u = ease8InOutQuad(u); v = ease8InOutQuad(v);
+  int8_t X1 = lerp7by8(grad8(P(AA), xx, yy), grad8(P(BA), xx - N, yy), u);
+  int8_t X2 = lerp7by8(grad8(P(AB), xx, yy - N), grad8(P(BB), xx - N, yy - N), u);
+  return lerp7by8(X1, X2, v);
+}
+
+uint8_t inoise8(uint16_t x, uint16_t y) {
+  int8_t n = inoise8_raw(x, y);
+  n += 64;
+  return qadd8(n, n);
+}
+
+int8_t inoise8_raw(uint16_t x) {
+  uint8_t X = x >> 8;
+  uint8_t A = P(X), AA = P(A);
+  uint8_t B = P(X + 1), BA = P(B);
+  uint8_t u = x;
+  int8_t xx = ((uint8_t)(x) >> 1) & 0x7F;
+  const uint8_t N = 0x80;
+  u = ease8InOutQuad(u);
+  return lerp7by8(grad8(P(AA), xx), grad8(P(BA), xx - N), u);
+}
+
+uint8_t inoise8(uint16_t x) {
+  int8_t n = inoise8_raw(x);
+  n += 64;
+  return qadd8(n, n);
+}
@@ -0,0 +1,138 @@
+/*
+ * BusManager for host builds: there are no LED drivers (NeoPixelBus) on host so no buses are created,
+ * strip output goes to a BusCapture sink (FX_bench.cpp). Pixel routing is the same as in wled00/bus_manager.cpp.
+ */
+#include <Arduino.h>
+#include <IPAddress.h>
+#include "const.h"
+#include "pin_manager.h"
+#include "bus_manager.h"
+
+uint8_t *Bus::allocData(size_t size) {
+  if (_data) free(_data);
+  return _data = (uint8_t *)(size>0 ? calloc(size, sizeof(uint8_t)) : nullptr);
+}
+
+BusCapture::BusCapture(uint16_t len)
+: Bus(TYPE_NET_CAPTURE, 0, RGBW_MODE_MANUAL_ONLY, len)
+, _frames(0)
+{
+  _valid = (allocData(_len * sizeof(uint32_t)) != nullptr);
+}
+
+void BusCapture::setPixelColor(uint16_t pix, uint32_t c) {
+  if (!_valid || pix >= _len) return;
+  reinterpret_cast<uint32_t*>(_data)[pix] = c;
+}
+
+void BusCapture::setPixelRange(uint16_t pix, uint16_t len, const uint32_t *c) {
+  if (!_valid || pix >= _len) return;
+  if (pix + len > _len) len = _len - pix;
+  memcpy(reinterpret_cast<uint32_t*>(_data) + pix, c, len * sizeof(uint32_t));
+}
+
+uint32_t BusCapture::getPixelColor(uint16_t pix) {
+  if (!_valid || pix >= _len) return 0;
+  return reinterpret_cast<uint32_t*>(_data)[pix];
+}
+
+void BusCapture::cleanup() {
+  _type = TYPE_NONE;
+  _valid = false;
+  freeData();
+}
+
+int BusManager::add(BusConfig &bc) {
+  return -1; // no LED drivers on host
+}
+
+void BusManager::holdRange(unsigned start, unsigned len) {
+  for (unsigned i = 0; i < numBusses; i++) {
+    Bus *bus = busses[i];
+    if (start < bus->getStart() + bus->getLength() && bus->getStart() < start + len) _heldBusses |= 1UL << i;
+  }
+}
+
+void BusManager::show() {
+  for (unsigned i = 0; i < numBusses; i++) {
+    if (!(_heldBusses & (1UL << i)) && busses[i]->isDirty()) {
+      busses[i]->show();
+      busses[i]->clearDirty();
+    } else _skippedShows++;
+  }
+  _heldBusses = 0;
+}
+
+#ifndef WLED_DISABLE_PROFILER
+void BusManager::resetShowTimes() {}
+#endif
+
+void BusManager::setPixelColor(uint16_t pix, uint32_t c) {
+  for (unsigned i = 0; i < numBusses; i++) {
+    unsigned bstart = busses[i]->getStart();
+    if (pix < bstart || pix >= bstart + busses[i]->getLength()) continue;
+    busses[i]->setPixelColor(pix - bstart, c);
+    busses[i]->markDirty();
+  }
+}
+
+void BusManager::setPixelRange(uint16_t start, uint16_t len, const uint32_t *c) {
+  unsigned end = start + len;
+  for (unsigned i = 0; i < numBusses; i++) {
+    unsigned bstart = busses[i]->getStart();
+    unsigned bend   = bstart + busses[i]->getLength();
+    unsigned s = start > bstart ? start : bstart;
+    unsigned e = end   < bend   ? end   : bend;
+    if (s >= e) continue;
+    busses[i]->setPixelRange(s - bstart, e - s, c + (s - start));
+    busses[i]->markDirty();
+  }
+}
+
+void BusManager::setBrightness(uint8_t b) {
+  for (unsigned i = 0; i < numBusses; i++) busses[i]->setBrightness(b);
+}
+
+void BusManager::setSegmentCCT(int16_t cct, bool allowWBCorrection) {
+  if (cct > 255) cct = 255;
+  if (cct >= 0) {
+    if (allowWBCorrection) cct = 1900 + (cct << 5);
+  } else cct = -1;
+  Bus::setCCT(cct);
+}
+
+uint32_t BusManager::getPixelColor(uint16_t pix) {
+  for (unsigned i = 0; i < numBusses; i++) {
+    unsigned bstart = busses[i]->getStart();
+    if (pix < bstart || pix >= bstart + busses[i]->getLength()) continue;
+    return busses[i]->getPixelColor(pix - bstart);
+  }
+  return 0;
+}
+
+bool BusManager::canAllShow() {
+  for (unsigned i = 0; i < numBusses; i++) {
+    if (!busses[i]->canShow()) return false;
+  }
+  return true;
+}
+
+Bus* BusManager::getBus(uint8_t busNr) {
+  if (busNr >= numBusses) return nullptr;
+  return busses[busNr];
+}
+
+uint16_t BusManager::getTotalLength() {
+  unsigned len = 0;
+  for (unsigned i = 0; i < numBusses; i++) len += busses[i]->getLength();
+  return len;
+}
+
+int16_t  Bus::_cct      = -1;
+uint8_t  Bus::_cctBlend = 0;
+uint8_t  Bus::_gAWM     = 255;
+
+uint8_t  BusManager::numBusses = 0;
+Bus*     BusManager::busses[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES];
+uint32_t BusManager::_skippedShows = 0;
+uint32_t BusManager::_heldBusses = 0;
@@ -0,0 +1,153 @@
+#ifndef WLED_NATIVE_ARDUINO_H
+#define WLED_NATIVE_ARDUINO_H
+
+/*
+ * Arduino core subset used by the effect engine (FX*.cpp, colors.cpp) so it can be built and
+ * benchmarked on Linux/macOS (env:native_fx, test/test_fx_bench); not a general Arduino emulation.
+ * Time comes from the host monotonic clock, flash (PROGMEM) is ordinary memory.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <math.h>
+#include <time.h>
+#include <algorithm>
+#include <functional>
+#include "WString.h"
+#include "Print.h"
+
+#undef unix   // predefined by GNU dialects, used as identifier (Toki.h)
+#undef linux
+
+typedef uint8_t  byte;
+typedef bool     boolean;
+typedef unsigned int word;
+inline uint16_t makeWord(uint8_t h, uint8_t l) { return (h << 8) | l; }
+#define word(...) makeWord(__VA_ARGS__)
+
+#define IRAM_ATTR
+#define ICACHE_RAM_ATTR
+#define ARDUINO_ISR_ATTR
+
+#define PROGMEM
+#define PGM_P              const char *
+#define PSTR(s)            (s)
+#define pgm_read_byte(p)   (*(const uint8_t *)(p))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr)) // same as trig_lut.h so both can be included
+// tables of flash pointers are read with pgm_read_dword() on the 32 bit MCUs; on 64 bit hosts keep the full pointer
+template <typename T> inline uint32_t  pgm_read_dword_native(const T *p)    { return *(const uint32_t *)p; }
+template <typename T> inline uintptr_t pgm_read_dword_native(T * const *p)  { return (uintptr_t)*p; }
+#define pgm_read_dword(p)  pgm_read_dword_native(p)
+#define pgm_read_float(p)  (*(const float *)(p))
+#define pgm_read_ptr(p)    (*(void * const *)(p))
+#define pgm_read_byte_near(p) pgm_read_byte(p)
+#define strlen_P    strlen
+#define strcpy_P    strcpy
+#define strncpy_P   strncpy
+#define strcat_P    strcat
+#define strcmp_P    strcmp
+#define strncmp_P   strncmp
+#define strcasecmp_P strcasecmp
+#define strstr_P    strstr
+#define strchr_P    strchr
+#define memcpy_P    memcpy
+#define sprintf_P   sprintf
+#define snprintf_P  snprintf
+#define sscanf_P    sscanf
+#define vsnprintf_P vsnprintf
+#if !defined(__GLIBC__) || !__GLIBC_PREREQ(2, 38)
+inline size_t strlcpy(char *dst, const char *src, size_t size) {
+  size_t len = strlen(src);
+  if (size) { size_t n = len < size - 1 ? len : size - 1; memcpy(dst, src, n); dst[n] = 0; }
+  return len;
+}
+#endif
+
+#define PI          3.1415926535897932384626433832795
+#define HALF_PI     1.5707963267948966192313216916398
+#define TWO_PI      6.283185307179586476925286766559
+#ifndef M_TWOPI
+#define M_TWOPI     6.283185307179586476925286766559
+#endif
+#define DEG_TO_RAD  0.017453292519943295769236907684886
+#define RAD_TO_DEG  57.295779513082320876798154814105
+#define radians(deg) ((deg)*DEG_TO_RAD)
+#define degrees(rad) ((rad)*RAD_TO_DEG)
+#define sq(x)        ((x)*(x))
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+#define lowByte(w)   ((uint8_t)((w) & 0xff))
+#define highByte(w)  ((uint8_t)((w) >> 8))
+#define bitRead(value, bit)  (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit)   ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+#define _min(a,b) ((a)<(b)?(a):(b))
+#define _max(a,b) ((a)>(b)?(a):(b))
+using std::min;
+using std::max;
+
+#define HIGH 0x1
+#define LOW  0x0
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+#define INPUT_PULLDOWN 0x09
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield(void);
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+inline void    pinMode(uint8_t, uint8_t) {}
+inline void    digitalWrite(uint8_t, uint8_t) {}
+inline int     digitalRead(uint8_t) { return LOW; }
+inline uint16_t analogRead(uint8_t) { return 0; }
+inline void    analogWrite(uint8_t, int) {}
+
+class HardwareSerial : public Print {
+  public:
+    void   begin(unsigned long) {}
+    void   end(void) {}
+    int    available(void) { return 0; }
+    int    read(void) { return -1; }
+    int    peek(void) { return -1; }
+    void   flush(void) { fflush(stdout); }
+    size_t write(uint8_t c) override { return fputc(c, stdout) == EOF ? 0 : 1; }
+    using Print::write;
+    operator bool() const { return true; }
+};
+extern HardwareSerial Serial;
+
+// heap and chip information of the ESP object
+class EspClass {
+  public:
+    uint32_t getFreeHeap(void);
+    uint32_t getMaxAllocHeap(void)     { return getFreeHeap(); }
+    uint32_t getMaxFreeBlockSize(void) { return getFreeHeap(); }
+    uint32_t getHeapSize(void)         { return 320 * 1024; }
+    uint32_t getPsramSize(void)        { return 0; }
+    uint32_t getFreePsram(void)        { return 0; }
+    uint32_t getCpuFreqMHz(void)       { return 240; }
+    uint32_t getFlashChipSize(void)    { return 4 * 1024 * 1024; }
+    uint32_t getCycleCount(void)       { return micros() * 240; }
+    const char *getChipModel(void)     { return "native"; }
+    uint8_t  getChipRevision(void)     { return 0; }
+    uint32_t getChipId(void)           { return 0; }
+    void     restart(void)             { exit(0); }
+};
+extern EspClass ESP;
+
+inline bool psramFound(void) { return false; }
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef WLED_NATIVE_ASYNCTCP_H
+#define WLED_NATIVE_ASYNCTCP_H
+// declarations only: nothing connects on host
+#include "Arduino.h"
+class AsyncClient {
+  public:
+    bool connected(void) { return false; }
+    bool connect(const char *, uint16_t) { return false; }
+    void close(bool = false) {}
+    size_t add(const char *, size_t, uint8_t = 0) { return 0; }
+    bool send(void) { return false; }
+};
+#endif
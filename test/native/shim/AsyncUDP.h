@@ -0,0 +1,23 @@
+#ifndef WLED_NATIVE_ASYNCUDP_H
+#define WLED_NATIVE_ASYNCUDP_H
+// UDP that never receives anything
+#include "Arduino.h"
+#include "IPAddress.h"
+class AsyncUDPPacket {
+  public:
+    uint8_t  *data(void)       { return nullptr; }
+    size_t    length(void)     { return 0; }
+    IPAddress remoteIP(void)   { return IPAddress(); }
+    uint16_t  remotePort(void) { return 0; }
+    bool      isBroadcast(void) { return false; }
+    bool      isMulticast(void) { return false; }
+};
+typedef std::function<void(AsyncUDPPacket &packet)> AuPacketHandlerFunction;
+class AsyncUDP {
+  public:
+    void onPacket(AuPacketHandlerFunction) {}
+    bool listen(uint16_t) { return false; }
+    bool listenMulticast(const IPAddress &, uint16_t, uint8_t = 1) { return false; }
+    void close(void) {}
+};
+#endif
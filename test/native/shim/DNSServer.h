@@ -0,0 +1,11 @@
+#ifndef WLED_NATIVE_DNSSERVER_H
+#define WLED_NATIVE_DNSSERVER_H
+#include "Arduino.h"
+#include "IPAddress.h"
+class DNSServer {
+  public:
+    void processNextRequest(void) {}
+    bool start(uint16_t, const String &, const IPAddress &) { return false; }
+    void stop(void) {}
+};
+#endif
@@ -0,0 +1,82 @@
+#ifndef WLED_NATIVE_ESPASYNCWEBSERVER_H
+#define WLED_NATIVE_ESPASYNCWEBSERVER_H
+
+// web server and websocket interfaces wled.h and AsyncJson-v6.h refer to; nothing is served on host
+#include "Arduino.h"
+#include "FS.h"
+#include "AsyncTCP.h"
+
+static const char CONTENT_TYPE_JSON[] PROGMEM = "application/json";
+
+typedef enum {
+  HTTP_GET     = 0b00000001,
+  HTTP_POST    = 0b00000010,
+  HTTP_DELETE  = 0b00000100,
+  HTTP_PUT     = 0b00001000,
+  HTTP_PATCH   = 0b00010000,
+  HTTP_HEAD    = 0b00100000,
+  HTTP_OPTIONS = 0b01000000,
+  HTTP_ANY     = 0b01111111,
+} WebRequestMethod;
+typedef uint8_t WebRequestMethodComposite;
+
+class AsyncWebServerRequest {
+  public:
+    void *_tempObject = nullptr;
+    WebRequestMethodComposite method(void) const { return HTTP_GET; }
+    const String &url(void) const { return _url; }
+    void addInterestingHeader(const String &) {}
+    void send(int, const String & = String(), const String & = String()) {}
+  private:
+    String _url;
+};
+
+class AsyncWebServerResponse {
+  public:
+    virtual ~AsyncWebServerResponse() {}
+  protected:
+    int    _code = 0;
+    String _contentType;
+    size_t _contentLength = 0;
+    size_t _sentLength = 0;
+};
+
+class AsyncAbstractResponse : public AsyncWebServerResponse {
+  public:
+    virtual bool   _sourceValid() const { return false; }
+    virtual size_t _fillBuffer(uint8_t *, size_t) { return 0; }
+};
+
+class AsyncWebHandler {
+  public:
+    virtual ~AsyncWebHandler() {}
+    virtual bool canHandle(AsyncWebServerRequest *) { return false; }
+    virtual void handleRequest(AsyncWebServerRequest *) {}
+    virtual void handleUpload(AsyncWebServerRequest *, const String &, size_t, uint8_t *, size_t, bool) {}
+    virtual void handleBody(AsyncWebServerRequest *, uint8_t *, size_t, size_t, size_t) {}
+    virtual bool isRequestHandlerTrivial() { return true; }
+};
+
+class AsyncWebServer {
+  public:
+    AsyncWebServer(uint16_t) {}
+    void begin(void) {}
+    void end(void) {}
+};
+
+typedef enum { WS_EVT_CONNECT, WS_EVT_DISCONNECT, WS_EVT_PONG, WS_EVT_ERROR, WS_EVT_DATA } AwsEventType;
+
+class AsyncWebSocketClient {
+  public:
+    uint32_t id(void) { return 0; }
+    bool     queueIsFull(void) { return true; }
+};
+
+class AsyncWebSocket : public AsyncWebHandler {
+  public:
+    AsyncWebSocket(const String &) {}
+    size_t count(void) const { return 0; }
+    void   cleanupClients(uint16_t = 4) {}
+};
+
+#endif
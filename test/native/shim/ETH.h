@@ -0,0 +1,12 @@
+#ifndef WLED_NATIVE_ETH_H
+#define WLED_NATIVE_ETH_H
+#include "WiFi.h"
+class ETHClass {
+  public:
+    IPAddress localIP(void)    { return IPAddress(); }
+    IPAddress subnetMask(void) { return IPAddress(); }
+    IPAddress gatewayIP(void)  { return IPAddress(); }
+    String    macAddress(void) { return String("00:00:00:00:00:00"); }
+};
+extern ETHClass ETH;
+#endif
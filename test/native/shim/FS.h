@@ -0,0 +1,41 @@
+#ifndef WLED_NATIVE_FS_H
+#define WLED_NATIVE_FS_H
+// file system without files: every open fails
+#include "Arduino.h"
+namespace fs {
+class File : public Print {
+  public:
+    size_t write(uint8_t) override { return 0; }
+    size_t write(const uint8_t *, size_t) override { return 0; }
+    using Print::write;
+    int    available(void) { return 0; }
+    int    read(void) { return -1; }
+    size_t read(uint8_t *, size_t) { return 0; }
+    int    peek(void) { return -1; }
+    bool   seek(uint32_t) { return false; }
+    size_t position(void) const { return 0; }
+    size_t size(void) const { return 0; }
+    void   close(void) {}
+    const char *name(void) const { return ""; }
+    bool   isDirectory(void) { return false; }
+    File   openNextFile(const char * = "r") { return File(); }
+    operator bool() const { return false; }
+};
+class FS {
+  public:
+    bool   begin(bool = false) { return false; }
+    File   open(const char *, const char * = "r", bool = false) { return File(); }
+    File   open(const String &path, const char *mode = "r", bool create = false) { return open(path.c_str(), mode, create); }
+    bool   exists(const char *) { return false; }
+    bool   exists(const String &) { return false; }
+    bool   remove(const char *) { return false; }
+    bool   remove(const String &) { return false; }
+    bool   rename(const char *, const char *) { return false; }
+    bool   mkdir(const char *) { return false; }
+    size_t totalBytes(void) { return 0; }
+    size_t usedBytes(void) { return 0; }
+};
+}
+using fs::FS;
+using fs::File;
+#endif
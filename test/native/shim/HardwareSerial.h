@@ -0,0 +1,3 @@
+#pragma once
+// not needed by the effect engine on host
+#include "Arduino.h"
@@ -0,0 +1,25 @@
+#ifndef WLED_NATIVE_IPADDRESS_H
+#define WLED_NATIVE_IPADDRESS_H
+
+#include <stdint.h>
+#include "WString.h"
+
+class IPAddress {
+  public:
+    IPAddress() : _addr{0, 0, 0, 0} {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _addr{a, b, c, d} {}
+    IPAddress(uint32_t a) { for (int i = 0; i < 4; i++) _addr[i] = a >> (8 * i); }
+    operator uint32_t() const { return _addr[0] | _addr[1] << 8 | _addr[2] << 16 | uint32_t(_addr[3]) << 24; }
+    uint8_t  operator[](int i) const { return _addr[i]; }
+    uint8_t &operator[](int i)       { return _addr[i]; }
+    bool operator==(const IPAddress &o) const { return uint32_t(*this) == uint32_t(o); }
+    bool operator!=(const IPAddress &o) const { return !(*this == o); }
+    bool fromString(const char *s) { unsigned a, b, c, d; if (sscanf(s, "%u.%u.%u.%u", &a, &b, &c, &d) != 4) return false; *this = IPAddress(a, b, c, d); return true; }
+    String toString() const { char b[16]; snprintf(b, sizeof(b), "%u.%u.%u.%u", _addr[0], _addr[1], _addr[2], _addr[3]); return String(b); }
+  private:
+    uint8_t _addr[4];
+};
+
+#define INADDR_NONE IPAddress(0, 0, 0, 0)
+
+#endif
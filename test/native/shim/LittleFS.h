@@ -0,0 +1,5 @@
+#ifndef WLED_NATIVE_LITTLEFS_H
+#define WLED_NATIVE_LITTLEFS_H
+#include "FS.h"
+extern fs::FS LittleFS;
+#endif
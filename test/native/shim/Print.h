@@ -0,0 +1,64 @@
+#ifndef WLED_NATIVE_PRINT_H
+#define WLED_NATIVE_PRINT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "WString.h"
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+// Arduino Print: everything ends up in write()
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size) {
+      size_t n = 0;
+      while (size--) n += write(*buffer++);
+      return n;
+    }
+    size_t write(const char *str) { return str ? write((const uint8_t *)str, strlen(str)) : 0; }
+    size_t write(const char *buffer, size_t size) { return write((const uint8_t *)buffer, size); }
+
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3))) {
+      char buf[256];
+      va_list arg;
+      va_start(arg, format);
+      int len = vsnprintf(buf, sizeof(buf), format, arg);
+      va_end(arg);
+      if (len < 0) return 0;
+      return write((const uint8_t *)buf, (size_t)len < sizeof(buf) ? (size_t)len : sizeof(buf) - 1);
+    }
+    size_t printf_P(const char *format, ...) __attribute__((format(printf, 2, 3))) {
+      char buf[256];
+      va_list arg;
+      va_start(arg, format);
+      int len = vsnprintf(buf, sizeof(buf), format, arg);
+      va_end(arg);
+      if (len < 0) return 0;
+      return write((const uint8_t *)buf, (size_t)len < sizeof(buf) ? (size_t)len : sizeof(buf) - 1);
+    }
+
+    size_t print(const __FlashStringHelper *s) { return write((const char *)s); }
+    size_t print(const String &s)              { return write(s.c_str(), s.length()); }
+    size_t print(const char *s)                { return write(s); }
+    size_t print(char c)                       { return write((uint8_t)c); }
+    size_t print(unsigned char n, int base = DEC) { return print((unsigned long)n, base); }
+    size_t print(int n, int base = DEC)           { return print((long)n, base); }
+    size_t print(unsigned n, int base = DEC)      { return print((unsigned long)n, base); }
+    size_t print(long n, int base = DEC)          { return base == DEC ? printf("%ld", n) : print((unsigned long)n, base); }
+    size_t print(unsigned long n, int base = DEC) { return printf(base == HEX ? "%lx" : base == OCT ? "%lo" : "%lu", n); }
+    size_t print(double n, int digits = 2)        { return printf("%.*f", digits, n); }
+
+    template <typename T> size_t println(T v) { size_t n = print(v); return n + println(); }
+    template <typename T> size_t println(T v, int f) { size_t n = print(v, f); return n + println(); }
+    size_t println(void) { return write("\r\n"); }
+};
+
+#endif
@@ -0,0 +1,5 @@
+#ifndef WLED_NATIVE_SPIFFSEDITOR_H
+#define WLED_NATIVE_SPIFFSEDITOR_H
+#include "ESPAsyncWebServer.h"
+#define SPIFFS_EDITOR_AIRCOOOKIE
+#endif
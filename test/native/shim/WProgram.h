@@ -0,0 +1,3 @@
+#pragma once
+// pre-1.0 Arduino header name (Timezone.h includes it when ARDUINO is not defined)
+#include "Arduino.h"
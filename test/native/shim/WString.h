@@ -0,0 +1,86 @@
+#ifndef WLED_NATIVE_WSTRING_H
+#define WLED_NATIVE_WSTRING_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+#define FPSTR(pstr_pointer) (reinterpret_cast<const __FlashStringHelper *>(pstr_pointer))
+
+// Arduino String on top of std::string (only what wled00 sources built natively use)
+class String {
+  public:
+    String(const char *s = "")                 : _s(s ? s : "") {}
+    String(const __FlashStringHelper *s)       : _s(s ? (const char *)s : "") {}
+    String(const std::string &s)               : _s(s) {}
+    String(char c)                             : _s(1, c) {}
+    String(int n, unsigned char base = 10)           { char b[34]; snprintf(b, sizeof(b), base == 16 ? "%x" : "%d", n); _s = b; }
+    String(unsigned n, unsigned char base = 10)      { char b[34]; snprintf(b, sizeof(b), base == 16 ? "%x" : "%u", n); _s = b; }
+    String(long n, unsigned char base = 10)          { char b[34]; snprintf(b, sizeof(b), base == 16 ? "%lx" : "%ld", n); _s = b; }
+    String(unsigned long n, unsigned char base = 10) { char b[34]; snprintf(b, sizeof(b), base == 16 ? "%lx" : "%lu", n); _s = b; }
+    String(unsigned char n, unsigned char base = 10) : String((unsigned)n, base) {}
+    String(float n, unsigned char digits = 2)        { char b[40]; snprintf(b, sizeof(b), "%.*f", digits, n); _s = b; }
+    String(double n, unsigned char digits = 2)       { char b[40]; snprintf(b, sizeof(b), "%.*f", digits, n); _s = b; }
+
+    const char  *c_str(void) const  { return _s.c_str(); }
+    unsigned int length(void) const { return _s.length(); }
+    bool         isEmpty(void) const { return _s.empty(); }
+    bool         reserve(unsigned int n) { _s.reserve(n); return true; }
+    char         charAt(unsigned int i) const { return i < _s.length() ? _s[i] : 0; }
+    char         operator[](unsigned int i) const { return charAt(i); }
+    char        &operator[](unsigned int i) { return _s[i]; }
+
+    String &operator+=(const String &s)  { _s += s._s; return *this; }
+    String &operator+=(const char *s)    { if (s) _s += s; return *this; }
+    String &operator+=(char c)           { _s += c; return *this; }
+    String &operator+=(int n)            { return *this += String(n); }
+    String &operator+=(unsigned n)       { return *this += String(n); }
+    String &operator+=(long n)           { return *this += String(n); }
+    String &operator+=(unsigned long n)  { return *this += String(n); }
+    String &operator+=(const __FlashStringHelper *s) { return *this += (const char *)s; }
+    template <typename T> bool concat(T v) { *this += v; return true; }
+    friend String operator+(String a, const String &b) { a += b; return a; }
+    friend String operator+(String a, const char *b)   { a += b; return a; }
+    friend String operator+(String a, char b)          { a += b; return a; }
+
+    bool operator==(const String &s) const { return _s == s._s; }
+    bool operator==(const char *s) const   { return _s == (s ? s : ""); }
+    bool operator!=(const String &s) const { return _s != s._s; }
+    bool operator!=(const char *s) const   { return !(*this == s); }
+    bool operator<(const String &s) const  { return _s < s._s; }
+    bool equals(const String &s) const           { return _s == s._s; }
+    bool equalsIgnoreCase(const String &s) const { return strcasecmp(c_str(), s.c_str()) == 0; }
+    bool startsWith(const String &s) const       { return _s.compare(0, s._s.length(), s._s) == 0; }
+    bool endsWith(const String &s) const         { return _s.length() >= s._s.length() && _s.compare(_s.length() - s._s.length(), s._s.length(), s._s) == 0; }
+
+    int    indexOf(char c, unsigned int from = 0) const           { size_t p = _s.find(c, from); return p == std::string::npos ? -1 : (int)p; }
+    int    indexOf(const String &s, unsigned int from = 0) const  { size_t p = _s.find(s._s, from); return p == std::string::npos ? -1 : (int)p; }
+    int    lastIndexOf(char c) const                             { size_t p = _s.rfind(c); return p == std::string::npos ? -1 : (int)p; }
+    String substring(unsigned int from) const                    { return from < _s.length() ? String(_s.substr(from)) : String(); }
+    String substring(unsigned int from, unsigned int to) const   { return from < _s.length() && to > from ? String(_s.substr(from, to - from)) : String(); }
+    void   replace(const String &find, const String &with) {
+      if (find._s.empty()) return;
+      for (size_t p = 0; (p = _s.find(find._s, p)) != std::string::npos; p += with._s.length()) _s.replace(p, find._s.length(), with._s);
+    }
+    void   remove(unsigned int index, unsigned int count = (unsigned)-1) { if (index < _s.length()) _s.erase(index, count); }
+    void   toLowerCase(void) { for (char &c : _s) c = tolower(c); }
+    void   toUpperCase(void) { for (char &c : _s) c = toupper(c); }
+    void   trim(void) {
+      size_t b = _s.find_first_not_of(" \t\r\n"), e = _s.find_last_not_of(" \t\r\n");
+      _s = b == std::string::npos ? std::string() : _s.substr(b, e - b + 1);
+    }
+    long   toInt(void) const   { return atol(c_str()); }
+    float  toFloat(void) const { return atof(c_str()); }
+    void   toCharArray(char *buf, unsigned int size, unsigned int index = 0) const {
+      if (!size) return;
+      strncpy(buf, index < _s.length() ? c_str() + index : "", size - 1);
+      buf[size - 1] = 0;
+    }
+
+  private:
+    std::string _s;
+};
+
+#endif
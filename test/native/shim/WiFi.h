@@ -0,0 +1,34 @@
+#ifndef WLED_NATIVE_WIFI_H
+#define WLED_NATIVE_WIFI_H
+
+// there is no network on host: WiFi never connects
+#include "Arduino.h"
+#include "IPAddress.h"
+
+typedef enum { WL_IDLE_STATUS = 0, WL_NO_SSID_AVAIL, WL_SCAN_COMPLETED, WL_CONNECTED, WL_CONNECT_FAILED, WL_CONNECTION_LOST, WL_DISCONNECTED } wl_status_t;
+typedef enum { WIFI_OFF = 0, WIFI_STA = 1, WIFI_AP = 2, WIFI_AP_STA = 3 } wifi_mode_t;
+typedef int WiFiEvent_t;
+#define WIFI_POWER_8_5dBm 34
+
+class WiFiClass {
+  public:
+    wl_status_t status(void)          { return WL_DISCONNECTED; }
+    IPAddress   localIP(void)         { return IPAddress(); }
+    IPAddress   subnetMask(void)      { return IPAddress(); }
+    IPAddress   gatewayIP(void)       { return IPAddress(); }
+    IPAddress   softAPIP(void)        { return IPAddress(); }
+    String      macAddress(void)      { return String("00:00:00:00:00:00"); }
+    uint8_t    *macAddress(uint8_t *mac) { memset(mac, 0, 6); return mac; }
+    String      SSID(void)            { return String(); }
+    int32_t     RSSI(void)            { return 0; }
+    int32_t     channel(void)         { return 0; }
+    wifi_mode_t getMode(void)         { return WIFI_OFF; }
+    bool        mode(wifi_mode_t)     { return true; }
+    bool        disconnect(bool = false, bool = false) { return true; }
+    bool        softAPdisconnect(bool = false) { return true; }
+    uint8_t     softAPgetStationNum(void) { return 0; }
+    int16_t     scanComplete(void)    { return -2; }
+};
+extern WiFiClass WiFi;
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef WLED_NATIVE_WIFIUDP_H
+#define WLED_NATIVE_WIFIUDP_H
+// UDP that never receives anything
+#include "Arduino.h"
+#include "IPAddress.h"
+class WiFiUDP : public Print {
+  public:
+    uint8_t   begin(uint16_t) { return 0; }
+    uint8_t   beginMulticast(IPAddress, uint16_t) { return 0; }
+    void      stop(void) {}
+    int       beginPacket(IPAddress, uint16_t) { return 0; }
+    int       beginPacket(const char *, uint16_t) { return 0; }
+    int       beginMulticastPacket(void) { return 0; }
+    int       endPacket(void) { return 0; }
+    size_t    write(uint8_t) override { return 1; }
+    size_t    write(const uint8_t *, size_t size) override { return size; }
+    using Print::write;
+    int       parsePacket(void) { return 0; }
+    int       available(void) { return 0; }
+    int       read(void) { return -1; }
+    int       read(unsigned char *, size_t) { return 0; }
+    int       read(char *, size_t) { return 0; }
+    void      flush(void) {}
+    IPAddress remoteIP(void) { return IPAddress(); }
+    uint16_t  remotePort(void) { return 0; }
+};
+#endif
@@ -0,0 +1,6 @@
+#pragma once
+// not needed by the effect engine on host
+#include <stdint.h>
+#define LWIP_VERSION_MAJOR 2
+typedef struct { uint32_t addr; } ip4_addr_t;
+typedef ip4_addr_t ip_addr_t;
@@ -0,0 +1,17 @@
+/*
+ * WLED globals (wled.h) and the few functions of not built sources (network, web server, led.cpp) that
+ * the effect engine links against on host
+ */
+#define WLED_DEFINE_GLOBAL_VARS
+#include "wled.h"
+
+ESPAsyncE131::ESPAsyncE131(e131_packet_callback_function callback) : _callback(callback) {}
+
+void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol) {}
+void createEditHandler(bool enable) {}
+
+//utility for FastLED to use our custom timer (led.cpp)
+uint32_t get_millisecond_timer()
+{
+  return strip.now;
+}
@@ -0,0 +1,168 @@
+/*
+ * packed (SWAR) color math checked against per channel reference math, and timed against it
+ * run with: pio test -e native -f test_color_swar
+ */
+#include <unity.h>
+#include <stdio.h>
+#include <chrono>
+#include "color_swar.h"
+
+static inline uint8_t ch(uint32_t c, unsigned n) { return (c >> (8*n)) & 0xFF; }
+
+static uint32_t lcg = 12345;
+static uint32_t rnd() { lcg = lcg * 1664525UL + 1013904223UL; return lcg; }
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// every channel value and every scale, channels of one color take different values so lanes must not interfere
+void test_scale(void) {
+  for (uint32_t scale = 0; scale <= 256; scale++) for (uint32_t v = 0; v < 256; v++) {
+    uint32_t c = v | (255-v) << 8 | ((v*7) & 0xFF) << 16 | ((v*13+5) & 0xFF) << 24;
+    uint32_t r = swar_scale(c, scale);
+    for (unsigned n = 0; n < 4; n++) TEST_ASSERT_EQUAL_UINT32((ch(c,n) * scale) >> 8, ch(r,n));
+  }
+}
+
+void test_blend8(void) {
+  for (uint32_t blend = 0; blend < 256; blend++) for (uint32_t a = 0; a < 256; a++) for (uint32_t b = 0; b < 256; b += 3) {
+    uint32_t c1 = a | b << 8 | (255-a) << 16 | (255-b) << 24;
+    uint32_t c2 = b | a << 8 | (255-b) << 16 | (a^b) << 24;
+    uint32_t r = swar_blend8(c1, c2, blend);
+    for (unsigned n = 0; n < 4; n++) TEST_ASSERT_EQUAL_UINT32((ch(c2,n) * blend + ch(c1,n) * (255 - blend)) >> 8, ch(r,n));
+  }
+}
+
+void test_sum_and_saturate(void) {
+  for (uint32_t a = 0; a < 256; a++) for (uint32_t b = 0; b < 256; b++) {
+    uint32_t c1 = a | b << 8 | (a/2) << 16 | (255-b) << 24;
+    uint32_t c2 = b | a << 8 | (255-a) << 16 | (b/3) << 24;
+    uint32_t rb, wg;
+    bool overflow = swar_sum(c1, c2, rb, wg) != 0;
+    bool expected = false;
+    uint32_t r = swar_saturate(rb, wg);
+    for (unsigned n = 0; n < 4; n++) {
+      unsigned s = ch(c1,n) + ch(c2,n);
+      expected |= s > 255;
+      TEST_ASSERT_EQUAL_UINT32(s > 255 ? 255 : s, ch(r,n));
+    }
+    TEST_ASSERT_EQUAL(expected, overflow);
+    if (!overflow) TEST_ASSERT_EQUAL_HEX32(rb | (wg << 8), r);
+  }
+}
+
+void test_random_colors(void) {
+  for (unsigned i = 0; i < 1000000; i++) {
+    uint32_t c1 = rnd(), c2 = rnd(), k = rnd() & 0xFF;
+    uint32_t s = swar_scale(c1, k + 1);
+    uint32_t b = swar_blend8(c1, c2, k);
+    for (unsigned n = 0; n < 4; n++) {
+      TEST_ASSERT_EQUAL_UINT32((ch(c1,n) * (k + 1)) >> 8, ch(s,n));
+      TEST_ASSERT_EQUAL_UINT32((ch(c2,n) * k + ch(c1,n) * (255 - k)) >> 8, ch(b,n));
+    }
+  }
+}
+
+// scalar color_add() before packed math (colors.cpp)
+static uint32_t ref_color_add(uint32_t c1, uint32_t c2, bool fast) {
+  uint32_t r = ch(c1,2) + ch(c2,2), g = ch(c1,1) + ch(c2,1), b = ch(c1,0) + ch(c2,0), w = ch(c1,3) + ch(c2,3);
+  if (fast) {
+    if (r > 255) r = 255;
+    if (g > 255) g = 255;
+    if (b > 255) b = 255;
+    if (w > 255) w = 255;
+    return w << 24 | r << 16 | g << 8 | b;
+  }
+  unsigned max = r;
+  if (g > max) max = g;
+  if (b > max) max = b;
+  if (w > max) max = w;
+  if (max < 256) return w << 24 | r << 16 | g << 8 | b;
+  return (w * 255 / max) << 24 | (r * 255 / max) << 16 | (g * 255 / max) << 8 | (b * 255 / max);
+}
+
+void test_add(void) {
+  for (uint32_t a = 0; a < 256; a++) for (uint32_t b = 0; b < 256; b++) {
+    uint32_t c1 = a | b << 8 | (a/2) << 16 | (255-b) << 24;
+    uint32_t c2 = b | a << 8 | (255-a) << 16 | (b/3) << 24;
+    TEST_ASSERT_EQUAL_HEX32(ref_color_add(c1, c2, true),  swar_add(c1, c2, true));
+    TEST_ASSERT_EQUAL_HEX32(ref_color_add(c1, c2, false), swar_add(c1, c2, false));
+  }
+  for (unsigned i = 0; i < 1000000; i++) {
+    uint32_t c1 = rnd(), c2 = rnd();
+    TEST_ASSERT_EQUAL_HEX32(ref_color_add(c1, c2, true),  swar_add(c1, c2, true));
+    TEST_ASSERT_EQUAL_HEX32(ref_color_add(c1, c2, false), swar_add(c1, c2, false));
+  }
+}
+
+#define SPAN 300
+static uint32_t spanA[SPAN], spanB[SPAN], spanOut[SPAN];
+
+// add_span(): same as color_add() per pixel, also in place
+void test_add_span(void) {
+  for (unsigned fast = 0; fast < 2; fast++) {
+    for (unsigned i = 0; i < SPAN; i++) { spanA[i] = rnd(); spanB[i] = rnd() & 0x7F7F7F7F; }
+    swar_add_span(spanOut, spanA, spanB, SPAN, fast);
+    for (unsigned i = 0; i < SPAN; i++) TEST_ASSERT_EQUAL_HEX32(ref_color_add(spanA[i], spanB[i], fast), spanOut[i]);
+    swar_add_span(spanA, spanA, spanB, SPAN, fast);
+    for (unsigned i = 0; i < SPAN; i++) TEST_ASSERT_EQUAL_HEX32(spanOut[i], spanA[i]);
+  }
+}
+
+// per channel versions of color_blend()/color_fade() before packed math (colors.cpp)
+static uint32_t ref_blend8(uint32_t c1, uint32_t c2, uint32_t blend) {
+  uint32_t r = 0;
+  for (unsigned n = 0; n < 4; n++) r |= ((ch(c2,n) * blend + ch(c1,n) * (255 - blend)) >> 8) << (8*n);
+  return r;
+}
+static uint32_t ref_scale(uint32_t c, uint32_t scale) {
+  uint32_t r = 0;
+  for (unsigned n = 0; n < 4; n++) r |= ((ch(c,n) * scale) >> 8) << (8*n);
+  return r;
+}
+
+static volatile uint32_t sink;
+#define BENCH_ROUNDS 20000
+
+// ns per pixel over a strip sized span, kernels are called through pointers so neither side is inlined into the loop
+template <typename F> static double nsPerPixel(F f) {
+  auto t0 = std::chrono::steady_clock::now();
+  for (unsigned r = 0; r < BENCH_ROUNDS; r++) { f(r); sink = spanOut[r % SPAN]; }
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / (BENCH_ROUNDS * SPAN);
+}
+
+static uint32_t (*volatile addRef)(uint32_t, uint32_t, bool) = ref_color_add;
+static uint32_t (*volatile addSwar)(uint32_t, uint32_t, bool) = swar_add;
+static void (*volatile addSpan)(uint32_t*, const uint32_t*, const uint32_t*, unsigned, bool) = swar_add_span;
+static uint32_t (*volatile blendRef)(uint32_t, uint32_t, uint32_t) = ref_blend8;
+static uint32_t (*volatile blendSwar)(uint32_t, uint32_t, uint32_t) = swar_blend8;
+static uint32_t (*volatile scaleRef)(uint32_t, uint32_t) = ref_scale;
+static uint32_t (*volatile scaleSwar)(uint32_t, uint32_t) = swar_scale;
+
+void test_timing(void) {
+  for (unsigned i = 0; i < SPAN; i++) { spanA[i] = rnd(); spanB[i] = rnd(); }
+  double tAddRef  = nsPerPixel([](unsigned) { auto f = addRef;  for (unsigned i = 0; i < SPAN; i++) spanOut[i] = f(spanA[i], spanB[i], true); });
+  double tAdd     = nsPerPixel([](unsigned) { auto f = addSwar; for (unsigned i = 0; i < SPAN; i++) spanOut[i] = f(spanA[i], spanB[i], true); });
+  double tAddSpan = nsPerPixel([](unsigned) { addSpan(spanOut, spanA, spanB, SPAN, true); });
+  double tBlRef   = nsPerPixel([](unsigned r) { auto f = blendRef;  for (unsigned i = 0; i < SPAN; i++) spanOut[i] = f(spanA[i], spanB[i], r & 0xFF); });
+  double tBl      = nsPerPixel([](unsigned r) { auto f = blendSwar; for (unsigned i = 0; i < SPAN; i++) spanOut[i] = f(spanA[i], spanB[i], r & 0xFF); });
+  double tScRef   = nsPerPixel([](unsigned r) { auto f = scaleRef;  for (unsigned i = 0; i < SPAN; i++) spanOut[i] = f(spanA[i], (r & 0xFF) + 1); });
+  double tSc      = nsPerPixel([](unsigned r) { auto f = scaleSwar; for (unsigned i = 0; i < SPAN; i++) spanOut[i] = f(spanA[i], (r & 0xFF) + 1); });
+  printf("  ns/pixel: add (saturating) scalar %.2f packed %.2f span %.2f | blend scalar %.2f packed %.2f | fade scalar %.2f packed %.2f\n",
+         tAddRef, tAdd, tAddSpan, tBlRef, tBl, tScRef, tSc);
+  TEST_ASSERT_TRUE(tAddSpan < tAddRef);
+  TEST_ASSERT_TRUE(tBl < tBlRef);
+  TEST_ASSERT_TRUE(tSc < tScRef);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_scale);
+  RUN_TEST(test_blend8);
+  RUN_TEST(test_sum_and_saturate);
+  RUN_TEST(test_random_colors);
+  RUN_TEST(test_add);
+  RUN_TEST(test_add_span);
+  RUN_TEST(test_timing);
+  return UNITY_END();
+}
@@ -0,0 +1,174 @@
+/*
+ * DDP timecode queue (ddp_queue.h): frames arriving with network jitter are presented at their timecode
+ * simulates sender, network and handleDDPQueue() polled from the main loop in 1 ms steps
+ * run with: pio test -e native -f test_ddp_queue
+ */
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "ddp_queue.h"
+
+#define SLOTS 3               // DDP_QUEUE_SLOTS in e131.cpp
+#define BASE_SEC  65530       // lower 16 bits of NTP seconds wrap 6 s into the simulation
+
+// simulation time (ms) as DDP timecode
+static uint32_t timecodeAt(uint32_t ms) {
+  return ((BASE_SEC + ms / 1000) << 16) | (((ms % 1000) << 16) / 1000);
+}
+
+struct Frame {
+  uint32_t sent;     // ms
+  uint32_t due;      // ms, encoded in timecode
+  uint32_t arrival;  // ms
+  int32_t  shown;    // ms, -1 if never presented
+};
+
+#define MAX_FRAMES 2000
+static Frame frames[MAX_FRAMES];
+static unsigned frameCount;
+static unsigned order[MAX_FRAMES];  // frame indices by arrival
+static int presentedOrder[MAX_FRAMES];
+static unsigned presentedCount;
+
+// frame every interval ms, due latency ms after sending, network delay uniform in [0, jitter]
+static void generate(unsigned count, uint32_t interval, uint32_t latency, uint32_t jitter, unsigned seed) {
+  srand(seed);
+  frameCount = count;
+  for (unsigned i = 0; i < count; i++) {
+    frames[i].sent    = 1000 + i * interval;
+    frames[i].due     = frames[i].sent + latency;
+    frames[i].arrival = frames[i].sent + (jitter ? rand() % (jitter + 1) : 0);
+    frames[i].shown   = -1;
+    order[i] = i;
+  }
+  for (unsigned i = 1; i < count; i++) { // stable sort by arrival (packets may overtake each other)
+    unsigned o = order[i], j = i;
+    for (; j > 0 && frames[order[j-1]].arrival > frames[o].arrival; j--) order[j] = order[j-1];
+    order[j] = o;
+  }
+}
+
+// receiver: push on arrival, poll queue every millisecond like handleDDPQueue()
+static void run(void) {
+  DDPSchedule<SLOTS> q;
+  int slotFrame[SLOTS];
+  unsigned next = 0;
+  presentedCount = 0;
+  uint32_t end = frames[frameCount-1].due + 2000;
+  for (uint32_t now = 0; now < end; now++) {
+    while (next < frameCount && frames[order[next]].arrival == now) {
+      int dropped;
+      slotFrame[q.receiving] = order[next];
+      q.push(timecodeAt(frames[order[next]].due), timecodeAt(now), dropped);
+      next++;
+    }
+    int d = q.due(timecodeAt(now));
+    if (d >= 0) {
+      frames[slotFrame[d]].shown = now;
+      presentedOrder[presentedCount++] = slotFrame[d];
+    }
+  }
+}
+
+static void assertInOrder(void) {
+  for (unsigned i = 1; i < presentedCount; i++) TEST_ASSERT_TRUE(presentedOrder[i] > presentedOrder[i-1]);
+}
+
+// spread of intervals between consecutive presentations (ms)
+static double intervalStdDev(bool arrival) {
+  double sum = 0, sum2 = 0;
+  unsigned n = 0;
+  for (unsigned i = 1; i < frameCount; i++) {
+    double a = arrival ? frames[i].arrival : frames[i].shown;
+    double b = arrival ? frames[i-1].arrival : frames[i-1].shown;
+    sum += a - b; sum2 += (a - b) * (a - b); n++;
+  }
+  double mean = sum / n;
+  return sqrt(sum2 / n - mean * mean);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_ms_until(void) {
+  TEST_ASSERT_EQUAL_INT(0, ddpMsUntil(timecodeAt(5000), timecodeAt(5000)));
+  TEST_ASSERT_INT_WITHIN(1, 250, ddpMsUntil(timecodeAt(5250), timecodeAt(5000)));
+  TEST_ASSERT_INT_WITHIN(1, -250, ddpMsUntil(timecodeAt(5000), timecodeAt(5250)));
+  TEST_ASSERT_INT_WITHIN(1, 1500, ddpMsUntil(timecodeAt(6000), timecodeAt(4500))); // across 16 bit seconds wrap
+}
+
+// 40 fps, 45 ms latency budget (at most SLOTS-1 frames waiting), up to 40 ms jitter: every frame on time, in order
+void test_jitter_within_budget(void) {
+  generate(1000, 25, 45, 40, 1);
+  run();
+  TEST_ASSERT_EQUAL_UINT(frameCount, presentedCount);
+  assertInOrder();
+  for (unsigned i = 0; i < frameCount; i++) {
+    TEST_ASSERT_TRUE(frames[i].shown >= 0);
+    TEST_ASSERT_INT_WITHIN(1, frames[i].due, frames[i].shown);
+  }
+  double in = intervalStdDev(true), out = intervalStdDev(false);
+  printf("interval stddev: arrival %.2f ms, presented %.2f ms\n", in, out);
+  TEST_ASSERT_TRUE(out < 1.0); // 1 ms polling and timecode rounding
+  TEST_ASSERT_TRUE(in > 10 * out);
+}
+
+// jitter beyond budget: late frames are shown on arrival, never out of order, never before their timecode
+void test_jitter_exceeds_budget(void) {
+  generate(1000, 25, 40, 120, 2);
+  run();
+  assertInOrder();
+  unsigned late = 0;
+  for (unsigned i = 0; i < frameCount; i++) {
+    if (frames[i].shown < 0) continue;
+    TEST_ASSERT_TRUE(uint32_t(frames[i].shown) + 1 >= frames[i].due);
+    if (frames[i].arrival > frames[i].due) { late++; TEST_ASSERT_EQUAL_INT(frames[i].arrival, frames[i].shown); }
+  }
+  TEST_ASSERT_TRUE(late > 0);
+}
+
+// more frames waiting than slots: those due first are dropped, the rest still on time
+void test_queue_full(void) {
+  frameCount = 5;
+  for (unsigned i = 0; i < frameCount; i++) {
+    frames[i].sent = frames[i].arrival = 1000 + i;
+    frames[i].due = 1200 + i * 10;
+    frames[i].shown = -1;
+    order[i] = i;
+  }
+  run();
+  TEST_ASSERT_EQUAL_UINT(SLOTS - 1, presentedCount);
+  for (unsigned i = 0; i < frameCount - (SLOTS - 1); i++) TEST_ASSERT_EQUAL_INT(-1, frames[i].shown);
+  for (unsigned i = frameCount - (SLOTS - 1); i < frameCount; i++) TEST_ASSERT_INT_WITHIN(1, frames[i].due, frames[i].shown);
+}
+
+// timecodes too far ahead (unsynchronized sender) are presented at once
+void test_far_timecode(void) {
+  generate(10, 25, 5000, 0, 3);
+  run();
+  for (unsigned i = 0; i < frameCount; i++) TEST_ASSERT_EQUAL_INT(frames[i].arrival, frames[i].shown);
+}
+
+// sender restart with timecodes far in the past is not mistaken for reordering
+void test_sender_restart(void) {
+  DDPSchedule<SLOTS> q;
+  int dropped;
+  q.push(timecodeAt(10000), timecodeAt(10000), dropped);
+  TEST_ASSERT_TRUE(q.due(timecodeAt(10000)) >= 0);
+  q.push(timecodeAt(9990), timecodeAt(10001), dropped); // overtaken frame
+  TEST_ASSERT_EQUAL_INT(-1, q.due(timecodeAt(10001)));
+  q.push(timecodeAt(2000), timecodeAt(10002), dropped); // restarted sender
+  TEST_ASSERT_TRUE(q.due(timecodeAt(10002)) >= 0);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_ms_until);
+  RUN_TEST(test_jitter_within_budget);
+  RUN_TEST(test_jitter_exceeds_budget);
+  RUN_TEST(test_queue_full);
+  RUN_TEST(test_far_timecode);
+  RUN_TEST(test_sender_restart);
+  return UNITY_END();
+}
@@ -0,0 +1,76 @@
+/*
+ * FrameHandoff (triple buffer between render task and output) with producer and consumer on separate threads
+ * run with: pio test -e native -f test_frame_handoff
+ */
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <atomic>
+#include "frame_handoff.h"
+
+#define FRAME_LEN 256
+
+static uint32_t buffers[3][FRAME_LEN];
+
+void setUp(void) { memset(buffers, 0, sizeof(buffers)); }
+void tearDown(void) {}
+
+static void fill(uint32_t *frame, uint32_t n) { for (unsigned i = 0; i < FRAME_LEN; i++) frame[i] = n; }
+
+void test_single_thread(void) {
+  FrameHandoff<uint32_t> h(buffers[0], buffers[1], buffers[2]);
+  TEST_ASSERT_FALSE(h.acquire()); // nothing published yet
+  fill(h.back(), 1);
+  uint32_t *next = h.publish();
+  TEST_ASSERT_TRUE(next != h.front());
+  TEST_ASSERT_TRUE(h.acquire());
+  TEST_ASSERT_EQUAL_UINT32(1, h.front()[0]);
+  TEST_ASSERT_FALSE(h.acquire()); // same frame is not handed out twice
+  // consumer that falls behind only gets newest frame
+  fill(h.back(), 2); h.publish();
+  fill(h.back(), 3); h.publish();
+  TEST_ASSERT_TRUE(h.acquire());
+  TEST_ASSERT_EQUAL_UINT32(3, h.front()[0]);
+  TEST_ASSERT_FALSE(h.acquire());
+  // producer never writes into the frame consumer holds
+  for (unsigned i = 0; i < 10; i++) { TEST_ASSERT_TRUE(h.back() != h.front()); h.publish(); }
+}
+
+// consumer must only ever see complete frames, in order, and eventually the last one
+void test_threads(void) {
+  FrameHandoff<uint32_t> h(buffers[0], buffers[1], buffers[2]);
+  const uint32_t frames = 200000;
+  std::atomic<bool> done(false);
+  std::thread producer([&]() {
+    for (uint32_t n = 1; n <= frames; n++) {
+      fill(h.back(), n);
+      h.publish();
+    }
+    done = true;
+  });
+  uint32_t last = 0, received = 0, torn = 0, outOfOrder = 0;
+  for (;;) {
+    bool finished = done;
+    if (h.acquire()) {
+      const uint32_t *f = h.front();
+      uint32_t n = f[0];
+      for (unsigned i = 1; i < FRAME_LEN; i++) if (f[i] != n) { torn++; break; }
+      if (n <= last) outOfOrder++;
+      last = n;
+      received++;
+    } else if (finished) break;
+  }
+  producer.join();
+  printf("  %u of %u frames received\n", (unsigned)received, (unsigned)frames);
+  TEST_ASSERT_EQUAL_UINT32(0, torn);
+  TEST_ASSERT_EQUAL_UINT32(0, outOfOrder);
+  TEST_ASSERT_EQUAL_UINT32(frames, last);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_single_thread);
+  RUN_TEST(test_threads);
+  return UNITY_END();
+}
@@ -0,0 +1,90 @@
+/*
+ * Headless effect benchmark on host (FX_bench.cpp): every effect is rendered into a BusCapture sink on a
+ * 300 and 1024 LED strip and a 64x64 and 128x128 matrix, prints us/frame, allocateData() calls and bytes per effect
+ * effect engine (FX*.cpp, colors.cpp) is built against the Arduino/FastLED shims in test/native
+ *
+ * run with: pio test -e native_fx -v
+ * frames per effect can be set with WLED_BENCH_FRAMES (default 50)
+ */
+#include <unity.h>
+#include "wled.h"
+
+static unsigned frames = 50;
+
+// runs the benchmark to completion like loop() would and prints the results, every effect (but RSVD) must have run
+static void runBenchmark(uint16_t w, uint16_t h) {
+  TEST_ASSERT_TRUE(strip.startBenchmark(w, h, frames));
+  while (strip.isBenchmarking()) strip.handleBenchmark();
+
+  uint16_t rw, rh, rn;
+  const std::vector<WS2812FX::bench_result_t> &results = strip.getBenchmarkResults(rw, rh, rn);
+  TEST_ASSERT_EQUAL_UINT(w, rw);
+  TEST_ASSERT_EQUAL_UINT(h, rh);
+  TEST_ASSERT_EQUAL_UINT(strip.getModeCount(), results.size());
+
+  printf("\n%ux%u, %u frames\n", (unsigned)w, (unsigned)h, (unsigned)rn);
+  printf(" id  %-24s %8s %8s %7s %7s %8s\n", "effect", "us/frame", "us max", "data B", "allocs", "alloc B");
+  unsigned effects = 0, failed = 0;
+  uint32_t total = 0;
+  for (size_t i = 0; i < results.size(); i++) {
+    char name[25];
+    const char *md = strip.getModeData(i);
+    size_t n = strcspn(md, "@");
+    if (n > sizeof(name) - 1) n = sizeof(name) - 1;
+    memcpy(name, md, n);
+    name[n] = 0;
+    if (strncmp(name, "RSVD", 4) == 0) continue;
+    const WS2812FX::bench_result_t &r = results[i];
+    printf("%3u  %-24s %8u %8u %7u %7u %8u%s\n", (unsigned)i, name, (unsigned)r.usAvg, (unsigned)r.usMax,
+           (unsigned)r.dataBytes, (unsigned)r.allocs, (unsigned)r.allocBytes, r.failed ? "  out of effect RAM" : "");
+    effects++;
+    total += r.usAvg;
+    if (r.failed) failed++;
+  }
+  printf("%u effects, %u us/frame in total, %u ran out of effect RAM\n", effects, (unsigned)total, failed);
+  static const char *prims[BENCH_PRIMITIVES] = {"fill", "fadeToBlackBy", "fade_out", "blur"};
+  for (unsigned p = 0; p < BENCH_PRIMITIVES; p++) {
+    printf("     %-24s %8u us strip pixels, %u us render buffer\n", prims[p],
+           (unsigned)strip.getBenchmarkPrimitive(p, false), (unsigned)strip.getBenchmarkPrimitive(p, true));
+  }
+  TEST_ASSERT_TRUE(effects > 100);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_strip_300(void)  { runBenchmark(300, 1); }
+void test_strip_1024(void) { runBenchmark(1024, 1); }
+void test_matrix_64(void)  { runBenchmark(64, 64); }
+void test_matrix_128(void) { runBenchmark(128, 128); }
+
+// every effect that allocates data does so through allocateData(), which the benchmark counts
+void test_allocs_counted(void) {
+  TEST_ASSERT_TRUE(strip.startBenchmark(32, 1, 2));
+  while (strip.isBenchmarking()) strip.handleBenchmark();
+  uint16_t w, h, n;
+  const std::vector<WS2812FX::bench_result_t> &results = strip.getBenchmarkResults(w, h, n);
+  for (size_t i = 0; i < results.size(); i++) {
+    if (results[i].dataBytes) {
+      TEST_ASSERT_TRUE(results[i].allocs > 0);
+      TEST_ASSERT_TRUE(results[i].allocBytes >= results[i].dataBytes);
+    }
+    if (!results[i].allocs) TEST_ASSERT_EQUAL_UINT32(0, results[i].allocBytes);
+  }
+  // the benchmark restores the strip and can be started again
+  TEST_ASSERT_FALSE(strip.isBenchmarking());
+  TEST_ASSERT_TRUE(strip.startBenchmark(8, 1, 1));
+  while (strip.isBenchmarking()) strip.handleBenchmark();
+}
+
+int main(void) {
+  const char *f = getenv("WLED_BENCH_FRAMES");
+  if (f && atoi(f) > 0) frames = atoi(f);
+  UNITY_BEGIN();
+  RUN_TEST(test_allocs_counted);
+  RUN_TEST(test_strip_300);
+  RUN_TEST(test_strip_1024);
+  RUN_TEST(test_matrix_64);
+  RUN_TEST(test_matrix_128);
+  return UNITY_END();
+}
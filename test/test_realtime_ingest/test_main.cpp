@@ -0,0 +1,234 @@
+/*
+ * realtime ingest (realtime_ingest.h): replays DDP traffic from a pcap capture through ingestRealtimeRun()
+ * (what setRealtimePixels() runs) and through the per-pixel path of setRealtimePixel(), both into a capture
+ * sink with the semantics of BusCapture, checks both give the same strip content and times them
+ *
+ * run with: pio test -e native -f test_realtime_ingest
+ * a synthetic capture (64x64 matrix, 10 frames) is generated unless WLED_PCAP names a capture file
+ * (Ethernet, IPv4, DDP on UDP port 4048), i.e. WLED_PCAP=ddp.pcap pio test -e native -f test_realtime_ingest
+ */
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "realtime_ingest.h"
+
+#define DDP_PORT        4048
+#define DDP_HEADER_LEN  10
+#define STRIP_LEN       4096
+
+static std::vector<uint8_t> capture;
+static uint8_t  gammaT[256];
+
+// strip output as BusCapture (bus_manager.cpp) receives it, counts calls
+struct CaptureSink {
+  uint32_t data[STRIP_LEN];
+  unsigned calls;
+  void setPixelColor(unsigned pix, uint32_t c) {
+    calls++;
+    if (pix < STRIP_LEN) data[pix] = c;
+  }
+  void setPixelRange(unsigned pix, unsigned len, const uint32_t *c) {
+    calls++;
+    if (pix >= STRIP_LEN) return;
+    if (pix + len > STRIP_LEN) len = STRIP_LEN - pix;
+    memcpy(data + pix, c, len * sizeof(uint32_t));
+  }
+};
+static CaptureSink stripBulk, stripPixel;
+
+struct DdpPacket { const uint8_t *data; unsigned start, count; }; // start and count in LEDs (RGB)
+
+/*
+ * pcap
+ */
+static void put(std::vector<uint8_t> &v, const void *p, size_t n) { v.insert(v.end(), (const uint8_t*)p, (const uint8_t*)p + n); }
+static void putBE16(std::vector<uint8_t> &v, uint16_t x) { uint8_t b[2] = {uint8_t(x >> 8), uint8_t(x)}; put(v, b, 2); }
+static void putBE32(std::vector<uint8_t> &v, uint32_t x) { putBE16(v, x >> 16); putBE16(v, x); }
+
+// frames of a width x height matrix, each frame split into DDP packets of at most 480 LEDs (1440 bytes)
+static void generateCapture(unsigned width, unsigned height, unsigned frames) {
+  const uint32_t hdr[] = {0xA1B2C3D4, 0x00040002, 0, 0, 65535, 1}; // magic, version 2.4, tz, sigfigs, snaplen, Ethernet
+  put(capture, hdr, sizeof(hdr));
+  const unsigned leds = width * height;
+  uint32_t usec = 0;
+  for (unsigned f = 0; f < frames; f++) for (unsigned first = 0; first < leds; first += 480) {
+    unsigned n = leds - first < 480 ? leds - first : 480;
+    std::vector<uint8_t> pkt;
+    const uint8_t eth[14] = {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF, 0x02,0,0,0,0,1, 0x08,0x00};
+    put(pkt, eth, sizeof(eth));
+    const unsigned udpLen = 8 + DDP_HEADER_LEN + n * 3;
+    const uint8_t ip[20] = {0x45,0, uint8_t((20 + udpLen) >> 8), uint8_t(20 + udpLen), 0,0, 0,0, 64, 17, 0,0, 192,168,1,2, 192,168,1,255};
+    put(pkt, ip, sizeof(ip));
+    putBE16(pkt, 50000); putBE16(pkt, DDP_PORT); putBE16(pkt, udpLen); putBE16(pkt, 0);
+    const bool last = first + n >= leds;
+    const uint8_t ddp[4] = {uint8_t(0x40 | (last ? 0x01 : 0)), uint8_t(f & 0x0F), 0x0B, 1}; // v1, push on last packet, RGB 8 bit
+    put(pkt, ddp, sizeof(ddp));
+    putBE32(pkt, first * 3); putBE16(pkt, n * 3);
+    for (unsigned i = first; i < first + n; i++) {
+      unsigned x = i % width, y = i / width;
+      const uint8_t rgb[3] = {uint8_t(x * 4 + f), uint8_t(y * 4), uint8_t((x ^ y) + f * 16)};
+      put(pkt, rgb, 3);
+    }
+    const uint32_t rec[4] = {0, usec, (uint32_t)pkt.size(), (uint32_t)pkt.size()};
+    put(capture, rec, sizeof(rec));
+    put(capture, pkt.data(), pkt.size());
+    usec += 500;
+  }
+}
+
+static bool loadCapture(const char *path) {
+  FILE *f = fopen(path, "rb");
+  if (!f) return false;
+  uint8_t buf[65536];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) put(capture, buf, n);
+  fclose(f);
+  return true;
+}
+
+static uint32_t word(size_t pos) { uint32_t w; memcpy(&w, capture.data() + pos, 4); return w; } // host byte order
+
+// DDP RGB payloads of an Ethernet capture (written on a host with the same byte order)
+static std::vector<DdpPacket> ddpPackets() {
+  std::vector<DdpPacket> out;
+  if (capture.size() < 24 || word(0) != 0xA1B2C3D4 || word(20) != 1) return out;
+  for (size_t pos = 24; pos + 16 <= capture.size(); ) {
+    const uint32_t len = word(pos + 8);
+    const uint8_t *p = capture.data() + pos + 16;
+    pos += 16 + len;
+    if (pos > capture.size() || len < 14 + 20 + 8 + DDP_HEADER_LEN) break;
+    if (p[12] != 0x08 || p[13] != 0x00) continue;         // IPv4
+    const uint8_t *ip = p + 14;
+    if (ip[9] != 17) continue;                            // UDP
+    const uint8_t *udp = ip + (ip[0] & 0x0F) * 4;
+    if ((udp[2] << 8 | udp[3]) != DDP_PORT) continue;
+    const uint8_t *ddp = udp + 8;
+    if ((ddp[0] & 0xC0) != 0x40 || (ddp[0] & 0x10)) continue; // version 1 without timecode
+    const unsigned offset = ddp[4] << 24 | ddp[5] << 16 | ddp[6] << 8 | ddp[7];
+    const unsigned dlen   = ddp[8] << 8 | ddp[9];
+    if (ddp + DDP_HEADER_LEN + dlen > p + len) continue;
+    out.push_back({ddp + DDP_HEADER_LEN, offset / 3, dlen / 3});
+  }
+  return out;
+}
+
+/*
+ * both ingest paths
+ */
+// setRealtimePixels(): clip once, convert in chunks, write runs (strip.setPixelRange())
+static void ingestBulk(CaptureSink &strip, unsigned total, const DdpPacket &pkt, int offset, bool gamma) {
+  auto sink = [&strip](unsigned pix, unsigned n, const uint32_t *c) { strip.setPixelRange(pix, n, c); };
+  if (gamma) ingestRealtimeRun(int(pkt.start) + offset, pkt.count, pkt.data, 3, total, [](uint8_t v) { return gammaT[v]; }, sink);
+  else       ingestRealtimeRun(int(pkt.start) + offset, pkt.count, pkt.data, 3, total, [](uint8_t v) { return v; }, sink);
+}
+
+// setRealtimePixel() for every LED
+static void ingestPixel(CaptureSink &strip, unsigned total, const DdpPacket &pkt, int offset, bool gamma) {
+  const uint8_t *data = pkt.data;
+  for (unsigned i = pkt.start; i < pkt.start + pkt.count; i++, data += 3) {
+    unsigned pix = i + offset;
+    if (pix >= total) continue;
+    uint8_t r = data[0], g = data[1], b = data[2], w = 0;
+    if (gamma) { r = gammaT[r]; g = gammaT[g]; b = gammaT[b]; w = gammaT[w]; }
+    strip.setPixelColor(pix, uint32_t(w) << 24 | uint32_t(r) << 16 | uint32_t(g) << 8 | b);
+  }
+}
+
+void setUp(void) {
+  memset(&stripBulk, 0, sizeof(stripBulk));
+  memset(&stripPixel, 0, sizeof(stripPixel));
+}
+void tearDown(void) {}
+
+void test_clip(void) {
+  unsigned skip;
+  TEST_ASSERT_EQUAL_UINT(100, clipRealtimeRun(0, 100, 300, skip));   TEST_ASSERT_EQUAL_UINT(0, skip);
+  TEST_ASSERT_EQUAL_UINT(90,  clipRealtimeRun(-10, 100, 300, skip)); TEST_ASSERT_EQUAL_UINT(10, skip); // leading LEDs dropped, not whole packet
+  TEST_ASSERT_EQUAL_UINT(0,   clipRealtimeRun(-255, 100, 300, skip));
+  TEST_ASSERT_EQUAL_UINT(50,  clipRealtimeRun(250, 100, 300, skip));
+  TEST_ASSERT_EQUAL_UINT(0,   clipRealtimeRun(300, 100, 300, skip));
+  TEST_ASSERT_EQUAL_UINT(300, clipRealtimeRun(-100, 500, 300, skip)); TEST_ASSERT_EQUAL_UINT(100, skip);
+}
+
+void test_pack_rgbw(void) {
+  const uint8_t data[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  uint32_t out[2];
+  packRealtimePixels(out, data, 2, 4, [](uint8_t v) { return v; });
+  TEST_ASSERT_EQUAL_HEX32(0x04010203, out[0]);
+  TEST_ASSERT_EQUAL_HEX32(0x08050607, out[1]);
+  packRealtimePixels(out, data, 2, 3, [](uint8_t v) { return uint8_t(v + 1); });
+  TEST_ASSERT_EQUAL_HEX32(0x01020304, out[0]); // gamma is applied to missing white channel as well (same as setRealtimePixel())
+}
+
+// every packet of the capture gives the same strip content on both paths, for all offsets allowed in settings
+void test_replay_matches_per_pixel(void) {
+  std::vector<DdpPacket> packets = ddpPackets();
+  TEST_ASSERT_TRUE(packets.size() > 0);
+  const int offsets[] = {-255, -1, 0, 1, 255};
+  for (int offset : offsets) for (int gamma = 0; gamma < 2; gamma++) {
+    setUp();
+    for (const DdpPacket &pkt : packets) {
+      ingestBulk(stripBulk, STRIP_LEN, pkt, offset, gamma);
+      ingestPixel(stripPixel, STRIP_LEN, pkt, offset, gamma);
+    }
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(stripPixel.data, stripBulk.data, STRIP_LEN);
+  }
+}
+
+// runs are cut at REALTIME_CHUNK_LEDS and at the end of the strip, never per LED
+void test_sink_runs(void) {
+  std::vector<uint8_t> data(300 * 4);
+  for (size_t i = 0; i < data.size(); i++) data[i] = uint8_t(i);
+  DdpPacket pkt = {data.data(), 0, 300};
+  ingestBulk(stripBulk, STRIP_LEN, pkt, 0, false);
+  TEST_ASSERT_EQUAL_UINT((300 + REALTIME_CHUNK_LEDS - 1) / REALTIME_CHUNK_LEDS, stripBulk.calls);
+  setUp();
+  ingestBulk(stripBulk, 100, pkt, -10, false); // 10 LEDs dropped in front, 190 behind strip end
+  TEST_ASSERT_EQUAL_UINT((100 + REALTIME_CHUNK_LEDS - 1) / REALTIME_CHUNK_LEDS, stripBulk.calls);
+  TEST_ASSERT_EQUAL_HEX32(0x001E1F20, stripBulk.data[0]); // LED 10 (RGB, bytes 30..32)
+  TEST_ASSERT_EQUAL_HEX32(0, stripBulk.data[100]);
+}
+
+void test_replay_benchmark(void) {
+  std::vector<DdpPacket> packets = ddpPackets();
+  unsigned frames = 0, leds = 0;
+  for (const DdpPacket &pkt : packets) { leds += pkt.count; if (pkt.start == 0) frames++; }
+  if (!frames) frames = 1;
+  const unsigned rounds = 200;
+  double us[2];
+  unsigned calls[2];
+  for (int path = 0; path < 2; path++) {
+    CaptureSink &sink = path ? stripPixel : stripBulk;
+    sink.calls = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (unsigned r = 0; r < rounds; r++) for (const DdpPacket &pkt : packets) {
+      if (path) ingestPixel(sink, STRIP_LEN, pkt, 0, true);
+      else      ingestBulk(sink, STRIP_LEN, pkt, 0, true);
+    }
+    us[path] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / (rounds * frames);
+    calls[path] = sink.calls / (rounds * frames);
+  }
+  const double ledsPerFrame = double(leds) / frames;
+  printf("  %u packets, %u frames, %.0f LEDs per frame\n", (unsigned)packets.size(), frames, ledsPerFrame);
+  printf("  bulk:      %8.1f us/frame %7.1f ns/LED %5u sink calls/frame\n", us[0], us[0] * 1000 / ledsPerFrame, calls[0]);
+  printf("  per pixel: %8.1f us/frame %7.1f ns/LED %5u sink calls/frame (%.1fx)\n", us[1], us[1] * 1000 / ledsPerFrame, calls[1], us[1] / us[0]);
+  TEST_ASSERT_EQUAL_UINT32_ARRAY(stripPixel.data, stripBulk.data, STRIP_LEN);
+  TEST_ASSERT_TRUE(calls[0] * REALTIME_CHUNK_LEDS / 2 < calls[1]);
+}
+
+int main(void) {
+  for (unsigned i = 0; i < 256; i++) gammaT[i] = (uint8_t)(powf(i / 255.0f, 2.8f) * 255.0f + 0.5f);
+  const char *path = getenv("WLED_PCAP");
+  if (!path || !loadCapture(path)) generateCapture(64, 64, 10);
+  UNITY_BEGIN();
+  RUN_TEST(test_clip);
+  RUN_TEST(test_pack_rgbw);
+  RUN_TEST(test_replay_matches_per_pixel);
+  RUN_TEST(test_sink_runs);
+  RUN_TEST(test_replay_benchmark);
+  return UNITY_END();
+}
@@ -0,0 +1,167 @@
+/*
+ * Solid segment skipping (static_sig.h): unchanged segments are skipped, anything that changes
+ * output or overwrites LEDs (realtime, bus re-init) makes them repaint
+ * uses the same signature inputs and skip decision as Segment::staticSignature() and WS2812FX::renderSegments()
+ * run with: pio test -e native -f test_static_sig
+ */
+#include <unity.h>
+#include "static_sig.h"
+
+// what WS2812FX::renderSegments() keeps per Solid segment
+struct SolidSegment {
+  static_sig_input_t in;
+  bool     frozen;
+  bool     inTransition;
+  bool     hasBuffer;
+  bool     overlapped;  // other active segment overlaps it
+  unsigned call;
+  uint32_t rendered;    // signature of last rendered state
+  unsigned paints;
+};
+
+static uint32_t epoch;             // WS2812FX::_repaintEpoch
+static bool realtime;              // realtimeMode != REALTIME_MODE_INACTIVE
+static bool useSegmentBuffer;
+
+// segment part of one renderSegments() pass, returns true if segment was repainted
+static bool service(SolidSegment &seg) {
+  bool unchanged = false;
+  uint32_t sig = 0;
+  if (staticSkipEnabled(realtime, false, false, 0) && staticSkipCandidate(true, seg.frozen, seg.inTransition)) {
+    sig = staticSignature(seg.in, epoch);
+    unchanged = staticState(seg.rendered, sig, seg.call > 0, useSegmentBuffer, seg.hasBuffer, seg.overlapped) == STATIC_UNCHANGED;
+  }
+  if (unchanged) return false;
+  seg.paints++;
+  seg.call++;
+  seg.rendered = sig;
+  return true;
+}
+
+static void repaintUnchanged() { epoch++; }
+
+static SolidSegment seg;
+
+void setUp(void) {
+  epoch = 0;
+  realtime = false;
+  useSegmentBuffer = false;
+  seg = SolidSegment();
+  seg.in.color = 0xFF8000;
+  seg.in.opacity = 255;
+  seg.in.options = 0x04;
+  seg.in.stop = 300;
+  seg.in.stopY = 1;
+  seg.in.grouping = 1;
+  seg.in.gammaCorrectCol = true;
+}
+void tearDown(void) {}
+
+void test_unchanged_is_skipped(void) {
+  TEST_ASSERT_TRUE(service(seg));  // first frame always renders
+  for (unsigned i = 0; i < 10; i++) TEST_ASSERT_FALSE(service(seg));
+  TEST_ASSERT_EQUAL_UINT(1, seg.paints);
+}
+
+// every input of the signature repaints the segment
+void test_change_repaints(void) {
+  service(seg);
+  void (*changes[])(static_sig_input_t&) = {
+    [](static_sig_input_t &in) { in.color ^= 0x10; },
+    [](static_sig_input_t &in) { in.mode++; },
+    [](static_sig_input_t &in) { in.opacity--; },
+    [](static_sig_input_t &in) { in.cct++; },
+    [](static_sig_input_t &in) { in.options ^= 0x02; },       // mirror
+    [](static_sig_input_t &in) { in.start++; },
+    [](static_sig_input_t &in) { in.stop--; },
+    [](static_sig_input_t &in) { in.startY++; },
+    [](static_sig_input_t &in) { in.stopY++; },
+    [](static_sig_input_t &in) { in.grouping++; },
+    [](static_sig_input_t &in) { in.spacing++; },
+    [](static_sig_input_t &in) { in.offset++; },
+    [](static_sig_input_t &in) { in.gammaCorrectCol = !in.gammaCorrectCol; },
+    [](static_sig_input_t &in) { in.cctFromRgb = !in.cctFromRgb; },
+    [](static_sig_input_t &in) { in.correctWB = !in.correctWB; },
+    [](static_sig_input_t &in) { in.cctBlending++; },
+  };
+  for (auto change : changes) {
+    change(seg.in);
+    TEST_ASSERT_TRUE(service(seg));
+    TEST_ASSERT_FALSE(service(seg));
+  }
+}
+
+// realtime data overwrote LEDs while service() did not run, exitRealtime() calls repaintUnchanged()
+void test_repaint_after_realtime_timeout(void) {
+  service(seg);
+  TEST_ASSERT_FALSE(service(seg));
+  realtime = true;     // segments are rendered (realtime may be limited to main segment)
+  TEST_ASSERT_TRUE(service(seg));
+  realtime = false;
+  repaintUnchanged();  // realtime timeout
+  TEST_ASSERT_TRUE(service(seg));
+  TEST_ASSERT_FALSE(service(seg)); // only once
+  TEST_ASSERT_EQUAL_UINT(3, seg.paints);
+}
+
+// finalizeInit() re-creates buses (blank), segments copied in the meantime start with rendered = 0
+void test_repaint_after_bus_reinit(void) {
+  service(seg);
+  repaintUnchanged();
+  TEST_ASSERT_TRUE(service(seg));
+  SolidSegment copy = seg;
+  copy.rendered = 0;
+  TEST_ASSERT_TRUE(service(copy));
+}
+
+// frozen and transitioning segments always render
+void test_frozen_and_transition_render(void) {
+  service(seg);
+  seg.frozen = true;
+  TEST_ASSERT_TRUE(service(seg));
+  seg.frozen = false;
+  seg.inTransition = true;
+  TEST_ASSERT_TRUE(service(seg));
+}
+
+// without segment buffer an overlapped segment must repaint (other segment may have drawn over it)
+void test_overlap_and_buffer(void) {
+  service(seg);
+  seg.overlapped = true;
+  TEST_ASSERT_TRUE(service(seg));
+  TEST_ASSERT_EQUAL_INT(STATIC_DUE, staticState(seg.rendered, staticSignature(seg.in, epoch), true, false, false, true));
+  useSegmentBuffer = true;  // buffer holds last frame, overlap does not matter
+  seg.hasBuffer = true;
+  TEST_ASSERT_FALSE(service(seg));
+  seg.hasBuffer = false;    // buffer was freed
+  TEST_ASSERT_TRUE(service(seg));
+}
+
+void test_options_and_epoch(void) {
+  // Segment::staticSignature() passes options without SELECTED, every remaining bit counts; epoch is part of the hash
+  static_sig_input_t a = seg.in, b = seg.in;
+  b.options ^= 0x01;
+  TEST_ASSERT_TRUE(staticSignature(a, 0) != staticSignature(b, 0));
+  TEST_ASSERT_EQUAL_UINT32(staticSignature(a, 7), staticSignature(a, 7));
+  TEST_ASSERT_TRUE(staticSignature(a, 7) != staticSignature(a, 8));
+}
+
+void test_signature_never_zero(void) {
+  uint32_t v = 0;
+  for (uint32_t e = 0; e < 100000; e++) TEST_ASSERT_TRUE(staticSignatureHash(&v, 1, e) != 0);
+  TEST_ASSERT_FALSE(staticSignatureMatches(0, 0));
+  TEST_ASSERT_EQUAL_INT(STATIC_CHANGED, staticState(0, 0, true, true, true, false));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_unchanged_is_skipped);
+  RUN_TEST(test_change_repaints);
+  RUN_TEST(test_repaint_after_realtime_timeout);
+  RUN_TEST(test_repaint_after_bus_reinit);
+  RUN_TEST(test_frozen_and_transition_render);
+  RUN_TEST(test_overlap_and_buffer);
+  RUN_TEST(test_options_and_epoch);
+  RUN_TEST(test_signature_never_zero);
+  return UNITY_END();
+}
@@ -0,0 +1,8 @@
+// same lookup built with the reduced table (-D WLED_TRIG_LUT_BITS=6)
+#define WLED_TRIG_LUT_BITS 6
+#include "trig_lut.h"
+
+float lutSin6(float x) { return lutSin(x); }
+float lutCos6(float x) { return lutCos(x); }
+int16_t  lutSin16_6(uint16_t a) { return lutSin16(a); }
+uint16_t lutAtan2_16_6(int32_t y, int32_t x) { return lutAtan2_16(y, x); }
@@ -0,0 +1,160 @@
+/*
+ * accuracy and speed of table driven sin/cos/tan and fixed point sin16/cos16/atan2_16 (trig_lut.h) against libm
+ * run with: pio test -e native -f test_trig_lut
+ */
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <chrono>
+#include "trig_lut.h"
+
+float lutSin6(float x);
+float lutCos6(float x);
+int16_t  lutSin16_6(uint16_t a);
+uint16_t lutAtan2_16_6(int32_t y, int32_t x);
+
+static const double TWO_PI_D = 6.28318530717958647692;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// max absolute error over n samples within [from, to)
+static double maxError(float (*f)(float), double (*ref)(double), double from, double to, unsigned n) {
+  double err = 0;
+  for (unsigned i = 0; i < n; i++) {
+    float x = from + (to - from) * i / n;
+    double e = fabs(f(x) - ref(x));
+    if (e > err) err = e;
+  }
+  return err;
+}
+
+void test_sin_cos_8bit(void) {
+  double es = maxError(lutSin, sin, -2*TWO_PI_D, 2*TWO_PI_D, 1000003);
+  double ec = maxError(lutCos, cos, -2*TWO_PI_D, 2*TWO_PI_D, 1000003);
+  printf("  8 bit table: sin %.2e cos %.2e\n", es, ec);
+  TEST_ASSERT_TRUE(es < 6e-5); // better than Taylor series cos_t() (1e-4)
+  TEST_ASSERT_TRUE(ec < 6e-5);
+}
+
+void test_sin_cos_6bit(void) {
+  double es = maxError(lutSin6, sin, -2*TWO_PI_D, 2*TWO_PI_D, 1000003);
+  double ec = maxError(lutCos6, cos, -2*TWO_PI_D, 2*TWO_PI_D, 1000003);
+  printf("  6 bit table: sin %.2e cos %.2e\n", es, ec);
+  TEST_ASSERT_TRUE(es < 2e-4);
+  TEST_ASSERT_TRUE(ec < 2e-4);
+}
+
+void test_tan(void) {
+  double err = 0;
+  for (unsigned i = 0; i < 100000; i++) {
+    float x = -1.4f + 2.8f * i / 100000; // away from poles
+    double e = fabs(lutTan(x) - tan(x)) / (1.0 + fabs(tan(x)));
+    if (e > err) err = e;
+  }
+  printf("  tan (relative) %.2e\n", err);
+  TEST_ASSERT_TRUE(err < 2e-4);
+}
+
+// quadrant boundaries must hit table end points exactly and mirror without error
+void test_quadrants(void) {
+  TEST_ASSERT_EQUAL_INT(0,      sinLookup(0, 14));
+  TEST_ASSERT_EQUAL_INT(32767,  sinLookup(0x4000, 14));
+  TEST_ASSERT_EQUAL_INT(0,      sinLookup(0x8000, 14));
+  TEST_ASSERT_EQUAL_INT(-32767, sinLookup(0xC000, 14));
+  for (uint32_t a = 0; a < 0x4000; a += 7) {
+    int32_t v = sinLookup(a, 14);
+    TEST_ASSERT_EQUAL_INT(v,  sinLookup(0x8000 - a, 14)); // sin(PI - x) = sin(x)
+    TEST_ASSERT_EQUAL_INT(-v, sinLookup(0x8000 + a, 14)); // sin(PI + x) = -sin(x)
+  }
+  TEST_ASSERT_EQUAL_INT(0, lutTan(0));
+}
+
+// sin16_t()/cos16_t(): Q15 result for 1/65536 turn angles
+static double maxError16(int16_t (*f)(uint16_t), double phase) {
+  double err = 0;
+  for (uint32_t a = 0; a < 0x10000; a++) {
+    double e = fabs(f(a) / 32767.0 - sin(a * TWO_PI_D / 65536 + phase));
+    if (e > err) err = e;
+  }
+  return err;
+}
+
+void test_sin16_cos16(void) {
+  double es = maxError16(lutSin16, 0), ec = maxError16(lutCos16, TWO_PI_D / 4), es6 = maxError16(lutSin16_6, 0);
+  printf("  sin16 %.2e cos16 %.2e (6 bit sin16 %.2e)\n", es, ec, es6);
+  TEST_ASSERT_TRUE(es < 6e-5);
+  TEST_ASSERT_TRUE(ec < 6e-5);
+  TEST_ASSERT_TRUE(es6 < 2e-4);
+  TEST_ASSERT_EQUAL_INT(32767, lutCos16(0));
+  TEST_ASSERT_EQUAL_INT(-32767, lutCos16(0x8000));
+}
+
+// atan2_16_t(): error in 1/65536 turn, including vectors with large components and all octants
+static double maxErrorAtan2(uint16_t (*f)(int32_t, int32_t), double radius) {
+  double err = 0;
+  for (unsigned i = 0; i < 100000; i++) {
+    double phi = TWO_PI_D * i / 100000;
+    int32_t x = lround(radius * cos(phi)), y = lround(radius * sin(phi));
+    double ref = atan2((double)y, (double)x) * 65536 / TWO_PI_D;
+    if (ref < 0) ref += 65536;
+    double e = fabs(f(y, x) - ref);
+    if (e > 32768) e = 65536 - e; // wrap around 0
+    if (e > err) err = e;
+  }
+  return err;
+}
+
+void test_atan2_16(void) {
+  const double radius[] = {1000.0, 30000.0, 2e9};
+  double e = 0;
+  for (double r : radius) { double er = maxErrorAtan2(lutAtan2_16, r); if (er > e) e = er; }
+  double e6 = maxErrorAtan2(lutAtan2_16_6, 30000.0);
+  printf("  atan2_16 %.2f (6 bit %.2f) of 65536\n", e, e6);
+  TEST_ASSERT_TRUE(e < 3.0);  // ~0.02 degrees
+  TEST_ASSERT_TRUE(e6 < 5.0);
+  TEST_ASSERT_EQUAL_UINT(0,      lutAtan2_16(0, 0));
+  TEST_ASSERT_EQUAL_UINT(0,      lutAtan2_16(0, 5));
+  TEST_ASSERT_EQUAL_UINT(0x4000, lutAtan2_16(5, 0));
+  TEST_ASSERT_EQUAL_UINT(0x8000, lutAtan2_16(0, -5));
+  TEST_ASSERT_EQUAL_UINT(0xC000, lutAtan2_16(-5, 0));
+  TEST_ASSERT_EQUAL_UINT(0x2000, lutAtan2_16(7, 7));
+}
+
+// ns per call; the table pays off on targets without FPU (ESP32-C3), on host libm is shown for reference only
+#define BENCH_N 1000000
+static float angles[1024];
+static int32_t coords[1024];
+static volatile float sinkF;
+static volatile int32_t sinkI;
+
+template <typename F> static double nsPerCall(F f) {
+  auto t0 = std::chrono::steady_clock::now();
+  for (unsigned i = 0; i < BENCH_N; i++) f(i & 1023);
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / BENCH_N;
+}
+
+void test_timing(void) {
+  for (unsigned i = 0; i < 1024; i++) { angles[i] = -10.0f + 20.0f * i / 1024; coords[i] = (int32_t)(i * 2654435761U) >> 12; }
+  double tLutSin  = nsPerCall([](unsigned i) { sinkF = lutSin(angles[i]); });
+  double tSinf    = nsPerCall([](unsigned i) { sinkF = sinf(angles[i]); });
+  double tSin16   = nsPerCall([](unsigned i) { sinkI = lutSin16(i * 64); });
+  double tSin16f  = nsPerCall([](unsigned i) { sinkI = (int32_t)(sinf(i * 64 * (6.2831853f / 65536)) * 32767); });
+  double tAtan16  = nsPerCall([](unsigned i) { sinkI = lutAtan2_16(coords[i], coords[(i + 1) & 1023]); });
+  double tAtan2f  = nsPerCall([](unsigned i) { sinkI = (int32_t)(atan2f(coords[i], coords[(i + 1) & 1023]) * (65536 / 6.2831853f)); });
+  printf("  ns/call: sin_lut %.1f sinf %.1f | sin16_t %.1f sinf->Q15 %.1f | atan2_16_t %.1f atan2f->turn %.1f\n",
+         tLutSin, tSinf, tSin16, tSin16f, tAtan16, tAtan2f);
+  TEST_ASSERT_TRUE(tLutSin > 0 && tSin16 > 0 && tAtan16 > 0);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_sin_cos_8bit);
+  RUN_TEST(test_sin_cos_6bit);
+  RUN_TEST(test_tan);
+  RUN_TEST(test_quadrants);
+  RUN_TEST(test_sin16_cos16);
+  RUN_TEST(test_atan2_16);
+  RUN_TEST(test_timing);
+  return UNITY_END();
+}
@@ -28,13 +28,27 @@
 #define WS2812FX_h
 
 #include <vector>
+#include <bitset>
 
 #include "const.h"
+#include "static_sig.h"
 
 #define FASTLED_INTERNAL //remove annoying pragma messages
 #define USE_GET_MILLISECOND_TIMER
 #include "FastLED.h"
 
+#ifdef WLED_ENABLE_FX_BENCHMARK
+class BusCapture; // bus_manager.h
+#endif
+
+// render/output pipeline needs a second core
+#if defined(WLED_ENABLE_PIPELINE) && (!defined(ARDUINO_ARCH_ESP32) || defined(CONFIG_FREERTOS_UNICORE))
+  #undef WLED_ENABLE_PIPELINE
+#endif
+#ifdef WLED_ENABLE_PIPELINE
+#include "frame_handoff.h"
+#endif
+
 #define DEFAULT_BRIGHTNESS (uint8_t)127
 #define DEFAULT_MODE       (uint8_t)0
 #define DEFAULT_SPEED      (uint8_t)128
@@ -59,7 +73,7 @@
 /* Not used in all effects yet */
 #define WLED_FPS         42
 #define FRAMETIME_FIXED  (1000/WLED_FPS)
-#define FRAMETIME        strip.getFrameTime()
+#define FRAMETIME        strip.getSegmentFrameTime()
 
 /* each segment uses 82 bytes of SRAM memory, so if you're application fails because of
   insufficient memory, decreasing MAX_NUM_SEGMENTS may help */
@@ -78,11 +92,38 @@
   #endif
 #endif
 
+/* number of expanded (256 entry) palette lookup tables shared by all segments, each takes ~1.1kB of RAM */
+#ifndef WLED_PALETTE_LUTS
+  #ifdef ESP8266
+    #define WLED_PALETTE_LUTS 1
+  #else
+    #define WLED_PALETTE_LUTS 4
+  #endif
+#endif
+
+/* max size (bytes) of cached 1D to 2D expansion map (Arc, Corner, Pinwheel) per segment, larger maps are calculated per pixel */
+#ifndef WLED_MAX_MAP1D2D_SIZE
+  #ifdef ESP8266
+    #define WLED_MAX_MAP1D2D_SIZE 6144   // up to 32x32 pinwheel
+  #else
+    #define WLED_MAX_MAP1D2D_SIZE 24576  // up to 64x64 pinwheel
+  #endif
+#endif
+
+/* pixels staged on stack when primitives (fill, fade, blur) work on strip pixels of segments without buffer (see Segment::stripRow()) */
+#ifndef WLED_SEGMENT_SPAN_PIXELS
+  #ifdef ESP8266
+    #define WLED_SEGMENT_SPAN_PIXELS 64
+  #else
+    #define WLED_SEGMENT_SPAN_PIXELS 128
+  #endif
+#endif
+
 /* How much data bytes each segment should max allocate to leave enough space for other segments,
   assuming each segment uses the same amount of data. 256 for ESP8266, 640 for ESP32. */
 #define FAIR_DATA_PER_SEG (MAX_SEGMENT_DATA / strip.getMaxSegments())
 
-#define MIN_SHOW_DELAY   (_frametime < 16 ? 8 : 15)
+#define MIN_SHOW_DELAY   (_minFrametime < 16 ? 8 : 15)
 
 #define NUM_COLORS       3 /* number of colors per segment */
 #define SEGMENT          strip._segments[strip.getCurrSegmentId()]
@@ -368,6 +409,7 @@ typedef struct Segment {
     };
     uint8_t startY;  // start Y coodrinate 2D (top); there should be no more than 255 rows
     uint8_t stopY;   // stop Y coordinate 2D (bottom); there should be no more than 255 rows
+    uint8_t fps;     // target frame rate of segment (0 = use strip frame rate)
     char    *name;
 
     // runtime data
@@ -416,6 +458,30 @@ typedef struct Segment {
     };
     uint16_t        _dataLen;
     static uint16_t _usedSegmentData;
+#ifndef WLED_DISABLE_PROFILER
+    static uint16_t _allocCount;  // effect data (re)allocations
+    static uint16_t _allocFails;  // allocateData() requests that ran out of memory
+    static uint16_t _allocMax;    // largest allocateData() request
+#endif
+#ifdef WLED_ENABLE_FX_BENCHMARK
+    static uint16_t _benchAllocs;     // allocateData() calls that needed a new buffer (incl. failed ones) since resetBenchAllocs()
+    static uint32_t _benchAllocBytes; // bytes requested by those calls
+#endif
+    uint32_t       *_pixels;      // segment render buffer (virtual resolution), used if useSegmentBuffer is enabled
+    uint16_t        _pixelsLen;   // number of pixels in render buffer
+
+    // cached 1D to 2D expansion for Arc, Corner and Pinwheel mapping (allocated as a single block)
+    // virtual strip pixel i covers pixels[first[i]] to pixels[first[i+1]-1], each stored as x + y * width
+    typedef struct Map1D2D {
+      uint16_t  width;    // virtual width the map was built for
+      uint16_t  height;   // virtual height the map was built for
+      uint16_t  length;   // number of virtual strip pixels
+      uint8_t   type;     // map1D2D the map was built for
+      uint16_t *first;    // length+1 offsets into pixels[]
+      uint16_t *pixels;
+    } map1d2d_t;
+    map1d2d_t      *_map12;
+    uint32_t        _staticSig;   // signature of last rendered Solid state (0 if segment needs rendering)
 
     // perhaps this should be per segment, not static
     static CRGBPalette16 _currentPalette;     // palette used for current effect (includes transition, used in color_from_palette())
@@ -423,15 +489,43 @@ typedef struct Segment {
     static CRGBPalette16 _newRandomPalette;   // target random palette
     static uint16_t _lastPaletteChange;       // last random palette change time in millis()/1000
     static uint16_t _lastPaletteBlend;        // blend palette according to set Transition Delay in millis()%0xFFFF
+
+    // palette expanded to 256 colors so color_from_palette() does not need to interpolate for every pixel
+    // tables are shared between segments using the same palette and are rebuilt when palette (or blending) changes
+    typedef struct PaletteLUT {
+      CRGBPalette16 pal;        // palette the table was built from
+      uint32_t      lastUse;    // millis() of last use (least recently used table is replaced)
+      uint8_t       blendType;  // TBlendType used for interpolation
+      bool          used;       // table has been assigned to a palette
+      bool          built;      // colors are valid (table is filled on first use)
+      uint32_t      color[256]; // RGB colors as returned by ColorFromPalette() with full brightness
+    } palette_lut_t;
+    static palette_lut_t *_paletteLUT;        // WLED_PALETTE_LUTS tables, allocated on first use
+    static palette_lut_t *_currentLUT;        // table matching _currentPalette (or nullptr)
+    static void selectPaletteLUT(void);       // finds or assigns table for _currentPalette
     #ifndef WLED_DISABLE_MODE_BLEND
     static bool          _modeBlend;          // mode/effect blending semaphore
     #endif
 
+    // render buffer if primitives (fill, fade, blur) may operate on it directly, nullptr if they need to go pixel by pixel
+    #ifndef WLED_DISABLE_MODE_BLEND
+    inline uint32_t *spanPixels(void) const { return _modeBlend ? nullptr : _pixels; } // blending into buffer is done in setPixelColor()
+    #else
+    inline uint32_t *spanPixels(void) const { return _pixels; }
+    #endif
+    static void blurPixels(uint32_t *pixels, unsigned len, unsigned stride, uint8_t blur_amount, bool smear); // blurs run of buffer pixels
+    // strip pixels without segment buffer: row maps 1:1 onto consecutive strip pixels (no grouping, offset, reverse, mirror...)
+    int  stripRow(unsigned y) const;                                    // strip index of first pixel of row y, -1 if pixels need to go one by one
+    void setStripRun(unsigned first, uint32_t *c, unsigned n);          // applies brightness and writes run with strip.setPixelRange()
+    template<typename F> bool stripSpans(bool read, F op);              // op(c, n) on runs of all rows, false if not possible
+
     // transition data, valid only if transitional==true, holds values during transition (72 bytes)
     struct Transition {
       #ifndef WLED_DISABLE_MODE_BLEND
       tmpsegd_t     _segT;        // previous segment environment
       uint8_t       _modeT;       // previous mode/effect
+      uint32_t     *_pixelsT;     // render buffer of previous mode/effect (if segment buffer is used)
+      uint16_t      _pixelsLenT;  // number of pixels in previous mode render buffer
       #else
       uint32_t      _colorT[NUM_COLORS];
       #endif
@@ -446,7 +540,12 @@ typedef struct Segment {
         , _prevPaletteBlends(0)
         , _start(millis())
         , _dur(dur)
-      {}
+      {
+        #ifndef WLED_DISABLE_MODE_BLEND
+        _pixelsT = nullptr;
+        _pixelsLenT = 0;
+        #endif
+      }
     } *_t;
 
   public:
@@ -473,6 +572,7 @@ typedef struct Segment {
       check3(false),
       startY(0),
       stopY(1),
+      fps(0),
       name(nullptr),
       next_time(0),
       step(0),
@@ -482,6 +582,10 @@ typedef struct Segment {
       data(nullptr),
       _capabilities(0),
       _dataLen(0),
+      _pixels(nullptr),
+      _pixelsLen(0),
+      _map12(nullptr),
+      _staticSig(0),
       _t(nullptr)
     {
       #ifdef WLED_DEBUG
@@ -507,13 +611,15 @@ typedef struct Segment {
       if (name) { delete[] name; name = nullptr; }
       stopTransition();
       deallocateData();
+      deallocatePixels();
+      deallocateMap1D2D();
     }
 
     Segment& operator= (const Segment &orig); // copy assignment
     Segment& operator= (Segment &&orig) noexcept; // move assignment
 
 #ifdef WLED_DEBUG
-    size_t getSize() const { return sizeof(Segment) + (data?_dataLen:0) + (name?strlen(name):0) + (_t?sizeof(Transition):0); }
+    size_t getSize() const { return sizeof(Segment) + (data?_dataLen:0) + (name?strlen(name):0) + (_t?sizeof(Transition):0) + (_pixels?_pixelsLen*sizeof(uint32_t):0) + (_map12?sizeof(map1d2d_t)+(_map12->length+1+_map12->first[_map12->length])*sizeof(uint16_t):0); }
 #endif
 
     inline bool     getOption(uint8_t n) const { return ((options >> n) & 0x01); }
@@ -532,6 +638,17 @@ typedef struct Segment {
 
     static uint16_t getUsedSegmentData(void)    { return _usedSegmentData; }
     static void     addUsedSegmentData(int len) { _usedSegmentData += len; }
+    #ifndef WLED_DISABLE_PROFILER
+    static uint16_t getAllocCount(void)         { return _allocCount; }
+    static uint16_t getAllocFails(void)         { return _allocFails; }
+    static uint16_t getAllocMax(void)           { return _allocMax; }
+    static void     resetAllocStats(void)       { _allocCount = _allocFails = _allocMax = 0; }
+    #endif
+    #ifdef WLED_ENABLE_FX_BENCHMARK
+    static uint16_t getBenchAllocs(void)        { return _benchAllocs; }
+    static uint32_t getBenchAllocBytes(void)    { return _benchAllocBytes; }
+    static void     resetBenchAllocs(void)      { _benchAllocs = 0; _benchAllocBytes = 0; }
+    #endif
     #ifndef WLED_DISABLE_MODE_BLEND
     static void     modeBlend(bool blend)       { _modeBlend = blend; }
     #endif
@@ -553,6 +670,18 @@ typedef struct Segment {
     bool allocateData(size_t len);  // allocates effect data buffer in heap and clears it
     void deallocateData(void);      // deallocates (frees) effect data buffer from heap
     void resetIfRequired(void);     // sets all SEGENV variables to 0 and clears data buffer
+    bool allocatePixels(void);      // (re)allocates render buffer to match virtual segment size
+    void deallocatePixels(void);    // releases render buffer, effects will write directly to strip
+    void flushPixels(void);         // copies render buffer to strip (applies brightness, grouping, mirroring, etc.)
+    inline bool hasPixelBuffer(void) const { return _pixels != nullptr; }
+    bool allocateBlendPixels(void); // gives previous mode its own render buffer (copy of current one) while in mode transition
+    void updateMap1D2D(void);       // (re)builds cached 1D to 2D expansion if mapping or geometry changed
+    void deallocateMap1D2D(void);
+    void swapBlendPixels(void);     // exchanges render buffers of current and previous mode
+    uint32_t staticSignature(void) const; // hash of everything Solid effect output depends on
+    inline StaticState getStaticState(uint32_t sig, bool useBuffer, bool overlapped) const { return staticState(_staticSig, sig, call > 0, useBuffer, hasPixelBuffer(), overlapped); }
+    inline void setStaticSignature(uint32_t sig) { _staticSig = sig; }
+    bool overlaps(const Segment &seg) const;
     /**
       * Flags that before the next effect is calculated,
       * the internal segment state should be reset.
@@ -613,6 +742,7 @@ typedef struct Segment {
     inline void setPixelColorXY(int x, int y, byte r, byte g, byte b, byte w = 0) { setPixelColorXY(x, y, RGBW32(r,g,b,w)); }
     inline void setPixelColorXY(int x, int y, CRGB c)                             { setPixelColorXY(x, y, RGBW32(c.r,c.g,c.b,0)); }
     inline void setPixelColorXY(unsigned x, unsigned y, CRGB c)                   { setPixelColorXY(int(x), int(y), RGBW32(c.r,c.g,c.b,0)); }
+    void setPixelRowXY(int x, int y, const uint32_t *c, unsigned n); // set n pixels of row y starting at x
     #ifdef WLED_USE_AA_PIXELS
     void setPixelColorXY(float x, float y, uint32_t c, bool aa = true);
     inline void setPixelColorXY(float x, float y, byte r, byte g, byte b, byte w = 0, bool aa = true) { setPixelColorXY(x, y, RGBW32(r,g,b,w), aa); }
@@ -651,6 +781,7 @@ typedef struct Segment {
     inline void setPixelColorXY(int x, int y, byte r, byte g, byte b, byte w = 0) { setPixelColor(x, RGBW32(r,g,b,w)); }
     inline void setPixelColorXY(int x, int y, CRGB c)                             { setPixelColor(x, RGBW32(c.r,c.g,c.b,0)); }
     inline void setPixelColorXY(unsigned x, unsigned y, CRGB c)                   { setPixelColor(int(x), RGBW32(c.r,c.g,c.b,0)); }
+    inline void setPixelRowXY(int x, int y, const uint32_t *c, unsigned n)        { for (unsigned i = 0; i < n; i++) setPixelColor(x + int(i), c[i]); }
     #ifdef WLED_USE_AA_PIXELS
     inline void setPixelColorXY(float x, float y, uint32_t c, bool aa = true)     { setPixelColor(x, c, aa); }
     inline void setPixelColorXY(float x, float y, byte r, byte g, byte b, byte w = 0, bool aa = true) { setPixelColor(x, RGBW32(r,g,b,w), aa); }
@@ -698,6 +829,36 @@ class WS2812FX {  // 96 bytes
 
   public:
 
+#ifdef WLED_ENABLE_FX_BENCHMARK
+  // per effect results of the headless benchmark (see FX_bench.cpp)
+  typedef struct BenchmarkResult {
+    uint32_t usAvg;      // average effect function time per frame
+    uint32_t usMax;      // slowest frame
+    uint16_t dataBytes;  // effect data (SEGENV.data) size after last frame
+    uint32_t allocBytes; // bytes requested from allocateData() for new buffers
+    uint8_t  allocs;     // number of times allocateData() had to (re)allocate effect data buffer, failed attempts included
+    bool     failed;     // allocateData() ran out of memory
+  } bench_result_t;
+  // segment primitives timed after all effects (with and without render buffer)
+  #define BENCH_PRIM_FILL    0
+  #define BENCH_PRIM_FADE    1 // fadeToBlackBy()
+  #define BENCH_PRIM_FADEOUT 2 // fade_out()
+  #define BENCH_PRIM_BLUR    3
+  #define BENCH_PRIMITIVES   4
+#endif
+
+#ifndef WLED_DISABLE_PROFILER
+  // per segment render statistics (see /json/perf), restarted when segment changes effect
+  typedef struct PerfStat {
+    uint32_t usSum;     // render time of counted frames (halved together with frames to follow recent load)
+    uint32_t usTrans;   // part of usSum spent rendering previous mode while in transition
+    uint32_t usMin;
+    uint32_t usMax;
+    uint16_t frames;
+    uint8_t  mode;
+  } perf_stat_t;
+#endif
+
     WS2812FX() :
       paletteFade(0),
       paletteBlend(0),
@@ -718,11 +879,19 @@ class WS2812FX {  // 96 bytes
       _transitionDur(750),
       _targetFps(WLED_FPS),
       _frametime(FRAMETIME_FIXED),
+      _minFrametime(FRAMETIME_FIXED),
+      _segFrametime(FRAMETIME_FIXED),
       _cumulativeFps(2),
+      _repaintEpoch(0),
       _isServicing(false),
       _isOffRefreshRequired(false),
       _hasWhiteChannel(false),
       _triggered(false),
+      _deferred(false),
+      _held(false),
+#ifndef WLED_DISABLE_PROFILER
+      _perfReset(true),
+#endif
       _modeCount(MODE_COUNT),
       _callback(nullptr),
       customMappingTable(nullptr),
@@ -738,6 +907,18 @@ class WS2812FX {  // 96 bytes
       _qGrouping(0),
       _qSpacing(0),
       _qOffset(0)
+#ifdef WLED_ENABLE_FX_BENCHMARK
+      , _captureBus(nullptr)
+#endif
+#ifdef WLED_ENABLE_PIPELINE
+      , _handoff(nullptr)
+      , _frameBuffer(nullptr)
+      , _renderTask(nullptr)
+      , _rendering(false)
+      , _renderingToBuffer(false)
+      , _pipelineChecked(false)
+      , _outputTime(0)
+#endif
     {
       WS2812FX::instance = this;
       _mode.reserve(_modeCount);     // allocate memory to prevent initial fragmentation (does not increase size())
@@ -777,24 +958,56 @@ class WS2812FX {  // 96 bytes
       makeAutoSegments(bool forceReset = false),  // will create segments based on configured outputs
       fixInvalidSegments(),                       // fixes incorrect segment configuration
       setPixelColor(unsigned n, uint32_t c),      // paints absolute strip pixel with index n and color c
+      setPixelRange(unsigned n, unsigned len, const uint32_t *c), // paints len consecutive strip pixels starting at n (realtime bulk ingest, segment spans)
+      getPixelRange(unsigned n, unsigned len, uint32_t *c),       // reads len consecutive strip pixels starting at n
       show(void),                                 // initiates LED output
       setTargetFps(uint8_t fps),
       addEffect(uint8_t id, mode_ptr mode_fn, const char *mode_name), // add effect to the list; defined in FX.cpp
       setupEffectData(void);                      // add default effects to the list; defined in FX.cpp
 
     inline void restartRuntime()          { for (Segment &seg : _segments) seg.markForReset(); }
-    inline void setTransitionMode(bool t) { for (Segment &seg : _segments) seg.startTransition(t ? _transitionDur : 0); }
+    void setTransitionMode(bool t);
     inline void setColor(uint8_t slot, uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0)    { setColor(slot, RGBW32(r,g,b,w)); }
     inline void setPixelColor(unsigned n, uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0) { setPixelColor(n, RGBW32(r,g,b,w)); }
     inline void setPixelColor(unsigned n, CRGB c)                                         { setPixelColor(n, c.red, c.green, c.blue); }
     inline void fill(uint32_t c)          { for (unsigned i = 0; i < getLengthTotal(); i++) setPixelColor(i, c); } // fill whole strip with color (inline)
     inline void trigger(void)                                 { _triggered = true; }  // Forces the next frame to be computed on all active segments.
+    inline void repaintUnchanged(void)                        { _repaintEpoch++; trigger(); } // LEDs were overwritten (realtime, bus re-init), unchanged Solid segments are repainted too
+    inline uint32_t getRepaintEpoch(void) const               { return _repaintEpoch; }
     inline void setShowCallback(show_callback cb)             { _callback = cb; }
     inline void setTransition(uint16_t t)                     { _transitionDur = t; } // sets transition time (in ms)
-    inline void appendSegment(const Segment &seg = Segment()) { if (_segments.size() < getMaxSegments()) _segments.push_back(seg); }
+    void appendSegment(const Segment &seg = Segment());
+#ifdef WLED_ENABLE_PIPELINE
+    void suspend(void);                                       // will suspend strip.service() execution and wait for render task to pause
+    bool pauseRendering(void);                                // suspend() for a single segment change (see RenderLock), false if nothing was paused
+#else
     inline void suspend(void)                                 { _suspend = true; }    // will suspend (and canacel) strip.service() execution
+#endif
     inline void resume(void)                                  { _suspend = false; }   // will resume strip.service() execution
 
+#ifdef WLED_ENABLE_FX_BENCHMARK
+    // headless effect benchmark; defined in FX_bench.cpp
+    bool startBenchmark(uint16_t width, uint16_t height = 1, uint16_t frames = 100); // queues benchmark of all effects on a virtual WxH canvas
+    void handleBenchmark(void);                               // renders one effect per call, must be called from loop()
+    bool isBenchmarking(void);                                // returns true if benchmark is queued or running
+    const std::vector<bench_result_t>& getBenchmarkResults(uint16_t &width, uint16_t &height, uint16_t &frames);
+    uint32_t getBenchmarkPrimitive(uint8_t prim, bool buffered); // average us per call of segment primitive (BENCH_PRIM_*) without/with render buffer
+#endif
+
+#ifdef WLED_ENABLE_PIPELINE
+    // effects are rendered by a task on the other core into a back buffer while service() (in loop()) shows the last frame
+    bool startPipeline(void);                                 // false if not possible (memory, CCT buses need per segment CCT at output)
+    void stopPipeline(void);
+    inline bool isPipelined(void) const                       { return _handoff != nullptr; }
+#endif
+
+#ifndef WLED_DISABLE_PROFILER
+    const perf_stat_t* getPerfStats(uint8_t seg);            // nullptr if segment did not render since last reset
+    uint32_t getServiceTime(bool peak = false);               // smoothed (or peak) us spent in service() rendering segments
+    uint32_t getShowTime(bool peak = false);                  // smoothed (or peak) us spent sending frame to all buses
+    inline void resetPerf(void)                               { _perfReset = true; } // statistics are cleared by next service()
+#endif
+
     bool
       paletteFade,
       checkSegmentAlignment(void),
@@ -834,6 +1047,7 @@ class WS2812FX {  // 96 bytes
       getMappedPixelIndex(uint16_t index);
 
     inline uint16_t getFrameTime(void)    { return _frametime; }        // returns amount of time a frame should take (in ms)
+    inline uint16_t getSegmentFrameTime(void) { return _segFrametime; } // frame time of segment being rendered (FRAMETIME), strip frame time outside of service()
     inline uint16_t getMinShowDelay(void) { return MIN_SHOW_DELAY; }    // returns minimum amount of time strip.service() can be delayed (constant)
     inline uint16_t getLength(void)       { return _length; }           // returns actual amount of LEDs on a strip (2D matrix may have less LEDs than W*H)
     inline uint16_t getTransition(void)   { return _transitionDur; }    // returns currently set transition time (in ms)
@@ -922,7 +1136,11 @@ class WS2812FX {  // 96 bytes
 
     uint8_t  _targetFps;
     uint16_t _frametime;
+    uint16_t _minFrametime;   // frame time of fastest segment (limits how often service() runs)
+    uint16_t _segFrametime;   // frame time of segment being rendered
     uint16_t _cumulativeFps;
+    uint32_t _repaintEpoch;   // part of Solid segment signature, see repaintUnchanged()
+    std::bitset<MAX_NUM_SEGMENTS> _pendingSegments; // due segments deferred by last renderSegments() pass
 
     // will require only 1 byte
     struct {
@@ -930,6 +1148,11 @@ class WS2812FX {  // 96 bytes
       bool _isOffRefreshRequired : 1; //periodic refresh is required for the strip to remain off.
       bool _hasWhiteChannel      : 1;
       bool _triggered            : 1;
+      bool _deferred             : 1; // due segments were left for next service() call
+      bool _held                 : 1; // last show() held back buses of deferred segments
+#ifndef WLED_DISABLE_PROFILER
+      bool _perfReset            : 1;
+#endif
     };
 
     uint8_t                  _modeCount;
@@ -949,12 +1172,46 @@ class WS2812FX {  // 96 bytes
     uint16_t _qStart, _qStop, _qStartY, _qStopY;
     uint8_t _qGrouping, _qSpacing;
     uint16_t _qOffset;
+
+#ifdef WLED_ENABLE_FX_BENCHMARK
+    BusCapture *_captureBus; // when set all pixels go to in-memory sink instead of BusManager
+#endif
+#ifdef WLED_ENABLE_PIPELINE
+    FrameHandoff<uint32_t> *_handoff;         // frames rendered by render task, picked up by service()
+    uint32_t               *_frameBuffer;     // strip sized back buffer render task draws into
+    TaskHandle_t            _renderTask;
+    volatile bool           _rendering;       // render task is inside renderSegments()
+    volatile bool           _renderingToBuffer; // render pass in progress, strip pixel writes go to _frameBuffer
+    bool                    _pipelineChecked; // startPipeline() was attempted since finalizeInit()
+    volatile unsigned long  _outputTime;      // millis() of last service() call, render task pauses when loop() stops calling it
+
+    static void renderTask(void *parameter);
+    void showPipelineFrame(void);
+#endif
+    bool renderSegments(unsigned long nowUp); // runs due effects, returns true if strip needs to be shown
+    bool holdPending(void);                   // true if output of deferred segments should wait for next pass
+    void holdPendingBuses(void);              // keeps buses of deferred segments from being shown by next show()
+    void showBuses(void);                     // show() without overlays
 /*
     void
       setUpSegmentFromQueuedChanges(void);
 */
 };
 
+// held by segment setters while a segment is changed, render task (WLED_ENABLE_PIPELINE) waits until the change is done
+// covers callers that do not suspend() the strip themselves (IR, Alexa, buttons, nightlight, usermods)
+class RenderLock {
+  public:
+#ifdef WLED_ENABLE_PIPELINE
+    RenderLock() : _paused(WS2812FX::getInstance()->pauseRendering()) {}
+    ~RenderLock() { if (_paused) WS2812FX::getInstance()->resume(); }
+  private:
+    bool _paused;
+#else
+    RenderLock() {}
+#endif
+};
+
 extern const char JSON_mode_names[];
 extern const char JSON_palette_names[];
 
@@ -173,6 +173,17 @@ void IRAM_ATTR Segment::setPixelColorXY(int x, int y, uint32_t col)
   if (!isActive()) return; // not active
   if (x >= virtualWidth() || y >= virtualHeight() || x<0 || y<0) return;  // if pixel would fall out of virtual segment just exit
 
+  if (_pixels) { // render into segment buffer, strip is updated in flushPixels()
+    unsigned idx = x + y * virtualWidth();
+    if (idx < _pixelsLen) {
+#ifndef WLED_DISABLE_MODE_BLEND
+      if (_modeBlend) col = color_blend(_pixels[idx], col, 0xFFFFU - progress(), true);
+#endif
+      _pixels[idx] = col;
+    }
+    return;
+  }
+
   uint8_t _bri_t = currentBri();
   if (_bri_t < 255) {
     col = color_fade(col, _bri_t);
@@ -214,6 +225,21 @@ void IRAM_ATTR Segment::setPixelColorXY(int x, int y, uint32_t col)
   }
 }
 
+// setPixelRowXY(x,y,c,n) - sets n pixels of row y starting at x (images), rows of the segment buffer are copied at once
+void Segment::setPixelRowXY(int x, int y, const uint32_t *c, unsigned n)
+{
+  if (!isActive() || y < 0 || y >= virtualHeight()) return;
+  const int cols = virtualWidth();
+  if (x < 0) { if (unsigned(-x) >= n) return; c -= x; n += x; x = 0; }
+  if (x >= cols) return;
+  n = MIN(n, unsigned(cols - x));
+  if (uint32_t *pixels = spanPixels()) {
+    const unsigned idx = x + y * cols;
+    if (idx + n <= _pixelsLen) { memcpy(pixels + idx, c, n * sizeof(uint32_t)); return; }
+  }
+  for (unsigned i = 0; i < n; i++) setPixelColorXY(x + int(i), y, c[i]);
+}
+
 #ifdef WLED_USE_AA_PIXELS
 // anti-aliased version of setPixelColorXY()
 void Segment::setPixelColorXY(float x, float y, uint32_t col, bool aa)
@@ -264,6 +290,7 @@ void Segment::setPixelColorXY(float x, float y, uint32_t col, bool aa)
 uint32_t IRAM_ATTR Segment::getPixelColorXY(int x, int y) {
   if (!isActive()) return 0; // not active
   if (x >= virtualWidth() || y >= virtualHeight() || x<0 || y<0) return 0;  // if pixel would fall out of virtual segment just exit
+  if (_pixels) { unsigned idx = x + y * virtualWidth(); return idx < _pixelsLen ? _pixels[idx] : 0; } // exact (not brightness reduced) value
   if (reverse  ) x = virtualWidth()  - x - 1;
   if (reverse_y) y = virtualHeight() - y - 1;
   if (transpose) { unsigned t = x; x = y; y = t; } // swap X & Y if segment transposed
@@ -280,6 +307,19 @@ void Segment::blurRow(uint32_t row, fract8 blur_amount, bool smear){
   const unsigned rows = virtualHeight();
 
   if (row >= rows) return;
+  if (uint32_t *pixels = spanPixels()) {
+    if ((row + 1) * cols <= _pixelsLen) blurPixels(pixels + row * cols, cols, 1, blur_amount, smear);
+    return;
+  }
+  // unchanged pixels are not written (and faded) again, so only without brightness reduction
+  const int first = stripRow(row);
+  if (first >= 0 && cols <= WLED_SEGMENT_SPAN_PIXELS && currentBri() == 255) {
+    uint32_t px[WLED_SEGMENT_SPAN_PIXELS];
+    strip.getPixelRange(first, cols, px);
+    blurPixels(px, cols, 1, blur_amount, smear);
+    strip.setPixelRange(first, cols, px);
+    return;
+  }
   // blur one row
   uint8_t keep = smear ? 255 : 255 - blur_amount;
   uint8_t seep = blur_amount >> 1;
@@ -313,6 +353,10 @@ void Segment::blurCol(uint32_t col, fract8 blur_amount, bool smear) {
   const unsigned rows = virtualHeight();
 
   if (col >= cols) return;
+  if (uint32_t *pixels = spanPixels()) {
+    if (cols * rows <= _pixelsLen) blurPixels(pixels + col, rows, cols, blur_amount, smear);
+    return;
+  }
   // blur one column
   uint8_t keep = smear ? 255 : 255 - blur_amount;
   uint8_t seep = blur_amount >> 1;
@@ -351,10 +395,15 @@ void Segment::box_blur(uint16_t i, bool vertical, fract8 blur_amount) {
   const float keep = 3.f - 2.f*seep;
   // 1D box blur
   uint32_t out[dim1], in[dim1];
+  // render buffer: row is contiguous, column has stride of one row
+  uint32_t *pixels = spanPixels();
+  if (pixels && cols * rows > _pixelsLen) pixels = nullptr;
+  if (pixels) pixels += vertical ? i : i * cols;
+  const int stride = vertical ? cols : 1;
   for (int j = 0; j < dim1; j++) {
     int x = vertical ? i : j;
     int y = vertical ? j : i;
-    in[j] = getPixelColorXY(x, y);
+    in[j] = pixels ? pixels[j * stride] : getPixelColorXY(x, y);
   }
   for (int j = 0; j < dim1; j++) {
     uint32_t curr = in[j];
@@ -367,6 +416,10 @@ void Segment::box_blur(uint16_t i, bool vertical, fract8 blur_amount) {
     w = (W(curr)*keep + (W(prev) + W(next))*seep) / 3;
     out[j] = RGBW32(r,g,b,w);
   }
+  if (pixels) {
+    for (int j = 0; j < dim1; j++) pixels[j * stride] = out[j];
+    return;
+  }
   for (int j = 0; j < dim1; j++) {
     int x = vertical ? i : j;
     int y = vertical ? j : i;
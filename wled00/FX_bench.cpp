@@ -0,0 +1,203 @@
+/*
+  FX_bench.cpp contains headless effect benchmark
+
+  Every registered effect is rendered for a fixed number of frames on a single
+  virtual segment of configurable size (1D or 2D). Pixels are routed into an
+  in-memory BusCapture sink instead of physical buses so results only reflect
+  effect rendering and the Segment/strip pixel path, not LED driver timing.
+  Strip time (strip.now) is advanced by one frame time per rendered frame which
+  makes results reproducible between runs and builds.
+  After all effects segment primitives (fill, fades, blur) are timed once
+  without segment buffer (on runs of strip pixels, see Segment::stripRow())
+  and once operating on the segment render buffer.
+
+  Enable with -D WLED_ENABLE_FX_BENCHMARK, start with /json/bench?run&w=64&h=64&n=100
+  and read results from /json/bench. Regular strip output is suspended while
+  the benchmark runs and original segments are restored afterwards.
+
+  On host the same benchmark runs against the Arduino/FastLED shims in
+  test/native: pio test -e native_fx (see test/test_fx_bench).
+  Platform independent kernels used by the render path (color math, trig
+  tables, frame handoff, realtime ingest) are tested with pio test -e native.
+*/
+#include "wled.h"
+#include "FX.h"
+
+#ifdef WLED_ENABLE_FX_BENCHMARK
+
+static struct {
+  uint16_t width, height, frames;
+  uint8_t  mode;      // next effect to benchmark
+  bool     queued;    // start requested (possibly from async web handler)
+  bool     running;   // strip is taken over by benchmark
+  std::vector<WS2812FX::bench_result_t> results;
+  uint32_t primitives[BENCH_PRIMITIVES][2]; // us per call, [0] strip pixels, [1] render buffer
+  // saved strip state
+  std::vector<Segment> segments;
+  uint16_t length, maxWidth, maxHeight, mappingSize;
+  uint8_t  mainSegment;
+  bool     isMatrix;
+} bench;
+
+bool WS2812FX::startBenchmark(uint16_t width, uint16_t height, uint16_t frames) {
+  if (bench.queued || bench.running || realtimeMode != REALTIME_MODE_INACTIVE) return false;
+#ifdef WLED_DISABLE_2D
+  height = 1;
+#endif
+  if (width == 0 || height == 0 || height > 255 || width * height > UINT16_MAX) return false;
+  bench.width  = width;
+  bench.height = height;
+  bench.frames = constrain(frames, 1, 1000);
+  bench.mode   = 0;
+  bench.results.clear();
+  memset(bench.primitives, 0, sizeof(bench.primitives));
+  bench.queued = true;
+  return true;
+}
+
+bool WS2812FX::isBenchmarking() {
+  return bench.queued || bench.running;
+}
+
+const std::vector<WS2812FX::bench_result_t>& WS2812FX::getBenchmarkResults(uint16_t &width, uint16_t &height, uint16_t &frames) {
+  width  = bench.width;
+  height = bench.height;
+  frames = bench.frames;
+  return bench.results;
+}
+
+uint32_t WS2812FX::getBenchmarkPrimitive(uint8_t prim, bool buffered) {
+  return prim < BENCH_PRIMITIVES ? bench.primitives[prim][buffered] : 0;
+}
+
+// times fill/fade/blur on benchmark segment, once on strip pixel runs and once operating on render buffer
+static void benchmarkPrimitives(Segment &seg, unsigned frames) {
+  for (unsigned buffered = 0; buffered < 2; buffered++) {
+    if (buffered && !seg.allocatePixels()) break;
+    if (!buffered) seg.deallocatePixels();
+    for (unsigned p = 0; p < BENCH_PRIMITIVES; p++) {
+      seg.fill(RGBW32(200,100,50,0)); // start from same content for every primitive
+      unsigned long us = micros();
+      for (unsigned f = 0; f < frames; f++) {
+        switch (p) {
+          case BENCH_PRIM_FILL:    seg.fill(f & 1 ? BLACK : RGBW32(200,100,50,0)); break;
+          case BENCH_PRIM_FADE:    seg.fadeToBlackBy(32); break;
+          case BENCH_PRIM_FADEOUT: seg.fade_out(32); break;
+          case BENCH_PRIM_BLUR:    seg.blur(64); break;
+        }
+      }
+      bench.primitives[p][buffered] = (micros() - us) / frames;
+      DEBUG_PRINTF_P(PSTR("FX benchmark primitive %u (%s): %6u us.\n"), p, buffered ? "buffer" : "pixels", (unsigned)bench.primitives[p][buffered]);
+      yield();
+    }
+  }
+  seg.deallocatePixels();
+}
+
+void WS2812FX::handleBenchmark() {
+  if (bench.queued) {
+    if (isUpdating()) return; // wait for async output to finish
+    // take over the strip
+    bench.queued = false;
+    suspend();
+    _captureBus = new BusCapture(bench.width * bench.height);
+    if (!_captureBus || !_captureBus->isOk()) {
+      DEBUG_PRINTLN(F("FX benchmark: not enough RAM for capture sink."));
+      delete _captureBus;
+      _captureBus = nullptr;
+      resume();
+      return;
+    }
+    bench.results.reserve(_modeCount);
+    bench.segments    = std::move(_segments);
+    bench.length      = _length;
+    bench.maxWidth    = Segment::maxWidth;
+    bench.maxHeight   = Segment::maxHeight;
+    bench.mappingSize = customMappingSize;
+    bench.mainSegment = _mainSegment;
+    bench.isMatrix    = isMatrix;
+    _segments.clear();
+    _length           = bench.width * bench.height;
+    Segment::maxWidth = bench.width;
+    Segment::maxHeight= bench.height;
+    customMappingSize = 0; // ledmap may contain indices outside of capture sink
+    isMatrix          = bench.height > 1;
+    _mainSegment      = 0;
+    _segments.emplace_back(0, bench.width, 0, bench.height);
+    _segments[0].refreshLightCapabilities();
+    bench.running = true;
+    DEBUG_PRINTF_P(PSTR("FX benchmark started: %ux%u, %u frames.\n"), (unsigned)bench.width, (unsigned)bench.height, (unsigned)bench.frames);
+    return;
+  }
+  if (!bench.running) return;
+
+  if (bench.mode < _modeCount) {
+    uint8_t m = bench.mode++;
+    bench_result_t res = {0, 0, 0, 0, 0, false};
+    if (strncmp_P("RSVD", _modeData[m], 4) == 0) { bench.results.push_back(res); return; }
+
+    Segment &seg = _segments[0];
+    seg.deallocateData(); // each effect has to allocate its own data
+    seg.setMode(m, true);
+    seg.stopTransition();
+    seg.resetIfRequired();
+    if (useSegmentBuffer) seg.allocatePixels(); else seg.deallocatePixels();
+    seg.updateMap1D2D();
+    Segment::resetBenchAllocs();
+    byte oldError  = errorFlag;
+    errorFlag      = ERR_NONE;
+    uint32_t usTotal = 0;
+    unsigned long t = millis();
+
+    _isServicing   = true;
+    _segment_index = 0;
+    for (unsigned f = 0; f < bench.frames; f++) {
+      now = t + f * _frametime;
+      _virtualSegmentLength = seg.virtualLength();
+      _colors_t[0] = gamma32(seg.currentColor(0));
+      _colors_t[1] = gamma32(seg.currentColor(1));
+      _colors_t[2] = gamma32(seg.currentColor(2));
+      seg.setCurrentPalette();
+      unsigned long us = micros();
+      (*_mode[m])();
+      seg.flushPixels(); // include compositing cost when segment buffers are used
+      us = micros() - us;
+      seg.call++;
+      _captureBus->show();
+      usTotal += us;
+      if (us > res.usMax) res.usMax = us;
+      yield();
+    }
+    _virtualSegmentLength = 0;
+    _isServicing = false;
+
+    res.usAvg      = usTotal / bench.frames;
+    res.dataBytes  = seg.dataSize();
+    res.allocs     = MIN(Segment::getBenchAllocs(), 255);
+    res.allocBytes = Segment::getBenchAllocBytes();
+    res.failed     = (errorFlag == ERR_NORAM);
+    errorFlag      = oldError;
+    bench.results.push_back(res);
+    DEBUG_PRINTF_P(PSTR("FX benchmark %3u: %6u us avg, %6u us max, %5u B data, %u allocs.\n"), (unsigned)m, (unsigned)res.usAvg, (unsigned)res.usMax, (unsigned)res.dataBytes, (unsigned)res.allocs);
+    return;
+  }
+
+  // all effects done, time segment primitives and restore original strip
+  benchmarkPrimitives(_segments[0], bench.frames);
+  _segments.clear();
+  _segments          = std::move(bench.segments);
+  _length            = bench.length;
+  Segment::maxWidth  = bench.maxWidth;
+  Segment::maxHeight = bench.maxHeight;
+  customMappingSize  = bench.mappingSize;
+  _mainSegment       = bench.mainSegment;
+  isMatrix           = bench.isMatrix;
+  delete _captureBus;
+  _captureBus = nullptr;
+  bench.running = false;
+  DEBUG_PRINTLN(F("FX benchmark finished."));
+  resume();
+  trigger();
+}
+
+#endif
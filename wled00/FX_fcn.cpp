@@ -74,6 +74,15 @@
 // Segment class implementation
 ///////////////////////////////////////////////////////////////////////////////
 uint16_t Segment::_usedSegmentData = 0U; // amount of RAM all segments use for their data[]
+#ifndef WLED_DISABLE_PROFILER
+uint16_t Segment::_allocCount = 0;
+uint16_t Segment::_allocFails = 0;
+uint16_t Segment::_allocMax = 0;
+#endif
+#ifdef WLED_ENABLE_FX_BENCHMARK
+uint16_t Segment::_benchAllocs = 0;
+uint32_t Segment::_benchAllocBytes = 0;
+#endif
 uint16_t Segment::maxWidth = DEFAULT_LED_COUNT;
 uint16_t Segment::maxHeight = 1;
 
@@ -82,6 +91,8 @@ CRGBPalette16 Segment::_randomPalette     = generateRandomPalette();  // was CRG
 CRGBPalette16 Segment::_newRandomPalette  = generateRandomPalette();  // was CRGBPalette16(DEFAULT_COLOR);
 uint16_t      Segment::_lastPaletteChange = 0; // perhaps it should be per segment
 uint16_t      Segment::_lastPaletteBlend  = 0; //in millis (lowest 16 bits only)
+Segment::palette_lut_t *Segment::_paletteLUT = nullptr;
+Segment::palette_lut_t *Segment::_currentLUT = nullptr;
 
 #ifndef WLED_DISABLE_MODE_BLEND
 bool Segment::_modeBlend = false;
@@ -95,6 +106,10 @@ Segment::Segment(const Segment &orig) {
   name = nullptr;
   data = nullptr;
   _dataLen = 0;
+  _pixels = nullptr; // render buffer is re-allocated on next frame
+  _pixelsLen = 0;
+  _map12 = nullptr;  // expansion map is rebuilt on next frame
+  _staticSig = 0;    // nothing rendered yet
   if (orig.name) { name = new char[strlen(orig.name)+1]; if (name) strcpy(name, orig.name); }
   if (orig.data) { if (allocateData(orig._dataLen)) memcpy(data, orig.data, orig._dataLen); }
 }
@@ -107,6 +122,9 @@ Segment::Segment(Segment &&orig) noexcept {
   orig.name = nullptr;
   orig.data = nullptr;
   orig._dataLen = 0;
+  orig._pixels = nullptr;
+  orig._pixelsLen = 0;
+  orig._map12 = nullptr;
 }
 
 // copy assignment
@@ -117,11 +135,17 @@ Segment& Segment::operator= (const Segment &orig) {
     if (name) { delete[] name; name = nullptr; }
     stopTransition();
     deallocateData();
+    deallocatePixels();
+    deallocateMap1D2D();
     // copy source
     memcpy((void*)this, (void*)&orig, sizeof(Segment));
     // erase pointers to allocated data
     data = nullptr;
     _dataLen = 0;
+    _pixels = nullptr;
+    _pixelsLen = 0;
+    _map12 = nullptr;
+    _staticSig = 0;
     // copy source data
     if (orig.name) { name = new char[strlen(orig.name)+1]; if (name) strcpy(name, orig.name); }
     if (orig.data) { if (allocateData(orig._dataLen)) memcpy(data, orig.data, orig._dataLen); }
@@ -136,10 +160,15 @@ Segment& Segment::operator= (Segment &&orig) noexcept {
     if (name) { delete[] name; name = nullptr; } // free old name
     stopTransition();
     deallocateData(); // free old runtime data
+    deallocatePixels();
+    deallocateMap1D2D();
     memcpy((void*)this, (void*)&orig, sizeof(Segment));
     orig.name = nullptr;
     orig.data = nullptr;
     orig._dataLen = 0;
+    orig._pixels = nullptr;
+    orig._pixelsLen = 0;
+    orig._map12 = nullptr;
     orig._t   = nullptr; // old segment cannot be in transition
   }
   return *this;
@@ -154,8 +183,19 @@ bool IRAM_ATTR Segment::allocateData(size_t len) {
   }
   //DEBUG_PRINTF_P(PSTR("--   Allocating data (%d): %p\n", len, this);
   deallocateData(); // if the old buffer was smaller release it first
+#ifndef WLED_DISABLE_PROFILER
+  if (len > _allocMax) _allocMax = MIN(len, (size_t)UINT16_MAX);
+  if (_allocCount < UINT16_MAX) _allocCount++;
+#endif
+#ifdef WLED_ENABLE_FX_BENCHMARK
+  if (_benchAllocs < UINT16_MAX) _benchAllocs++;
+  _benchAllocBytes += len;
+#endif
   if (Segment::getUsedSegmentData() + len > MAX_SEGMENT_DATA) {
     // not enough memory
+#ifndef WLED_DISABLE_PROFILER
+    if (_allocFails < UINT16_MAX) _allocFails++;
+#endif
     DEBUG_PRINT(F("!!! Effect RAM depleted: "));
     DEBUG_PRINTF_P(PSTR("%d/%d !!!\n"), len, Segment::getUsedSegmentData());
     errorFlag = ERR_NORAM;
@@ -163,7 +203,13 @@ bool IRAM_ATTR Segment::allocateData(size_t len) {
   }
   // do not use SPI RAM on ESP32 since it is slow
   data = (byte*)calloc(len, sizeof(byte));
-  if (!data) { DEBUG_PRINTLN(F("!!! Allocation failed. !!!")); return false; } // allocation failed
+  if (!data) {
+    DEBUG_PRINTLN(F("!!! Allocation failed. !!!"));
+#ifndef WLED_DISABLE_PROFILER
+    if (_allocFails < UINT16_MAX) _allocFails++;
+#endif
+    return false; // allocation failed
+  }
   Segment::addUsedSegmentData(len);
   //DEBUG_PRINTF_P(PSTR("---  Allocated data (%p): %d/%d -> %p\n"), this, len, Segment::getUsedSegmentData(), data);
   _dataLen = len;
@@ -187,6 +233,216 @@ void IRAM_ATTR Segment::deallocateData() {
   _dataLen = 0;
 }
 
+// render buffers and expansion maps are accounted like effect data, if they do not fit segment is rendered without them
+static bool reserveSegmentData(size_t len) {
+  if (Segment::getUsedSegmentData() + len > MAX_SEGMENT_DATA) return false;
+  Segment::addUsedSegmentData(len);
+  return true;
+}
+
+static void releaseSegmentData(size_t len) {
+  Segment::addUsedSegmentData(-(int)MIN(len, (size_t)Segment::getUsedSegmentData()));
+}
+
+// (re)allocates render buffer so it covers all virtual pixels of the segment
+// effects then draw into the buffer and flushPixels() copies it to the strip once per frame
+bool Segment::allocatePixels() {
+  unsigned len = virtualLength();
+#ifndef WLED_DISABLE_2D
+  unsigned len2D = virtualWidth() * virtualHeight();
+  if (is2D() || len2D > len) len = len2D; // 1D effects on 2D segment are expanded into XY buffer
+#endif
+  if (len == 0 || len > UINT16_MAX) { deallocatePixels(); return false; }
+  if (_pixels && _pixelsLen == len) return true;
+  deallocatePixels();
+  if (!reserveSegmentData(len * sizeof(uint32_t))) return false; // render directly to strip
+  _pixels = (uint32_t*)calloc(len, sizeof(uint32_t));
+  if (!_pixels) { releaseSegmentData(len * sizeof(uint32_t)); DEBUG_PRINTLN(F("!!! Segment buffer allocation failed. !!!")); return false; }
+  _pixelsLen = len;
+  return true;
+}
+
+void Segment::deallocatePixels() {
+  if (_pixels) { free(_pixels); releaseSegmentData(_pixelsLen * sizeof(uint32_t)); }
+  _pixels = nullptr;
+  _pixelsLen = 0;
+}
+
+// inverse of the expansion setPixelColor() (strip1D) or setPixelColorXY() does along one axis:
+// grouping, spacing, reverse, mirror and (1D only) offset; used by flushPixels() to write rows as runs of strip pixels
+typedef struct FlushAxis {
+  unsigned phys;      // physical pixels (segment width or height, length if 1D)
+  unsigned vLen;      // virtual pixels
+  unsigned gl;        // groupLength()
+  unsigned grouping;
+  unsigned offset;
+  bool     rev, mir, strip1D;
+
+  // virtual index drawn last onto physical position p (pixels are flushed in ascending order), -1 if none
+  int source(unsigned p) const {
+    if (offset) p = (p + phys - offset % phys) % phys;
+    int v = -1;
+    for (unsigned m = 0; m < (mir ? 2U : 1U); m++) {
+      unsigned q = m ? phys - 1 - p : p;
+      if (rev && strip1D) { // 1D groups grow towards segment start
+        int t = int(mir ? (phys - 1) / 2 : phys - 1) - int(q);
+        if (t < 0) continue;
+        q = t;
+      }
+      unsigned x = q / gl;
+      if (q % gl >= grouping || x >= vLen) continue;
+      if (rev && !strip1D) x = vLen - 1 - x;
+      v = MAX(v, int(x));
+    }
+    return v;
+  }
+  // true if physical position p shows virtual pixel p
+  inline bool identity(void) const { return gl == 1 && !rev && !mir && !offset; }
+} flush_axis_t;
+
+#define FLUSH_RUN_PIXELS 32
+
+// blends, fades and writes n gathered render buffer pixels to consecutive strip pixels starting at first
+static void flushRun(unsigned first, const uint32_t *pixels, const uint32_t *pixelsT, const uint16_t *idx, unsigned n, uint16_t prog, uint8_t bri) {
+  uint32_t c[FLUSH_RUN_PIXELS];
+  for (unsigned k = 0; k < n; k++) c[k] = pixels[idx[k]];
+  if (pixelsT) {
+    uint32_t t[FLUSH_RUN_PIXELS];
+    for (unsigned k = 0; k < n; k++) t[k] = pixelsT[idx[k]];
+    blend_span(c, t, c, n, prog, true);
+  }
+  fade_span(c, c, n, bri);
+  strip.setPixelRange(first, n, c);
+}
+
+// writes physical row starting at strip index first from render buffer row starting at base
+static void flushRow(unsigned first, const flush_axis_t &x, unsigned base, const uint32_t *pixels, const uint32_t *pixelsT, uint16_t prog, uint8_t bri) {
+  uint16_t idx[FLUSH_RUN_PIXELS];
+  const bool identity = x.identity();
+  unsigned n = 0, runStart = 0;
+  for (unsigned p = 0; p < x.phys; p++) {
+    int v = identity ? (p < x.vLen ? int(p) : -1) : x.source(p);
+    if (v >= 0) {
+      if (n == 0) runStart = p;
+      idx[n++] = base + v;
+    }
+    if (n && (v < 0 || n == FLUSH_RUN_PIXELS || p + 1 == x.phys)) {
+      flushRun(first + runStart, pixels, pixelsT, idx, n, prog, bri);
+      n = 0;
+    }
+  }
+}
+
+// composites render buffer into strip (and bus buffers)
+// while in mode transition both render buffers (current and previous mode) are blended together in this single pass
+// mapping (grouping, spacing, reverse, mirror, offset) is resolved per physical row which is written in runs with
+// strip.setPixelRange(), brightness is applied to whole runs; transposed segments go pixel by pixel
+void Segment::flushPixels() {
+  if (!_pixels || !isActive()) return;
+  uint32_t *pixels = _pixels;
+  unsigned  len    = _pixelsLen;
+  const uint32_t *pixelsT = nullptr; // previous mode render buffer
+  uint16_t prog = 0xFFFFU;
+#ifndef WLED_DISABLE_MODE_BLEND
+  if (isInTransition() && _t->_pixelsT && _t->_pixelsLenT == len) {
+    pixelsT = _t->_pixelsT;
+    prog = progress();
+  }
+#endif
+  const uint8_t bri = currentBri();
+#ifndef WLED_DISABLE_2D
+  // 2D segments and 1D segments within matrix are drawn with setPixelColorXY()
+  const bool xy = is2D() || (Segment::maxHeight != 1 && (width() == 1 || height() == 1) && start < Segment::maxWidth * Segment::maxHeight);
+  if (xy && !transpose) {
+    const unsigned cols = virtualWidth();
+    const unsigned rows = MIN((unsigned)virtualHeight(), len / cols);
+    const flush_axis_t x = {width(),  cols,            groupLength(), grouping, 0, reverse,   mirror,   false};
+    const flush_axis_t y = {height(), virtualHeight(), groupLength(), grouping, 0, reverse_y, mirror_y, false};
+    for (unsigned py = 0; py < y.phys; py++) {
+      int vy = y.source(py);
+      if (vy < 0 || (unsigned)vy >= rows) continue;
+      flushRow((startY + py) * Segment::maxWidth + start, x, vy * cols, pixels, pixelsT, prog, bri);
+    }
+    return;
+  }
+  if (xy) {
+    // returns n pixels starting at idx, both buffers are blended a chunk at a time while in transition
+    uint32_t blended[32];
+    auto chunk = [&](unsigned idx, unsigned n) -> const uint32_t* {
+      if (!pixelsT) return pixels + idx;
+      blend_span(blended, pixelsT + idx, pixels + idx, n, prog, true);
+      return blended;
+    };
+    _pixels = nullptr; // temporarily disable buffer so setPixelColorXY() writes to strip
+    const unsigned cols = virtualWidth();
+    const unsigned rows = virtualHeight();
+    for (unsigned y = 0; y < rows; y++) for (unsigned x = 0; x < cols; ) {
+      unsigned idx = x + y * cols;
+      if (idx >= len) break;
+      unsigned n = MIN(MIN(cols - x, len - idx), sizeof(blended)/sizeof(blended[0]));
+      const uint32_t *c = chunk(idx, n);
+      for (unsigned k = 0; k < n; k++, x++) setPixelColorXY((int)x, (int)y, c[k]);
+    }
+    _pixels = pixels;
+    return;
+  }
+#endif
+  const flush_axis_t x = {length(), MIN(len, (unsigned)virtualLength()), groupLength(), grouping, offset, reverse, mirror, true};
+  flushRow(start, x, 0, pixels, pixelsT, prog, bri);
+}
+
+// Solid effect output only depends on these, if none of them changed since last frame segment need not be rendered again
+uint32_t Segment::staticSignature() const {
+  static_sig_input_t in;
+  in.color    = colors[0];
+  in.mode     = mode;
+  in.opacity  = opacity;
+  in.cct      = cct;
+  in.options  = options & ~SELECTED;
+  in.start    = start;
+  in.stop     = stop;
+  in.startY   = startY;
+  in.stopY    = stopY;
+  in.grouping = grouping;
+  in.spacing  = spacing;
+  in.offset   = offset;
+  in.gammaCorrectCol = gammaCorrectCol;
+  in.cctFromRgb      = cctFromRgb;
+  in.correctWB       = correctWB;
+  in.cctBlending     = strip.cctBlending;
+  return ::staticSignature(in, strip.getRepaintEpoch());
+}
+
+bool Segment::overlaps(const Segment &seg) const {
+  return start < seg.stop && seg.start < stop && startY < seg.stopY && seg.startY < stopY;
+}
+
+#ifndef WLED_DISABLE_MODE_BLEND
+// previous mode renders into its own buffer so it can read back its own pixels and both modes can be blended once in flushPixels()
+// buffer starts as a copy of current render buffer (last frame shown) so previous mode continues seamlessly
+bool Segment::allocateBlendPixels() {
+  if (!_pixels || !isInTransition()) return false;
+  if (_t->_pixelsT && _t->_pixelsLenT == _pixelsLen) return true;
+  if (_t->_pixelsT) { free(_t->_pixelsT); releaseSegmentData(_t->_pixelsLenT * sizeof(uint32_t)); }
+  _t->_pixelsT = nullptr;
+  _t->_pixelsLenT = 0;
+  if (!reserveSegmentData(_pixelsLen * sizeof(uint32_t))) return false; // fall back to blending in setPixelColor()
+  _t->_pixelsT = (uint32_t*)malloc(_pixelsLen * sizeof(uint32_t));
+  if (!_t->_pixelsT) { releaseSegmentData(_pixelsLen * sizeof(uint32_t)); DEBUG_PRINTLN(F("!!! Transition buffer allocation failed. !!!")); return false; }
+  memcpy(_t->_pixelsT, _pixels, _pixelsLen * sizeof(uint32_t));
+  _t->_pixelsLenT = _pixelsLen;
+  return true;
+}
+
+void Segment::swapBlendPixels() {
+  if (!_pixels || !isInTransition() || !_t->_pixelsT) return;
+  std::swap(_pixels, _t->_pixelsT);
+}
+#else
+bool Segment::allocateBlendPixels() { return false; }
+void Segment::swapBlendPixels() {}
+#endif
+
 /**
   * If reset of this segment was requested, clears runtime
   * settings of this segment.
@@ -298,6 +554,7 @@ void Segment::startTransition(uint16_t dur) {
     _t->_modeT          = mode;
     _t->_segT._dataLenT = 0;
     _t->_segT._dataT    = nullptr;
+    // render buffer of previous mode is allocated in service() when needed (see allocateBlendPixels())
     if (_dataLen > 0 && data) {
       _t->_segT._dataT = (byte *)malloc(_dataLen);
       if (_t->_segT._dataT) {
@@ -324,6 +581,9 @@ void Segment::stopTransition() {
       _t->_segT._dataT = nullptr;
       _t->_segT._dataLenT = 0;
     }
+    if (_t->_pixelsT) { free(_t->_pixelsT); releaseSegmentData(_t->_pixelsLenT * sizeof(uint32_t)); }
+    _t->_pixelsT = nullptr;
+    _t->_pixelsLenT = 0;
     #endif
     delete _t;
     _t = nullptr;
@@ -452,7 +712,39 @@ void Segment::setCurrentPalette() {
     unsigned noOfBlends = ((255U * prog) / 0xFFFFU) - _t->_prevPaletteBlends;
     for (unsigned i = 0; i < noOfBlends; i++, _t->_prevPaletteBlends++) nblendPaletteTowardPalette(_t->_palT, _currentPalette, 48);
     _currentPalette = _t->_palT; // copy transitioning/temporary palette
+    _currentLUT = nullptr;       // palette changes every frame, a table would be rebuilt each time (and evict ones still in use)
+    return;
+  }
+  selectPaletteLUT();
+}
+
+// palette contents are compared so segments sharing a palette share a table and any change
+// (palette selection, random palette, transition blending) invalidates it
+void Segment::selectPaletteLUT() {
+  _currentLUT = nullptr;
+  if (!_paletteLUT) {
+    _paletteLUT = (palette_lut_t*)malloc(WLED_PALETTE_LUTS * sizeof(palette_lut_t));
+    if (!_paletteLUT) return; // interpolate for each pixel
+    for (unsigned i = 0; i < WLED_PALETTE_LUTS; i++) { _paletteLUT[i].used = false; _paletteLUT[i].built = false; _paletteLUT[i].lastUse = 0; }
+  }
+  const uint8_t blendType = (strip.paletteBlend == 3) ? NOBLEND : LINEARBLEND;
+  const uint32_t now = millis();
+  palette_lut_t *lru = &_paletteLUT[0];
+  for (unsigned i = 0; i < WLED_PALETTE_LUTS; i++) {
+    palette_lut_t &lut = _paletteLUT[i];
+    if (lut.used && lut.blendType == blendType && lut.pal == _currentPalette) {
+      lut.lastUse = now;
+      _currentLUT = &lut;
+      return;
+    }
+    if (!lut.used || (lru->used && now - lut.lastUse > now - lru->lastUse)) lru = &lut;
   }
+  lru->pal       = _currentPalette;
+  lru->blendType = blendType;
+  lru->used      = true;
+  lru->built     = false;
+  lru->lastUse   = now;
+  _currentLUT    = lru;
 }
 
 // relies on WS2812FX::service() to call it for each frame
@@ -485,6 +777,7 @@ void Segment::setUp(uint16_t i1, uint16_t i2, uint8_t grp, uint8_t spc, uint16_t
       && (!grp || (grouping == grp && spacing == spc))
       && (ofs == UINT16_MAX || ofs == offset)) return;
 
+  RenderLock lock;
   stateChanged = true; // send UDP/WS broadcast
 
   if (stop) fill(BLACK); // turn old segment range off (clears pixels if changing spacing)
@@ -534,6 +827,7 @@ bool Segment::setColor(uint8_t slot, uint32_t c) { //returns true if changed
     if (slot == 0 && c == BLACK) return false; // on/off segment cannot have primary color black
     if (slot == 1 && c != BLACK) return false; // on/off segment cannot have secondary color non black
   }
+  RenderLock lock;
   if (fadeTransition) startTransition(strip.getTransition()); // start transition prior to change
   colors[slot] = c;
   stateChanged = true; // send UDP/WS broadcast
@@ -547,6 +841,7 @@ void Segment::setCCT(uint16_t k) {
     k = (k - 1900) >> 5;
   }
   if (cct == k) return;
+  RenderLock lock;
   if (fadeTransition) startTransition(strip.getTransition()); // start transition prior to change
   cct = k;
   stateChanged = true; // send UDP/WS broadcast
@@ -554,12 +849,14 @@ void Segment::setCCT(uint16_t k) {
 
 void Segment::setOpacity(uint8_t o) {
   if (opacity == o) return;
+  RenderLock lock;
   if (fadeTransition) startTransition(strip.getTransition()); // start transition prior to change
   opacity = o;
   stateChanged = true; // send UDP/WS broadcast
 }
 
 void Segment::setOption(uint8_t n, bool val) {
+  RenderLock lock;
   bool prevOn = on;
   if (fadeTransition && n == SEG_OPTION_ON && val != prevOn) startTransition(strip.getTransition()); // start transition prior to change
   if (val) options |=   0x01 << n;
@@ -573,6 +870,7 @@ void Segment::setMode(uint8_t fx, bool loadDefaults) {
   if (fx >= strip.getModeCount()) fx = 0; // set solid mode
   // if we have a valid mode & is not reserved
   if (fx != mode) {
+    RenderLock lock;
 #ifndef WLED_DISABLE_MODE_BLEND
     if (modeBlending) startTransition(strip.getTransition()); // set effect transitions
 #endif
@@ -605,6 +903,7 @@ void Segment::setPalette(uint8_t pal) {
   if (pal < 245 && pal > GRADIENT_PALETTE_COUNT+13) pal = 0; // built in palettes
   if (pal > 245 && (strip.customPalettes.size() == 0 || 255U-pal > strip.customPalettes.size()-1)) pal = 0; // custom palettes
   if (pal != palette) {
+    RenderLock lock;
     if (strip.paletteFade) startTransition(strip.getTransition());
     palette = pal;
     stateChanged = true; // send UDP/WS broadcast
@@ -674,8 +973,156 @@ static int getPinwheelLength(int vW, int vH) {
   // else
   return Pinwheel_Steps_XL;
 }
+
+// Pinwheel ray at angle of pixel i, drawn from center to the segment edge
+// we use fixed point math for better speed. Starting distance is 0.5 for better rounding
+struct PinwheelRay {
+  int posx, posy;   // position in fixed point 18 bit
+  int inc_x, inc_y; // increment per step (fixed point) 10 bit
+  int lastX, lastY; // pixel of previous step
+  PinwheelRay(int i, int vW, int vH) : lastX(INT_MIN), lastY(INT_MIN) {
+    float centerX = roundf((vW-1) / 2.0f);
+    float centerY = roundf((vH-1) / 2.0f);
+    float angleRad = getPinwheelAngle(i, vW, vH); // angle in radians
+    float cosVal = cos_t(angleRad);
+    float sinVal = sin_t(angleRad);
+    posx = (centerX + 0.5f * cosVal) * Fixed_Scale;
+    posy = (centerY + 0.5f * sinVal) * Fixed_Scale;
+    inc_x = cosVal * Fixed_Scale;
+    inc_y = sinVal * Fixed_Scale;
+  }
+  // scale down to integer (compiler will replace division with appropriate bitshift)
+  inline int x() const { return posx / Fixed_Scale; }
+  inline int y() const { return posy / Fixed_Scale; }
+  inline bool inside(int32_t maxX, int32_t maxY) const { return posx >= 0 && posy >= 0 && posx < maxX && posy < maxY; }
+  inline bool covers(int px, int py) const { return (px == x() && py == y()) || (px == lastX && py == lastY); }
+  inline void step() { lastX = x(); lastY = y(); posx += inc_x; posy += inc_y; }
+};
+
+// calls fn(x, y) for every pixel of a vW x vH segment that virtual strip pixel i expands to (Arc, Corner and Pinwheel)
+// for a pinwheel ray last pixel is its outer end (used by getPixelColor())
+template <typename F>
+static void expand1D2D(uint8_t map, int i, int vW, int vH, F fn) {
+  switch (map) {
+    case M12_pArc:
+      // expand in circular fashion from center
+      if (i==0)
+        fn(0, 0);
+      else {
+        float step = HALF_PI / (2.85f*i);
+        for (float rad = 0.0f; rad <= HALF_PI+step/2; rad += step) {
+          // may want to try float version as well (with or without antialiasing)
+          int x = roundf(sin_t(rad) * i);
+          int y = roundf(cos_t(rad) * i);
+          fn(x, y);
+        }
+        // Bresenham’s Algorithm (may not fill every pixel)
+        //int d = 3 - (2*i);
+        //int y = i, x = 0;
+        //while (y >= x) {
+        //  fn(x, y);
+        //  fn(y, x);
+        //  x++;
+        //  if (d > 0) {
+        //    y--;
+        //    d += 4 * (x - y) + 10;
+        //  } else {
+        //    d += 4 * x + 6;
+        //  }
+        //}
+      }
+      break;
+    case M12_pCorner:
+      for (int x = 0; x <= i; x++) fn(x, i);
+      for (int y = 0; y <  i; y++) fn(i, y);
+      break;
+    case M12_sPinwheel: {
+      // i = angle --> 0 - 296  (Big), 0 - 192  (Medium), 0 - 72 (Small)
+      PinwheelRay ray(i, vW, vH);
+      // avoid re-painting the same pixel
+      int lastX = INT_MIN; // impossible position
+      int lastY = INT_MIN; // impossible position
+
+      int32_t maxX = vW * Fixed_Scale; // X edge in fixedpoint
+      int32_t maxY = vH * Fixed_Scale; // Y edge in fixedpoint
+
+      // Odd rays fill the gaps between even rays. Near the center their pixels are already covered by a neighbouring
+      // even ray; those are skipped (walking the neighbours in step) up to the first pixel no neighbour covers.
+      if (i % 2 == 1) {
+        PinwheelRay prev(i - 1, vW, vH);
+        PinwheelRay next((i + 1) % getPinwheelLength(vW, vH), vW, vH);
+        while (ray.inside(maxX, maxY) && (prev.covers(ray.x(), ray.y()) || next.covers(ray.x(), ray.y()))) {
+          ray.step(); prev.step(); next.step();
+        }
+      }
+
+      // draw ray until we hit any edge
+      while (ray.inside(maxX, maxY)) {
+        int x = ray.x();
+        int y = ray.y();
+        if (x != lastX || y != lastY) fn(x, y);  // only paint if pixel position is different
+        lastX = x;
+        lastY = y;
+        ray.step(); // advance to next position
+      }
+      break;
+    }
+  }
+}
 #endif
 
+// expansion of Arc, Corner and Pinwheel is a pure function of pixel index and segment size so it is calculated
+// once (instead of for every pixel in every frame) if it fits into WLED_MAX_MAP1D2D_SIZE
+void Segment::updateMap1D2D() {
+#ifndef WLED_DISABLE_2D
+  const unsigned vW = virtualWidth();
+  const unsigned vH = virtualHeight();
+  if (!is2D() || (map1D2D != M12_pArc && map1D2D != M12_pCorner && map1D2D != M12_sPinwheel)) { deallocateMap1D2D(); return; }
+  if (_map12 && _map12->type == map1D2D && _map12->width == vW && _map12->height == vH) return; // still valid
+  deallocateMap1D2D();
+  const unsigned len = virtualLength();
+  // 1st pass: count (adjacent duplicates are skipped, they would be painted twice with the same color)
+  unsigned count = 0;
+  for (unsigned i = 0; i < len; i++) {
+    int lx = INT_MIN, ly = INT_MIN;
+    expand1D2D(map1D2D, i, vW, vH, [&](int x, int y) {
+      if ((x != lx || y != ly) && x >= 0 && y >= 0 && x < (int)vW && y < (int)vH) count++;
+      lx = x; ly = y;
+    });
+  }
+  size_t size = sizeof(map1d2d_t) + (len + 1 + count) * sizeof(uint16_t);
+  if (count > UINT16_MAX || size > WLED_MAX_MAP1D2D_SIZE) return; // expand each pixel when painting
+  if (!reserveSegmentData(size)) return;
+  _map12 = (map1d2d_t*)malloc(size);
+  if (!_map12) { releaseSegmentData(size); return; }
+  _map12->width  = vW;
+  _map12->height = vH;
+  _map12->length = len;
+  _map12->type   = map1D2D;
+  _map12->first  = (uint16_t*)(_map12 + 1);
+  _map12->pixels = _map12->first + len + 1;
+  // 2nd pass: fill
+  unsigned n = 0;
+  for (unsigned i = 0; i < len; i++) {
+    _map12->first[i] = n;
+    int lx = INT_MIN, ly = INT_MIN;
+    expand1D2D(map1D2D, i, vW, vH, [&](int x, int y) {
+      if ((x != lx || y != ly) && x >= 0 && y >= 0 && x < (int)vW && y < (int)vH) _map12->pixels[n++] = x + y * vW;
+      lx = x; ly = y;
+    });
+  }
+  _map12->first[len] = n;
+#endif
+}
+
+void Segment::deallocateMap1D2D() {
+  if (_map12) {
+    releaseSegmentData(sizeof(map1d2d_t) + (_map12->length + 1 + _map12->first[_map12->length]) * sizeof(uint16_t));
+    free(_map12);
+  }
+  _map12 = nullptr;
+}
+
 // 1D strip
 uint16_t IRAM_ATTR Segment::virtualLength() const {
 #ifndef WLED_DISABLE_2D
@@ -729,83 +1176,18 @@ void IRAM_ATTR Segment::setPixelColor(int i, uint32_t col)
         else          for (int x = 0; x < vW; x++) setPixelColorXY(x, vH - i - 1, col);
         break;
       case M12_pArc:
-        // expand in circular fashion from center
-        if (i==0)
-          setPixelColorXY(0, 0, col);
-        else {
-          float step = HALF_PI / (2.85f*i);
-          for (float rad = 0.0f; rad <= HALF_PI+step/2; rad += step) {
-            // may want to try float version as well (with or without antialiasing)
-            int x = roundf(sin_t(rad) * i);
-            int y = roundf(cos_t(rad) * i);
-            setPixelColorXY(x, y, col);
-          }
-          // Bresenham’s Algorithm (may not fill every pixel)
-          //int d = 3 - (2*i);
-          //int y = i, x = 0;
-          //while (y >= x) {
-          //  setPixelColorXY(x, y, col);
-          //  setPixelColorXY(y, x, col);
-          //  x++;
-          //  if (d > 0) {
-          //    y--;
-          //    d += 4 * (x - y) + 10;
-          //  } else {
-          //    d += 4 * x + 6;
-          //  }
-          //}
-        }
-        break;
       case M12_pCorner:
-        for (int x = 0; x <= i; x++) setPixelColorXY(x, i, col);
-        for (int y = 0; y <  i; y++) setPixelColorXY(i, y, col);
-        break;
-      case M12_sPinwheel: {
-        // i = angle --> 0 - 296  (Big), 0 - 192  (Medium), 0 - 72 (Small)
-        float centerX = roundf((vW-1) / 2.0f);
-        float centerY = roundf((vH-1) / 2.0f);
-        float angleRad = getPinwheelAngle(i, vW, vH); // angle in radians
-        float cosVal = cos_t(angleRad);
-        float sinVal = sin_t(angleRad);
-
-        // avoid re-painting the same pixel
-        int lastX = INT_MIN; // impossible position
-        int lastY = INT_MIN; // impossible position
-        // draw line at angle, starting at center and ending at the segment edge
-        // we use fixed point math for better speed. Starting distance is 0.5 for better rounding
-        // int_fast16_t and int_fast32_t types changed to int, minimum bits commented
-        int posx = (centerX + 0.5f * cosVal) * Fixed_Scale; // X starting position in fixed point 18 bit
-        int posy = (centerY + 0.5f * sinVal) * Fixed_Scale; // Y starting position in fixed point 18 bit
-        int inc_x = cosVal * Fixed_Scale; // X increment per step (fixed point) 10 bit
-        int inc_y = sinVal * Fixed_Scale; // Y increment per step (fixed point) 10 bit
-
-        int32_t maxX = vW * Fixed_Scale; // X edge in fixedpoint
-        int32_t maxY = vH * Fixed_Scale; // Y edge in fixedpoint
-
-        // Odd rays start further from center if prevRay started at center.
-        static int prevRay = INT_MIN; // previous ray number
-        if ((i % 2 == 1) && (i - 1 == prevRay || i + 1 == prevRay)) {
-          int jump = min(vW/3, vH/3); // can add 2 if using medium pinwheel 
-          posx += inc_x * jump;
-          posy += inc_y * jump;
-        }
-        prevRay = i;
-
-        // draw ray until we hit any edge
-        while ((posx >= 0) && (posy >= 0) && (posx < maxX)  && (posy < maxY))  {
-          // scale down to integer (compiler will replace division with appropriate bitshift)
-          int x = posx / Fixed_Scale;
-          int y = posy / Fixed_Scale;
-          // set pixel
-          if (x != lastX || y != lastY) setPixelColorXY(x, y, col);  // only paint if pixel position is different
-          lastX = x;
-          lastY = y;
-          // advance to next position
-          posx += inc_x;
-          posy += inc_y;
+      case M12_sPinwheel:
+        if (_map12 && _map12->type == map1D2D && _map12->width == vW && _map12->height == vH && i < _map12->length) {
+          // walk cached expansion
+          const uint16_t *px  = _map12->pixels + _map12->first[i];
+          const uint16_t *end = _map12->pixels + _map12->first[i+1];
+          if (uint32_t *pixels = spanPixels()) for (; px < end; px++) pixels[*px] = col; // same x + y * width layout as render buffer
+          else                                 for (; px < end; px++) setPixelColorXY(*px % vW, *px / vW, col);
+        } else {
+          expand1D2D(map1D2D, i, vW, vH, [&](int x, int y) { setPixelColorXY(x, y, col); });
         }
         break;
-      }
     }
     return;
   } else if (Segment::maxHeight!=1 && (width()==1 || height()==1)) {
@@ -820,6 +1202,16 @@ void IRAM_ATTR Segment::setPixelColor(int i, uint32_t col)
   }
 #endif
 
+  if (_pixels) { // render into segment buffer, strip is updated in flushPixels()
+    if ((unsigned)i < _pixelsLen) {
+#ifndef WLED_DISABLE_MODE_BLEND
+      if (_modeBlend) col = color_blend(_pixels[i], col, 0xFFFFU - progress(), true);
+#endif
+      _pixels[i] = col;
+    }
+    return;
+  }
+
   unsigned len = length();
   uint8_t _bri_t = currentBri();
   if (_bri_t < 255) {
@@ -921,40 +1313,27 @@ uint32_t IRAM_ATTR Segment::getPixelColor(int i)
         // use longest dimension
         return vW>vH ? getPixelColorXY(i, 0) : getPixelColorXY(0, i);
         break;
-      case M12_sPinwheel:
+      case M12_sPinwheel: {
         // not 100% accurate, returns pixel at outer edge
-        // i = angle --> 0 - 296  (Big), 0 - 192  (Medium), 0 - 72 (Small)
-        float centerX = roundf((vW-1) / 2.0f);
-        float centerY = roundf((vH-1) / 2.0f);
-        float angleRad = getPinwheelAngle(i, vW, vH); // angle in radians
-        float cosVal = cos_t(angleRad);
-        float sinVal = sin_t(angleRad);
-
-        int posx = (centerX + 0.5f * cosVal) * Fixed_Scale; // X starting position in fixed point 18 bit
-        int posy = (centerY + 0.5f * sinVal) * Fixed_Scale; // Y starting position in fixed point 18 bit
-        int inc_x = cosVal * Fixed_Scale; // X increment per step (fixed point) 10 bit
-        int inc_y = sinVal * Fixed_Scale; // Y increment per step (fixed point) 10 bit
-        int32_t maxX = vW * Fixed_Scale; // X edge in fixedpoint
-        int32_t maxY = vH * Fixed_Scale; // Y edge in fixedpoint
-
-        // trace ray from center until we hit any edge - to avoid rounding problems, we use the same method as in setPixelColor
+        if (_map12 && _map12->type == map1D2D && _map12->width == vW && _map12->height == vH && i < _map12->length) {
+          unsigned n = _map12->first[i+1];
+          if (n == _map12->first[i]) return 0; // ray does not cover any pixel
+          unsigned xy = _map12->pixels[n-1];
+          return getPixelColorXY(xy % vW, xy / vW);
+        }
         int x = INT_MIN;
         int y = INT_MIN;
-        while ((posx >= 0) && (posy >= 0) && (posx < maxX)  && (posy < maxY))  {
-          // scale down to integer (compiler will replace division with appropriate bitshift)
-          x = posx / Fixed_Scale;
-          y = posy / Fixed_Scale;
-          // advance to next position
-          posx += inc_x;
-          posy += inc_y;
-        }
+        expand1D2D(map1D2D, i, vW, vH, [&](int px, int py) { x = px; y = py; });
         return getPixelColorXY(x, y);
         break;
       }
+      }
     return 0;
   }
 #endif
 
+  if (_pixels) return (unsigned)i < _pixelsLen ? _pixels[i] : 0; // exact (not brightness reduced) value
+
   if (reverse) i = virtualLength() - i - 1;
   i *= groupLength();
   i += start;
@@ -1040,6 +1419,48 @@ void Segment::refreshLightCapabilities() {
   _capabilities = capabilities;
 }
 
+/*
+ * segments without buffer whose rows are unmodified runs of strip pixels (no grouping, spacing, offset,
+ * reverse, mirror or transpose) are read and written a run at a time, same result as going pixel by pixel
+ */
+int Segment::stripRow(unsigned y) const {
+  if (_pixels || groupLength() != 1 || offset || reverse || mirror) return -1;
+#ifndef WLED_DISABLE_MODE_BLEND
+  if (_modeBlend) return -1;
+#endif
+#ifndef WLED_DISABLE_2D
+  if (is2D()) return (reverse_y || mirror_y || transpose) ? -1 : (startY + y) * Segment::maxWidth + start;
+  if (height() != 1) return -1; // vertical 1D segment in matrix
+  if (Segment::maxHeight != 1 && start < Segment::maxWidth * Segment::maxHeight) return startY * Segment::maxWidth + start;
+#else
+  if (height() != 1) return -1;
+#endif
+  return start;
+}
+
+void Segment::setStripRun(unsigned first, uint32_t *c, unsigned n) {
+  uint8_t _bri_t = currentBri();
+  if (_bri_t < 255) fade_span(c, c, n, _bri_t);
+  strip.setPixelRange(first, n, c);
+}
+
+template<typename F> bool Segment::stripSpans(bool read, F op) {
+  if (stripRow(0) < 0) return false;
+  const unsigned cols = is2D() ? virtualWidth() : virtualLength();
+  const unsigned rows = is2D() ? virtualHeight() : 1;
+  uint32_t c[WLED_SEGMENT_SPAN_PIXELS];
+  for (unsigned y = 0; y < rows; y++) {
+    const unsigned first = stripRow(y);
+    for (unsigned x = 0; x < cols; x += WLED_SEGMENT_SPAN_PIXELS) {
+      const unsigned n = MIN(cols - x, (unsigned)WLED_SEGMENT_SPAN_PIXELS);
+      if (read) strip.getPixelRange(first + x, n, c);
+      op(c, n);
+      setStripRun(first + x, c, n);
+    }
+  }
+  return true;
+}
+
 /*
  * Fills segment with color
  */
@@ -1047,6 +1468,12 @@ void Segment::fill(uint32_t c) {
   if (!isActive()) return; // not active
   const int cols = is2D() ? virtualWidth() : virtualLength();
   const int rows = virtualHeight(); // will be 1 for 1D
+  if (uint32_t *pixels = spanPixels()) {
+    const unsigned len = MIN((unsigned)(cols * rows), _pixelsLen);
+    for (unsigned i = 0; i < len; i++) pixels[i] = c;
+    return;
+  }
+  if (stripSpans(false, [c](uint32_t *px, unsigned n) { for (unsigned i = 0; i < n; i++) px[i] = c; })) return;
   for (int y = 0; y < rows; y++) for (int x = 0; x < cols; x++) {
     if (is2D()) setPixelColorXY(x, y, c);
     else        setPixelColor(x, c);
@@ -1064,14 +1491,13 @@ void Segment::fade_out(uint8_t rate) {
   rate = (255-rate) >> 1;
   float mappedRate = float(rate) +1.1f;
 
-  uint32_t color = colors[1]; // SEGCOLOR(1); // target color
-  int w2 = W(color);
-  int r2 = R(color);
-  int g2 = G(color);
-  int b2 = B(color);
+  uint32_t target = colors[1]; // SEGCOLOR(1); // target color
+  int w2 = W(target);
+  int r2 = R(target);
+  int g2 = G(target);
+  int b2 = B(target);
 
-  for (int y = 0; y < rows; y++) for (int x = 0; x < cols; x++) {
-    color = is2D() ? getPixelColorXY(x, y) : getPixelColor(x);
+  auto fade = [=](uint32_t color) {
     int w1 = W(color);
     int r1 = R(color);
     int g1 = G(color);
@@ -1088,8 +1514,18 @@ void Segment::fade_out(uint8_t rate) {
     gdelta += (g2 == g1) ? 0 : (g2 > g1) ? 1 : -1;
     bdelta += (b2 == b1) ? 0 : (b2 > b1) ? 1 : -1;
 
-    if (is2D()) setPixelColorXY(x, y, r1 + rdelta, g1 + gdelta, b1 + bdelta, w1 + wdelta);
-    else        setPixelColor(x, r1 + rdelta, g1 + gdelta, b1 + bdelta, w1 + wdelta);
+    return RGBW32(r1 + rdelta, g1 + gdelta, b1 + bdelta, w1 + wdelta);
+  };
+
+  if (uint32_t *pixels = spanPixels()) {
+    const unsigned len = MIN((unsigned)(cols * rows), _pixelsLen);
+    for (unsigned i = 0; i < len; i++) pixels[i] = fade(pixels[i]);
+    return;
+  }
+  if (stripSpans(true, [&fade](uint32_t *px, unsigned n) { for (unsigned i = 0; i < n; i++) px[i] = fade(px[i]); })) return;
+  for (int y = 0; y < rows; y++) for (int x = 0; x < cols; x++) {
+    if (is2D()) setPixelColorXY(x, y, fade(getPixelColorXY(x, y)));
+    else        setPixelColor(x, fade(getPixelColor(x)));
   }
 }
 
@@ -1099,6 +1535,12 @@ void Segment::fadeToBlackBy(uint8_t fadeBy) {
   const int cols = is2D() ? virtualWidth() : virtualLength();
   const int rows = virtualHeight(); // will be 1 for 1D
 
+  if (uint32_t *pixels = spanPixels()) {
+    const unsigned len = MIN((unsigned)(cols * rows), _pixelsLen);
+    fade_span(pixels, pixels, len, 255-fadeBy);
+    return;
+  }
+  if (stripSpans(true, [fadeBy](uint32_t *px, unsigned n) { fade_span(px, px, n, 255-fadeBy); })) return;
   for (int y = 0; y < rows; y++) for (int x = 0; x < cols; x++) {
     if (is2D()) setPixelColorXY(x, y, color_fade(getPixelColorXY(x,y), 255-fadeBy));
     else        setPixelColor(x, color_fade(getPixelColor(x), 255-fadeBy));
@@ -1120,9 +1562,22 @@ void Segment::blur(uint8_t blur_amount, bool smear) {
     return;
   }
 #endif
+  unsigned vlength = virtualLength();
+  if (uint32_t *pixels = spanPixels()) {
+    blurPixels(pixels, MIN(vlength, _pixelsLen), 1, blur_amount, smear);
+    return;
+  }
+  // unchanged pixels are not written (and faded) again, so only without brightness reduction
+  const int first = stripRow(0);
+  if (first >= 0 && vlength <= WLED_SEGMENT_SPAN_PIXELS && currentBri() == 255) {
+    uint32_t px[WLED_SEGMENT_SPAN_PIXELS];
+    strip.getPixelRange(first, vlength, px);
+    blurPixels(px, vlength, 1, blur_amount, smear);
+    strip.setPixelRange(first, vlength, px);
+    return;
+  }
   uint8_t keep = smear ? 255 : 255 - blur_amount;
   uint8_t seep = blur_amount >> 1;
-  unsigned vlength = virtualLength();
   uint32_t carryover = BLACK;
   uint32_t lastnew;
   uint32_t last;
@@ -1147,6 +1602,30 @@ void Segment::blur(uint8_t blur_amount, bool smear) {
   setPixelColor(vlength - 1, curnew);
 }
 
+// same as blur() but operating in place on (strided) run of render buffer pixels
+// stride is 1 for a row (or 1D segment) and virtualWidth() for a column
+void Segment::blurPixels(uint32_t *pixels, unsigned len, unsigned stride, uint8_t blur_amount, bool smear) {
+  if (len == 0) return;
+  uint8_t keep = smear ? 255 : 255 - blur_amount;
+  uint8_t seep = blur_amount >> 1;
+  uint32_t carryover = BLACK;
+  uint32_t lastnew = BLACK;
+  uint32_t curnew = BLACK;
+  uint32_t *p = pixels;
+  for (unsigned i = 0; i < len; i++, p += stride) {
+    uint32_t cur = *p;
+    uint32_t part = color_fade(cur, seep);
+    curnew = color_fade(cur, keep);
+    if (i > 0) {
+      if (carryover) curnew = color_add(curnew, carryover, true);
+      *(p - stride) = color_add(lastnew, part, true);
+    }
+    lastnew = curnew;
+    carryover = part;
+  }
+  *(p - stride) = curnew; // last pixel
+}
+
 /*
  * Put a value 0 to 255 in to get a color value.
  * The colours are a transition r -> g -> b -> back to r
@@ -1177,7 +1656,8 @@ uint32_t Segment::color_wheel(uint8_t pos) {
  * @returns Single color from palette
  */
 uint32_t Segment::color_from_palette(uint16_t i, bool mapping, bool wrap, uint8_t mcol, uint8_t pbri) {
-  uint32_t color = gamma32(currentColor(mcol));
+  // colors of segment being rendered are already gamma corrected once per frame (SEGCOLOR())
+  uint32_t color = (mcol < NUM_COLORS && strip.isServicing() && this == &SEGMENT) ? strip.segColor(mcol) : gamma32(currentColor(mcol));
 
   // default palette or no RGB support on segment
   if ((palette == 0 && mcol < NUM_COLORS) || !_isRGB) return (pbri == 255) ? color : color_fade(color, pbri, true);
@@ -1186,6 +1666,16 @@ uint32_t Segment::color_from_palette(uint16_t i, bool mapping, bool wrap, uint8_
   if (mapping && virtualLength() > 1) paletteIndex = (i*255)/(virtualLength() -1);
   // paletteBlend: 0 - wrap when moving, 1 - always wrap, 2 - never wrap, 3 - none (undefined)
   if (!wrap && strip.paletteBlend != 3) paletteIndex = scale8(paletteIndex, 240); //cut off blend at palette "end"
+  if (pbri == 255 && _currentLUT) {
+    if (!_currentLUT->built) {
+      for (unsigned k = 0; k < 256; k++) {
+        CRGB c = ColorFromPalette(_currentLUT->pal, k, 255, (TBlendType)_currentLUT->blendType);
+        _currentLUT->color[k] = RGBW32(c.r, c.g, c.b, 0);
+      }
+      _currentLUT->built = true;
+    }
+    return _currentLUT->color[paletteIndex & 0xFF] | (color & 0xFF000000);
+  }
   CRGB fastled_col = ColorFromPalette(_currentPalette, paletteIndex, pbri, (strip.paletteBlend == 3)? NOBLEND:LINEARBLEND); // NOTE: paletteBlend should be global
 
   return RGBW32(fastled_col.r, fastled_col.g, fastled_col.b, W(color));
@@ -1198,11 +1688,16 @@ uint32_t Segment::color_from_palette(uint16_t i, bool mapping, bool wrap, uint8_
 
 //do not call this method from system context (network callback)
 void WS2812FX::finalizeInit(void) {
+#ifdef WLED_ENABLE_PIPELINE
+  stopPipeline(); // frame buffers depend on strip length, restarted by next service()
+  _pipelineChecked = false;
+#endif
   //reset segment runtimes
   for (segment &seg : _segments) {
     seg.markForReset();
     seg.resetIfRequired();
   }
+  repaintUnchanged(); // buses are re-created and start blank
 
   // for the lack of better place enumerate ledmaps here
   // if we do it in json.cpp (serializeInfo()) we are getting flashes on LEDs
@@ -1272,97 +1767,427 @@ void WS2812FX::finalizeInit(void) {
   deserializeMap();     // (re)load default ledmap (will also setUpMatrix() if ledmap does not exist)
 }
 
+#ifndef WLED_DISABLE_PROFILER
+// runtime profiler, statistics are kept in RAM only and served at /json/perf
+static struct {
+  WS2812FX::perf_stat_t seg[MAX_NUM_SEGMENTS];
+  uint32_t usService, usServiceMax; // segment rendering (effects, buffer flush) per frame
+  uint32_t usShow, usShowMax;       // sending frame to buses
+} perf;
+
+static void profileSegment(unsigned n, uint8_t mode, uint32_t us, uint32_t usTrans) {
+  if (n >= MAX_NUM_SEGMENTS) return;
+  WS2812FX::perf_stat_t &p = perf.seg[n];
+  if (p.frames == 0 || p.mode != mode) { // new effect, restart statistics
+    memset(&p, 0, sizeof(p));
+    p.usMin = UINT32_MAX;
+    p.mode  = mode;
+  }
+  if (p.frames >= 1024) { p.usSum >>= 1; p.usTrans >>= 1; p.frames >>= 1; } // average follows recent frames
+  p.usSum   += us;
+  p.usTrans += usTrans;
+  p.frames++;
+  if (us < p.usMin) p.usMin = us;
+  if (us > p.usMax) p.usMax = us;
+}
+
+const WS2812FX::perf_stat_t* WS2812FX::getPerfStats(uint8_t seg) {
+  if (seg >= MAX_NUM_SEGMENTS || perf.seg[seg].frames == 0) return nullptr;
+  return &perf.seg[seg];
+}
+
+uint32_t WS2812FX::getServiceTime(bool peak) { return peak ? perf.usServiceMax : perf.usService; }
+uint32_t WS2812FX::getShowTime(bool peak)    { return peak ? perf.usShowMax    : perf.usShow;    }
+#endif
+
 void WS2812FX::service() {
   unsigned long nowUp = millis(); // Be aware, millis() rolls over every 49 days
+#ifdef WLED_ENABLE_PIPELINE
+  if (!_pipelineChecked) { _pipelineChecked = true; startPipeline(); } // (re)start after finalizeInit() and initial segment setup
+  if (_handoff) {
+    _outputTime = nowUp;
+    // segment reset may end image playback (file system access, freeing memory) so it is done here instead of render task
+    for (const segment &seg : _segments) if (seg.reset) {
+      bool paused = pauseRendering();
+      for (segment &s : _segments) s.resetIfRequired();
+      if (paused) resume();
+      break;
+    }
+    showPipelineFrame();
+    return;
+  }
+#endif
   now = nowUp + timebase;
-  if (nowUp - _lastShow < MIN_SHOW_DELAY || _suspend) return;
+  if ((nowUp - _lastShow < MIN_SHOW_DELAY && !_deferred) || _suspend) return;
+
+  bool doShow = renderSegments(nowUp);
+
+  #ifdef WLED_DEBUG
+  if (millis() - nowUp > _frametime) DEBUG_PRINTF_P(PSTR("Slow effects %u/%d.\n"), (unsigned)(millis()-nowUp), (int)_frametime);
+  #endif
+  if (doShow) {
+    yield();
+    Segment::handleRandomPalette(); // slowly transition random palette; move it into for loop when each segment has individual random palette
+    if (holdPending()) holdPendingBuses();
+    show();
+  }
+  #ifdef WLED_DEBUG
+  if (millis() - nowUp > _frametime) DEBUG_PRINTF_P(PSTR("Slow strip %u/%d.\n"), (unsigned)(millis()-nowUp), (int)_frametime);
+  #endif
+}
+
+bool WS2812FX::renderSegments(unsigned long nowUp) {
   bool doShow = false;
 
   _isServicing = true;
   _segment_index = 0;
+#ifndef WLED_DISABLE_PROFILER
+  if (_perfReset) {
+    memset(&perf, 0, sizeof(perf));
+    Segment::resetAllocStats();
+    BusManager::resetShowTimes();
+    _perfReset = false;
+  }
+  unsigned long usService = micros();
+#endif
 
-  for (segment &seg : _segments) {
-    if (_suspend) return; // immediately stop processing segments if suspend requested during service()
-
+  // Solid segments are only repainted when their output can change; not possible if something else may paint over them
+  // (realtime data, overlays, TM1814 type buses that need periodic refresh)
+  const bool skipUnchanged = staticSkipEnabled(realtimeMode != REALTIME_MODE_INACTIVE, isOffRefreshRequired(), overlayCurrent, usermods.getModCount());
+  std::bitset<MAX_NUM_SEGMENTS> rendered; // bitmask of segments that rendered this frame (flushPixels() is only needed for those)
+  std::bitset<MAX_NUM_SEGMENTS> queuedMask;
+  std::bitset<MAX_NUM_SEGMENTS> unchangedMask;
+  uint32_t staticSig[MAX_NUM_SEGMENTS];
+  uint8_t  queue[MAX_NUM_SEGMENTS]; // due segments, earliest deadline first
+  unsigned queued = 0;
+  uint16_t minFrametime = _frametime;
+
+  // collect segments that are due
+  for (unsigned i = 0; i < _segments.size() && i < MAX_NUM_SEGMENTS; i++) {
+    segment &seg = _segments[i];
+    if (_suspend) { _isServicing = false; return false; } // immediately stop processing segments if suspend requested during service()
+
+    staticSig[i] = 0;
     // process transition (mode changes in the middle of transition)
     seg.handleTransition();
+#ifdef WLED_ENABLE_PIPELINE
+    if (seg.reset && xTaskGetCurrentTaskHandle() == _renderTask) continue; // reset by service() in loop(), render once it is done
+#endif
     // reset the segment runtime data if needed
     seg.resetIfRequired();
 
     if (!seg.isActive()) continue;
+    if (!useSegmentBuffer && seg.hasPixelBuffer()) seg.deallocatePixels();
+    if (seg.fps) minFrametime = MIN(minFrametime, 1000 / seg.fps);
+
+    bool unchanged = false;
+    if (skipUnchanged && staticSkipCandidate(seg.mode == FX_MODE_STATIC, seg.freeze, seg.isInTransition())) {
+      staticSig[i] = seg.staticSignature();
+      // segment buffer still holds last frame; without it strip pixels must not be overwritten by other segments
+      bool overlapped = false;
+      if (!useSegmentBuffer) for (const segment &other : _segments) if (&other != &seg && other.isActive() && other.overlaps(seg)) { overlapped = true; break; }
+      StaticState state = seg.getStaticState(staticSig[i], useSegmentBuffer, overlapped);
+      if (state == STATIC_CHANGED) seg.next_time = 0; // repaint changed Solid segment immediately
+      unchanged = state == STATIC_UNCHANGED;
+    } else seg.setStaticSignature(0);
+
+    if (_triggered) queue[queued++] = i; // everything is rendered in segment order
+    else if (unchanged) {
+      unchangedMask.set(i);
+      if (nowUp > seg.next_time) {
+        doShow = true;                 // nothing to render, but keep regular show() so network buses are still refreshed
+        seg.next_time = nowUp + 350;   // same as mode_static()
+      }
+      continue;
+    } else if (nowUp > seg.next_time) {
+      unsigned q = queued++;
+      for (; q > 0 && _segments[queue[q-1]].next_time > seg.next_time; q--) queue[q] = queue[q-1];
+      queue[q] = i;
+    } else continue;
+    queuedMask.set(i);
+  }
+  _minFrametime = minFrametime;
+
+  // ensures all solid segments are updated at the same time
+  if (queued && !_triggered) for (unsigned i = 0; i < _segments.size() && i < MAX_NUM_SEGMENTS; i++) {
+    if (queuedMask[i] || unchangedMask[i]) continue;
+    if (_segments[i].isActive() && _segments[i].mode == FX_MODE_STATIC && !_segments[i].reset) queue[queued++] = i;
+  }
+
+  _deferred = false;
+  _pendingSegments.reset();
+  for (unsigned q = 0; q < queued; q++) {
+    if (_suspend) { _isServicing = false; return false; }
+    // once a frame of the fastest segment is used up leave remaining segments for next call (they keep their deadline)
+    if (q > 0 && !_triggered && millis() - nowUp >= _minFrametime) {
+      _deferred = true;
+      for (; q < queued; q++) _pendingSegments.set(queue[q]);
+      break;
+    }
 
-    // last condition ensures all solid segments are updated at the same time
-    if (nowUp > seg.next_time || _triggered || (doShow && seg.mode == FX_MODE_STATIC))
-    {
-      doShow = true;
-      unsigned delay = FRAMETIME;
-
-      if (!seg.freeze) { //only run effect function if not frozen
-        int oldCCT = BusManager::getSegmentCCT(); // store original CCT value (actually it is not Segment based)
-        _virtualSegmentLength = seg.virtualLength(); //SEGLEN
-        _colors_t[0] = gamma32(seg.currentColor(0));
-        _colors_t[1] = gamma32(seg.currentColor(1));
-        _colors_t[2] = gamma32(seg.currentColor(2));
-        seg.setCurrentPalette();              // load actual palette
-        // when correctWB is true we need to correct/adjust RGB value according to desired CCT value, but it will also affect actual WW/CW ratio
-        // when cctFromRgb is true we implicitly calculate WW and CW from RGB values
-        if (cctFromRgb) BusManager::setSegmentCCT(-1);
-        else            BusManager::setSegmentCCT(seg.currentBri(true), correctWB);
-        // Effect blending
-        // When two effects are being blended, each may have different segment data, this
-        // data needs to be saved first and then restored before running previous mode.
-        // The blending will largely depend on the effect behaviour since actual output (LEDs) may be
-        // overwritten by later effect. To enable seamless blending for every effect, additional LED buffer
-        // would need to be allocated for each effect and then blended together for each pixel.
-        [[maybe_unused]] uint8_t tmpMode = seg.currentMode();  // this will return old mode while in transition
-        delay = (*_mode[seg.mode])();         // run new/current mode
+    _segment_index = queue[q];
+    segment &seg = _segments[_segment_index];
+    _segFrametime = seg.fps ? 1000 / seg.fps : _frametime; // FRAMETIME returned by effects follows segment frame rate
+    doShow = true;
+    unsigned delay = FRAMETIME;
+
+    if (!seg.freeze) { //only run effect function if not frozen
+#ifndef WLED_DISABLE_PROFILER
+      unsigned long usStart = micros();
+      uint32_t usTrans = 0;
+#endif
+      int oldCCT = BusManager::getSegmentCCT(); // store original CCT value (actually it is not Segment based)
+      _virtualSegmentLength = seg.virtualLength(); //SEGLEN
+      _colors_t[0] = gamma32(seg.currentColor(0));
+      _colors_t[1] = gamma32(seg.currentColor(1));
+      _colors_t[2] = gamma32(seg.currentColor(2));
+      seg.setCurrentPalette();              // load actual palette
+      // when correctWB is true we need to correct/adjust RGB value according to desired CCT value, but it will also affect actual WW/CW ratio
+      // when cctFromRgb is true we implicitly calculate WW and CW from RGB values
+      if (cctFromRgb) BusManager::setSegmentCCT(-1);
+      else            BusManager::setSegmentCCT(seg.currentBri(true), correctWB);
+      if (useSegmentBuffer) seg.allocatePixels(); // effect will render into segment buffer (if allocation succeeds)
+      seg.updateMap1D2D();                  // rebuild 1D to 2D expansion if segment geometry changed
+      // Effect blending
+      // When two effects are being blended, each may have different segment data, this
+      // data needs to be saved first and then restored before running previous mode.
+      // With segment buffer each effect renders into its own LED buffer and both are blended together
+      // for each pixel in flushPixels(). Otherwise the blending will largely depend on the effect behaviour
+      // since actual output (LEDs) is read back and may be overwritten by later effect.
+      [[maybe_unused]] uint8_t tmpMode = seg.currentMode();  // this will return old mode while in transition
+      [[maybe_unused]] bool blendBuffers = false;
 #ifndef WLED_DISABLE_MODE_BLEND
-        if (modeBlending && seg.mode != tmpMode) {
-          Segment::tmpsegd_t _tmpSegData;
-          Segment::modeBlend(true);           // set semaphore
-          seg.swapSegenv(_tmpSegData);        // temporarily store new mode state (and swap it with transitional state)
-          _virtualSegmentLength = seg.virtualLength(); // update SEGLEN (mapping may have changed)
-          unsigned d2 = (*_mode[tmpMode])();  // run old mode
-          seg.restoreSegenv(_tmpSegData);     // restore mode state (will also update transitional state)
-          delay = MIN(delay,d2);              // use shortest delay
-          Segment::modeBlend(false);          // unset semaphore
-        }
+      if (modeBlending && seg.mode != tmpMode) blendBuffers = seg.allocateBlendPixels(); // before new mode overwrites last frame
+#endif
+      delay = (*_mode[seg.mode])();         // run new/current mode
+#ifndef WLED_DISABLE_MODE_BLEND
+      if (modeBlending && seg.mode != tmpMode) {
+        Segment::tmpsegd_t _tmpSegData;
+        if (blendBuffers) seg.swapBlendPixels(); // old mode renders into its own buffer
+        else Segment::modeBlend(true);      // set semaphore
+        seg.swapSegenv(_tmpSegData);        // temporarily store new mode state (and swap it with transitional state)
+        _virtualSegmentLength = seg.virtualLength(); // update SEGLEN (mapping may have changed)
+#ifndef WLED_DISABLE_PROFILER
+        unsigned long usOld = micros();
+#endif
+        unsigned d2 = (*_mode[tmpMode])();  // run old mode
+#ifndef WLED_DISABLE_PROFILER
+        usTrans = micros() - usOld;
 #endif
-        seg.call++;
-        if (seg.isInTransition() && delay > FRAMETIME) delay = FRAMETIME; // force faster updates during transition
-        BusManager::setSegmentCCT(oldCCT); // restore old CCT for ABL adjustments
+        seg.restoreSegenv(_tmpSegData);     // restore mode state (will also update transitional state)
+        if (blendBuffers) seg.swapBlendPixels();
+        delay = MIN(delay,d2);              // use shortest delay
+        Segment::modeBlend(false);          // unset semaphore
       }
-
-      seg.next_time = nowUp + delay;
+#endif
+      seg.call++;
+      if (seg.isInTransition() && delay > FRAMETIME) delay = FRAMETIME; // force faster updates during transition
+      if (seg.fps && delay < FRAMETIME) delay = FRAMETIME; // segment frame rate is an upper limit
+      BusManager::setSegmentCCT(oldCCT); // restore old CCT for ABL adjustments
+#ifndef WLED_DISABLE_PROFILER
+      profileSegment(_segment_index, seg.mode, micros() - usStart, usTrans);
+#endif
     }
-    _segment_index++;
+
+    seg.next_time = nowUp + delay;
+    seg.setStaticSignature(staticSig[_segment_index]);
+    rendered.set(_segment_index);
   }
+  _segFrametime = _frametime;
   _virtualSegmentLength = 0;
+
+  // composite segment buffers into bus buffers (in segment order so upper segments overwrite lower ones)
+  if (doShow && useSegmentBuffer) {
+    int oldCCT = BusManager::getSegmentCCT();
+    std::bitset<MAX_NUM_SEGMENTS> flushed;
+    for (unsigned i = 0; i < _segments.size() && i < MAX_NUM_SEGMENTS; i++) {
+      segment &seg = _segments[i];
+      if (!seg.hasPixelBuffer()) continue;
+      // strip still holds pixels of a segment that did not render, unless a lower segment was flushed over it
+      bool needsFlush = rendered[i];
+      for (unsigned j = 0; !needsFlush && j < i; j++) needsFlush = flushed[j] && _segments[j].overlaps(seg);
+      if (!needsFlush) continue;
+      flushed.set(i);
+      if (cctFromRgb) BusManager::setSegmentCCT(-1);
+      else            BusManager::setSegmentCCT(seg.currentBri(true), correctWB);
+      seg.flushPixels();
+    }
+    BusManager::setSegmentCCT(oldCCT);
+  }
   _isServicing = false;
   _triggered = false;
-
-  #ifdef WLED_DEBUG
-  if (millis() - nowUp > _frametime) DEBUG_PRINTF_P(PSTR("Slow effects %u/%d.\n"), (unsigned)(millis()-nowUp), (int)_frametime);
-  #endif
+#ifndef WLED_DISABLE_PROFILER
   if (doShow) {
-    yield();
-    Segment::handleRandomPalette(); // slowly transition random palette; move it into for loop when each segment has individual random palette
-    show();
+    uint32_t us = micros() - usService;
+    perf.usService = (7 * perf.usService + us + 4) >> 3;
+    if (us > perf.usServiceMax) perf.usServiceMax = us;
   }
-  #ifdef WLED_DEBUG
-  if (millis() - nowUp > _frametime) DEBUG_PRINTF_P(PSTR("Slow strip %u/%d.\n"), (unsigned)(millis()-nowUp), (int)_frametime);
-  #endif
+#endif
+  return doShow;
+}
+
+// a bus also showing a deferred segment would show it one frame behind the others (or, without segment buffer, partly
+// overwritten) so it waits for the next pass; only once in a row so buses are not starved when rendering cannot keep up
+bool WS2812FX::holdPending() {
+  if (_pendingSegments.none() || _held) { _held = false; return false; }
+  _held = true;
+  return true;
+}
+
+void WS2812FX::holdPendingBuses() {
+  if (customMappingSize) { BusManager::holdRange(0, _length); return; } // segment pixels are spread over buses by ledmap
+  for (unsigned i = 0; i < _segments.size() && i < MAX_NUM_SEGMENTS; i++) {
+    if (!_pendingSegments[i]) continue;
+    const segment &seg = _segments[i];
+    unsigned first = seg.start, last = seg.stop;
+#ifndef WLED_DISABLE_2D
+    if (seg.is2D()) { first += seg.startY * Segment::maxWidth; last += (seg.stopY - 1) * Segment::maxWidth; }
+#endif
+    BusManager::holdRange(first, last - first);
+  }
+}
+
+#ifdef WLED_ENABLE_PIPELINE
+// render task: renders frames into back buffer and hands them to service() (running on the other core in loop())
+void WS2812FX::renderTask(void *parameter) {
+  WS2812FX *fx = static_cast<WS2812FX*>(parameter);
+  unsigned long lastRender = 0;
+  for (;;) {
+    vTaskDelay(1); // let idle task run (task watchdog) and do not spin
+    unsigned long nowUp = millis();
+    // loop() stopped calling service() (realtime, lights off, ...)
+    if (nowUp - fx->_outputTime > 100) continue;
+    if (realtimeMode && !realtimeOverride && !useMainSegmentOnly) continue; // realtime data goes straight to buses
+    fx->_rendering = true; // before checking _suspend (see suspend())
+    if (fx->_suspend || (nowUp - lastRender < fx->getMinShowDelay() && !fx->_deferred)) { fx->_rendering = false; continue; }
+    fx->now = nowUp + timebase;
+    fx->_renderingToBuffer = true;
+    // frame with deferred segments is completed by next pass before it is shown (whole strip is shown at once)
+    if (fx->renderSegments(nowUp) && !fx->holdPending()) {
+      Segment::handleRandomPalette();
+      show_callback callback = fx->_callback; // overlays draw into frame
+      if (callback) callback();
+      const uint32_t *frame = fx->_frameBuffer;
+      fx->_frameBuffer = fx->_handoff->publish();
+      memcpy(fx->_frameBuffer, frame, fx->_length * sizeof(uint32_t)); // next frame starts from this one (effects read back pixels)
+      lastRender = nowUp;
+    }
+    fx->_renderingToBuffer = false;
+    fx->_rendering = false;
+  }
+}
+
+bool WS2812FX::startPipeline() {
+  if (_handoff) return true;
+  if (_length == 0 || correctWB) return false;
+  // CCT is applied per segment when pixels are written to buses, frame only holds RGBW
+  for (unsigned i = 0; i < BusManager::getNumBusses(); i++) if (BusManager::getBus(i)->hasCCT()) return false;
+  uint32_t *frames = (uint32_t*)calloc(3 * _length, sizeof(uint32_t)); // do not use slow PSRAM
+  if (!frames) return false;
+  _handoff = new FrameHandoff<uint32_t>(frames, frames + _length, frames + 2 * _length);
+  _frameBuffer = _handoff->back();
+  for (unsigned i = 0; i < _length; i++) _frameBuffer[i] = BusManager::getPixelColor(i); // start from what is shown
+  _outputTime = millis();
+  // render on the core loop() is not running on
+  if (xTaskCreatePinnedToCore(renderTask, "render", 8192, this, 1, &_renderTask, xPortGetCoreID() ? 0 : 1) != pdPASS) {
+    _renderTask = nullptr;
+    stopPipeline();
+    return false;
+  }
+  DEBUG_PRINTF_P(PSTR("Render pipeline started on core %d.\n"), xPortGetCoreID() ? 0 : 1);
+  return true;
+}
+
+void WS2812FX::stopPipeline() {
+  if (!_handoff) return;
+  if (_renderTask) {
+    bool wasSuspended = _suspend;
+    suspend(); // waits for render task to leave renderSegments()
+    vTaskDelete(_renderTask);
+    _renderTask = nullptr;
+    _suspend = wasSuspended;
+  }
+  _frameBuffer = nullptr;
+  free(_handoff->buffer(0)); // all three frames are a single allocation
+  delete _handoff;
+  _handoff = nullptr;
+}
+
+void WS2812FX::suspend() {
+  _suspend = true;
+  if (!_renderTask || xTaskGetCurrentTaskHandle() == _renderTask) return;
+  while (_rendering) delay(1);
 }
 
+bool WS2812FX::pauseRendering() {
+  if (!_renderTask || _suspend || xTaskGetCurrentTaskHandle() == _renderTask) return false; // already safe
+  suspend();
+  return true;
+}
+
+// called from service(): writes newest complete frame to buses and shows it
+void WS2812FX::showPipelineFrame() {
+  if (!_handoff->acquire()) return;
+  BusManager::setPixelRange(0, _length, _handoff->front());
+  showBuses(); // overlays were drawn by render task
+}
+#endif
+
 void IRAM_ATTR WS2812FX::setPixelColor(unsigned i, uint32_t col) {
   i = getMappedPixelIndex(i);
   if (i >= _length) return;
+#ifdef WLED_ENABLE_FX_BENCHMARK
+  if (_captureBus) { _captureBus->setPixelColor(i, col); return; }
+#endif
+#ifdef WLED_ENABLE_PIPELINE
+  if (_renderingToBuffer) { _frameBuffer[i] = col; return; }
+#endif
   BusManager::setPixelColor(i, col);
 }
 
+// writes consecutive logical pixels in as few bus runs as ledmap allows (used by realtime receivers)
+void WS2812FX::setPixelRange(unsigned n, unsigned len, const uint32_t *c) {
+  const unsigned total = getLengthTotal(); // logical space (may exceed _length for 2D matrix with gaps)
+  if (n >= total) return;
+  if (n + len > total) len = total - n;
+#ifdef WLED_ENABLE_FX_BENCHMARK
+  if (_captureBus) {
+    if (customMappingSize) for (unsigned i = 0; i < len; i++) setPixelColor(n + i, c[i]);
+    else if (n < _length)  _captureBus->setPixelRange(n, min(len, _length - n), c);
+    return;
+  }
+#endif
+#ifdef WLED_ENABLE_PIPELINE
+  if (_renderingToBuffer) { for (unsigned i = 0; i < len; i++) setPixelColor(n + i, c[i]); return; }
+#endif
+  if (!customMappingSize || (realtimeMode != REALTIME_MODE_INACTIVE && !realtimeRespectLedMaps)) {
+    if (n < _length) BusManager::setPixelRange(n, min(len, _length - n), c);
+    return;
+  }
+  // ledmap active: split into runs of consecutive physical pixels
+  unsigned i = 0;
+  while (i < len) {
+    unsigned first = getMappedPixelIndex(n + i);
+    unsigned run = 1;
+    while (i + run < len && getMappedPixelIndex(n + i + run) == first + run) run++;
+    if (first < _length) BusManager::setPixelRange(first, min(run, _length - first), c + i);
+    i += run;
+  }
+}
+
+void WS2812FX::getPixelRange(unsigned n, unsigned len, uint32_t *c) {
+  for (unsigned i = 0; i < len; i++) c[i] = getPixelColor(n + i);
+}
+
 uint32_t IRAM_ATTR WS2812FX::getPixelColor(uint16_t i) {
   i = getMappedPixelIndex(i);
   if (i >= _length) return 0;
+#ifdef WLED_ENABLE_FX_BENCHMARK
+  if (_captureBus) return _captureBus->getPixelColor(i);
+#endif
+#ifdef WLED_ENABLE_PIPELINE
+  if (_renderingToBuffer) return _frameBuffer[i];
+#endif
   return BusManager::getPixelColor(i);
 }
 
@@ -1370,11 +2195,22 @@ void WS2812FX::show(void) {
   // avoid race condition, capture _callback value
   show_callback callback = _callback;
   if (callback) callback();
+  showBuses();
+}
 
+void WS2812FX::showBuses(void) {
+#ifndef WLED_DISABLE_PROFILER
+  unsigned long usStart = micros();
+#endif
   // some buses send asynchronously and this method will return before
   // all of the data has been sent.
   // See https://github.com/Makuna/NeoPixelBus/wiki/ESP32-NeoMethods#neoesp32rmt-methods
   BusManager::show();
+#ifndef WLED_DISABLE_PROFILER
+  uint32_t us = micros() - usStart;
+  perf.usShow = (7 * perf.usShow + us + 4) >> 3;
+  if (us > perf.usShowMax) perf.usShowMax = us;
+#endif
 
   unsigned long showNow = millis();
   size_t diff = showNow - _lastShow;
@@ -1404,6 +2240,7 @@ uint16_t WS2812FX::getFps() {
 void WS2812FX::setTargetFps(uint8_t fps) {
   if (fps > 0 && fps <= 120) _targetFps = fps;
   _frametime = 1000 / _targetFps;
+  _minFrametime = _segFrametime = _frametime;
 }
 
 void WS2812FX::setMode(uint8_t segid, uint8_t m) {
@@ -1538,6 +2375,7 @@ void WS2812FX::purgeSegments() {
   // remove all inactive segments (from the back)
   int deleted = 0;
   if (_segments.size() <= 1) return;
+  RenderLock lock;
   for (size_t i = _segments.size()-1; i > 0; i--)
     if (_segments[i].stop == 0) {
       deleted++;
@@ -1553,20 +2391,34 @@ Segment& WS2812FX::getSegment(uint8_t id) {
   return _segments[id >= _segments.size() ? getMainSegmentId() : id]; // vectors
 }
 
+void WS2812FX::appendSegment(const Segment &seg) {
+  if (_segments.size() >= getMaxSegments()) return;
+  RenderLock lock; // vector may be reallocated
+  _segments.push_back(seg);
+}
+
+void WS2812FX::setTransitionMode(bool t) {
+  RenderLock lock;
+  for (Segment &seg : _segments) seg.startTransition(t ? _transitionDur : 0);
+}
+
 // sets new segment bounds, queues if that segment is currently running
 void WS2812FX::setSegment(uint8_t segId, uint16_t i1, uint16_t i2, uint8_t grouping, uint8_t spacing, uint16_t offset, uint16_t startY, uint16_t stopY) {
+  RenderLock lock; // segment list may change
   if (segId >= getSegmentsNum()) {
     if (i2 <= i1) return; // do not append empty/inactive segments
     appendSegment(Segment(0, strip.getLengthTotal()));
     segId = getSegmentsNum()-1; // segments are added at the end of list
   }
+  const bool wasSuspended = _suspend; // do not resume if caller suspended strip
   suspend();
   _segments[segId].setUp(i1, i2, grouping, spacing, offset, startY, stopY);
-  resume();
+  if (!wasSuspended) resume();
   if (segId > 0 && segId == getSegmentsNum()-1 && i2 <= i1) _segments.pop_back(); // if last segment was deleted remove it from vector
 }
 
 void WS2812FX::resetSegments() {
+  RenderLock lock;
   _segments.clear(); // destructs all Segment as part of clearing
   #ifndef WLED_DISABLE_2D
   segment seg = isMatrix ? Segment(0, Segment::maxWidth, 0, Segment::maxHeight) : Segment(0, _length);
@@ -1579,6 +2431,7 @@ void WS2812FX::resetSegments() {
 }
 
 void WS2812FX::makeAutoSegments(bool forceReset) {
+  RenderLock lock;
   if (autoSegments) { //make one segment per bus
     unsigned segStarts[MAX_NUM_SEGMENTS] = {0};
     unsigned segStops [MAX_NUM_SEGMENTS] = {0};
@@ -1655,6 +2508,7 @@ void WS2812FX::makeAutoSegments(bool forceReset) {
 }
 
 void WS2812FX::fixInvalidSegments() {
+  RenderLock lock;
   //make sure no segment is longer than total (sanity check)
   for (size_t i = getSegmentsNum()-1; i > 0; i--) {
     if (isMatrix) {
@@ -1775,6 +2629,7 @@ bool WS2812FX::deserializeMap(uint8_t n) {
 
   customMappingSize = 0; // prevent use of mapping if anything goes wrong
   currentLedmap = 0;
+  trigger(); // physical layout changes, repaint all segments (including unchanged Solid ones)
   if (n == 0 || isFile) interfaceUpdateCallMode = CALL_MODE_WS_SEND; // schedule WS update (to inform UI)
 
   if (!isFile && n==0 && isMatrix) {
@@ -108,6 +108,8 @@ BusDigital::BusDigital(BusConfig &bc, uint8_t nr, const ColorOrderMap &com)
 , _milliAmpsPerLed(bc.milliAmpsPerLed)
 , _milliAmpsMax(bc.milliAmpsMax)
 , _colorOrderMap(com)
+, _colorSum(0)
+, _colorOrderRunsVersion(0)
 {
   if (!IS_DIGITAL(bc.type) || !bc.count) return;
   if (!pinManager.allocatePin(bc.pins[0], true, PinOwner::BusDigital)) return;
@@ -170,8 +172,8 @@ uint8_t BusDigital::estimateCurrentAndLimitBri() {
     powerBudget = 0;
   }
 
-  uint32_t busPowerSum = 0;
-  for (unsigned i = 0; i < getLength(); i++) {  //sum up the usage of each LED
+  uint32_t busPowerSum = _colorSum; // maintained by setPixelColor() if buffering
+  if (!_data) for (unsigned i = 0; i < getLength(); i++) {  //sum up the usage of each LED
     uint32_t c = getPixelColor(i); // always returns original or restored color without brightness scaling
     byte r = R(c), g = G(c), b = B(c), w = W(c);
 
@@ -213,31 +215,36 @@ void BusDigital::show() {
   if (_data) {
     size_t channels = getNumberOfChannels();
     int16_t oldCCT = Bus::_cct; // temporarily save bus CCT
-    for (size_t i=0; i<_len; i++) {
-      size_t offset = i * channels;
-      unsigned co = _colorOrderMap.getPixelColorOrder(i+_start, _colorOrder);
-      uint32_t c;
-      if (_type == TYPE_WS2812_1CH_X3) { // map to correct IC, each controls 3 LEDs (_len is always a multiple of 3)
-        switch (i%3) {
-          case 0: c = RGBW32(_data[offset]  , _data[offset+1], _data[offset+2], 0); break;
-          case 1: c = RGBW32(_data[offset-1], _data[offset]  , _data[offset+1], 0); break;
-          case 2: c = RGBW32(_data[offset-2], _data[offset-1], _data[offset]  , 0); break;
+    pixel_setter_t setPixel = PolyBus::getPixelSetter(_iType); // resolve bus type once instead of for every pixel
+    if (_colorOrderRuns.empty() || _colorOrderRunsVersion != BusManager::getColorOrderMapVersion()) buildColorOrderRuns();
+    if (setPixel) for (const ColorOrderMapEntry &run : _colorOrderRuns) {
+      const unsigned co = run.colorOrder;
+      const size_t end = run.start + run.len;
+      for (size_t i=run.start; i<end; i++) {
+        size_t offset = i * channels;
+        uint32_t c;
+        if (_type == TYPE_WS2812_1CH_X3) { // map to correct IC, each controls 3 LEDs (_len is always a multiple of 3)
+          switch (i%3) {
+            case 0: c = RGBW32(_data[offset]  , _data[offset+1], _data[offset+2], 0); break;
+            case 1: c = RGBW32(_data[offset-1], _data[offset]  , _data[offset+1], 0); break;
+            case 2: c = RGBW32(_data[offset-2], _data[offset-1], _data[offset]  , 0); break;
+          }
+        } else {
+          if (hasRGB()) c = RGBW32(_data[offset], _data[offset+1], _data[offset+2], hasWhite() ? _data[offset+3] : 0);
+          else          c = RGBW32(0, 0, 0, _data[offset]);
         }
-      } else {
-        if (hasRGB()) c = RGBW32(_data[offset], _data[offset+1], _data[offset+2], hasWhite() ? _data[offset+3] : 0);
-        else          c = RGBW32(0, 0, 0, _data[offset]);
-      }
-      if (hasCCT()) {
-        // unfortunately as a segment may span multiple buses or a bus may contain multiple segments and each segment may have different CCT
-        // we need to extract and appy CCT value for each pixel individually even though all buses share the same _cct variable
-        // TODO: there is an issue if CCT is calculated from RGB value (_cct==-1), we cannot do that with double buffer
-        Bus::_cct = _data[offset+channels-1];
-        Bus::calculateCCT(c, cctWW, cctCW);
+        if (hasCCT()) {
+          // unfortunately as a segment may span multiple buses or a bus may contain multiple segments and each segment may have different CCT
+          // we need to extract and appy CCT value for each pixel individually even though all buses share the same _cct variable
+          // TODO: there is an issue if CCT is calculated from RGB value (_cct==-1), we cannot do that with double buffer
+          Bus::_cct = _data[offset+channels-1];
+          Bus::calculateCCT(c, cctWW, cctCW);
+        }
+        unsigned pix = i;
+        if (_reversed) pix = _len - pix -1;
+        pix += _skip;
+        setPixel(_busPtr, pix, PolyBus::reorderColor(c, co), cctWW, cctCW);
       }
-      unsigned pix = i;
-      if (_reversed) pix = _len - pix -1;
-      pix += _skip;
-      PolyBus::setPixelColor(_busPtr, _iType, pix, c, co, (cctCW<<8) | cctWW);
     }
     #if !defined(STATUSLED) || STATUSLED>=0
     if (_skip) PolyBus::setPixelColor(_busPtr, _iType, 0, 0, _colorOrderMap.getPixelColorOrder(_start, _colorOrder)); // paint skipped pixels black
@@ -289,7 +296,9 @@ void IRAM_ATTR BusDigital::setPixelColor(uint16_t pix, uint32_t c) {
   if (hasWhite()) c = autoWhiteCalc(c);
   if (Bus::_cct >= 1900) c = colorBalanceFromKelvin(Bus::_cct, c); //color correction from CCT
   if (_data) {
-    size_t offset = pix * getNumberOfChannels();
+    const size_t base = pix * getNumberOfChannels();
+    size_t offset = base;
+    _colorSum -= pixelPower(base); // keep channel sum for current estimation up to date
     if (hasRGB()) {
       _data[offset++] = R(c);
       _data[offset++] = G(c);
@@ -299,6 +308,7 @@ void IRAM_ATTR BusDigital::setPixelColor(uint16_t pix, uint32_t c) {
     // unfortunately as a segment may span multiple buses or a bus may contain multiple segments and each segment may have different CCT
     // we need to store CCT value for each pixel (if there is a color correction in play, convert K in CCT ratio)
     if (hasCCT())   _data[offset]   = Bus::_cct >= 1900 ? (Bus::_cct - 1900) >> 5 : (Bus::_cct < 0 ? 127 : Bus::_cct); // TODO: if _cct == -1 we simply ignore it
+    _colorSum += pixelPower(base);
   } else {
     if (_reversed) pix = _len - pix -1;
     pix += _skip;
@@ -318,6 +328,35 @@ void IRAM_ATTR BusDigital::setPixelColor(uint16_t pix, uint32_t c) {
   }
 }
 
+void BusDigital::setPixelRange(uint16_t pix, uint16_t len, const uint32_t *c) {
+  if (!_valid) return;
+  if (pix + len > _len) len = pix < _len ? _len - pix : 0;
+  pixel_setter_t setPixel = nullptr;
+  // unbuffered plain RGB(W) bus: write straight into NeoPixelBus buffer resolving color order once per run
+  if (!_data && _type != TYPE_WS2812_1CH_X3 && !hasCCT() && Bus::_cct < 1900) setPixel = PolyBus::getPixelSetter(_iType);
+  if (!setPixel) {
+    for (unsigned i = 0; i < len; i++) BusDigital::setPixelColor(pix + i, c[i]); // non-virtual call
+    return;
+  }
+  if (_colorOrderRuns.empty() || _colorOrderRunsVersion != BusManager::getColorOrderMapVersion()) buildColorOrderRuns();
+  // runs are in physical order (see buildColorOrderRuns()), reversed bus writes pixels [pix, pix+len) to [_len-pix-len, _len-pix)
+  const unsigned first = _reversed ? _len - pix - len : pix;
+  const unsigned end   = first + len;
+  const bool white = hasWhite();
+  for (const ColorOrderMapEntry &run : _colorOrderRuns) {
+    if (run.start >= end) break; // runs are ordered
+    unsigned s = run.start > first ? run.start : first;
+    unsigned e = run.start + run.len < end ? run.start + run.len : end;
+    if (s >= e) continue;
+    const unsigned co = run.colorOrder;
+    for (unsigned p = s; p < e; p++) {
+      uint32_t col = c[(_reversed ? _len - p - 1 : p) - pix];
+      if (white) col = autoWhiteCalc(col);
+      setPixel(_busPtr, p + _skip, PolyBus::reorderColor(col, co), 0, 0);
+    }
+  }
+}
+
 // returns original color if global buffering is enabled, else returns lossly restored color from bus
 uint32_t IRAM_ATTR BusDigital::getPixelColor(uint16_t pix) {
   if (!_valid) return 0;
@@ -359,6 +398,21 @@ void BusDigital::setColorOrder(uint8_t colorOrder) {
   // upper nibble contains W swap information
   if ((colorOrder & 0x0F) > 5) return;
   _colorOrder = colorOrder;
+  _colorOrderRuns.clear(); // rebuilt on next show()
+}
+
+// split bus into runs of pixels with identical color order so color order map is not scanned for every pixel
+// buffered bus (show()) looks up color order by pixel index, unbuffered one (setPixelColor()) by physical index
+// (after reversing and skipping), runs follow the same index space: run.start is pixel index or physical index - _skip
+void BusDigital::buildColorOrderRuns() {
+  _colorOrderRuns.clear();
+  const unsigned ofs = _data ? _start : _start + _skip;
+  for (unsigned i = 0; i < _len; i++) {
+    uint8_t co = _colorOrderMap.getPixelColorOrder(i+ofs, _colorOrder);
+    if (!_colorOrderRuns.empty() && _colorOrderRuns.back().colorOrder == co) _colorOrderRuns.back().len++;
+    else _colorOrderRuns.push_back({uint16_t(i), 1, co});
+  }
+  _colorOrderRunsVersion = BusManager::getColorOrderMapVersion();
 }
 
 void BusDigital::reinit() {
@@ -373,6 +427,8 @@ void BusDigital::cleanup() {
   _valid = false;
   _busPtr = nullptr;
   if (_data != nullptr) freeData();
+  _colorOrderRuns.clear();
+  _colorOrderRuns.shrink_to_fit();
   pinManager.deallocatePin(_pins[1], PinOwner::BusDigital);
   pinManager.deallocatePin(_pins[0], PinOwner::BusDigital);
 }
@@ -639,6 +695,21 @@ void BusNetwork::setPixelColor(uint16_t pix, uint32_t c) {
   if (_rgbw) _data[offset+3] = W(c);
 }
 
+void BusNetwork::setPixelRange(uint16_t pix, uint16_t len, const uint32_t *c) {
+  if (!_valid || pix >= _len) return;
+  if (pix + len > _len) len = _len - pix;
+  if (_rgbw || Bus::_cct >= 1900) {
+    for (unsigned i = 0; i < len; i++) BusNetwork::setPixelColor(pix + i, c[i]); // needs per pixel white/CCT calculation
+    return;
+  }
+  uint8_t *dst = _data + pix * _UDPchannels;
+  for (unsigned i = 0; i < len; i++) {
+    *dst++ = R(c[i]);
+    *dst++ = G(c[i]);
+    *dst++ = B(c[i]);
+  }
+}
+
 uint32_t BusNetwork::getPixelColor(uint16_t pix) {
   if (!_valid || pix >= _len) return 0;
   unsigned offset = pix * _UDPchannels;
@@ -665,6 +736,38 @@ void BusNetwork::cleanup() {
   freeData();
 }
 
+#ifdef WLED_ENABLE_FX_BENCHMARK
+BusCapture::BusCapture(uint16_t len)
+: Bus(TYPE_NET_CAPTURE, 0, RGBW_MODE_MANUAL_ONLY, len)
+, _frames(0)
+{
+  _valid = (allocData(_len * sizeof(uint32_t)) != nullptr);
+  DEBUG_PRINTF_P(PSTR("%successfully inited capture sink (len %u)\n"), _valid?"S":"Uns", len);
+}
+
+void IRAM_ATTR BusCapture::setPixelColor(uint16_t pix, uint32_t c) {
+  if (!_valid || pix >= _len) return;
+  reinterpret_cast<uint32_t*>(_data)[pix] = c;
+}
+
+void BusCapture::setPixelRange(uint16_t pix, uint16_t len, const uint32_t *c) {
+  if (!_valid || pix >= _len) return;
+  if (pix + len > _len) len = _len - pix;
+  memcpy(reinterpret_cast<uint32_t*>(_data) + pix, c, len * sizeof(uint32_t));
+}
+
+uint32_t IRAM_ATTR BusCapture::getPixelColor(uint16_t pix) {
+  if (!_valid || pix >= _len) return 0;
+  return reinterpret_cast<uint32_t*>(_data)[pix];
+}
+
+void BusCapture::cleanup() {
+  _type = I_NONE;
+  _valid = false;
+  freeData();
+}
+#endif
+
 
 //utility to get the approx. memory usage of a given BusConfig
 uint32_t BusManager::memUsage(BusConfig &bc) {
@@ -703,7 +806,30 @@ int BusManager::add(BusConfig &bc) {
   } else {
     busses[numBusses] = new BusPwm(bc);
   }
-  return numBusses++;
+  numBusses++;
+  rebuildPixelMap();
+  return numBusses - 1;
+}
+
+// builds pixel to bus lookup table so setPixelColor()/getPixelColor() do not need to scan all buses
+void BusManager::rebuildPixelMap() {
+  unsigned len = 0;
+  for (unsigned i = 0; i < numBusses; i++) {
+    unsigned bend = busses[i]->getStart() + busses[i]->getLength();
+    if (bend > len) len = bend;
+  }
+  if (len != _pixelBusLen) {
+    free(_pixelBus);
+    _pixelBus = len ? (uint8_t*)malloc(len) : nullptr;
+    _pixelBusLen = _pixelBus ? len : 0; // if allocation fails buses are scanned for each pixel
+  }
+  if (!_pixelBus) return;
+  memset(_pixelBus, PIXEL_BUS_NONE, _pixelBusLen);
+  for (unsigned i = 0; i < numBusses; i++) {
+    unsigned bstart = busses[i]->getStart();
+    unsigned bend   = bstart + busses[i]->getLength();
+    for (unsigned p = bstart; p < bend; p++) _pixelBus[p] = (_pixelBus[p] == PIXEL_BUS_NONE) ? i : PIXEL_BUS_MULTI;
+  }
 }
 
 void BusManager::useParallelOutput(void) {
@@ -718,6 +844,14 @@ void BusManager::removeAll() {
   while (!canAllShow()) yield();
   for (unsigned i = 0; i < numBusses; i++) delete busses[i];
   numBusses = 0;
+  rebuildPixelMap();
+  memset(_currentSum, 0, sizeof(_currentSum));
+  memset(_busMilliAmps, 0, sizeof(_busMilliAmps));
+#ifndef WLED_DISABLE_PROFILER
+  resetShowTimes();
+#endif
+  _currentSamples = 0;
+  _currentHistoryLen = 0; // bus numbering may change
   _parallelOutputs = 1;
   PolyBus::setParallelI2S1Output(false);
 }
@@ -793,15 +927,71 @@ void BusManager::off() {
   #endif
 }
 
+void BusManager::holdRange(unsigned start, unsigned len) {
+  for (unsigned i = 0; i < numBusses; i++) {
+    Bus *bus = busses[i];
+    if (start < bus->getStart() + bus->getLength() && bus->getStart() < start + len) _heldBusses |= 1UL << i;
+  }
+}
+
 void BusManager::show() {
+  static_assert(WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES <= 32, "held bus bitmap is limited to 32 buses");
   _milliAmpsUsed = 0;
   for (unsigned i = 0; i < numBusses; i++) {
-    busses[i]->show();
-    _milliAmpsUsed += busses[i]->getUsedCurrent();
+    Bus *bus = busses[i];
+    // unchanged bus keeps its output (LEDs latch last data), network buses are always sent so receivers do not time out
+    // held bus still waits for a segment, it is shown complete by a later show()
+    if (!(_heldBusses & (1UL << i)) && (bus->isDirty() || bus->isOffRefreshRequired() || IS_VIRTUAL(bus->getType()))) {
+#ifndef WLED_DISABLE_PROFILER
+      unsigned long usStart = micros();
+      bus->show();
+      uint32_t us = micros() - usStart;
+      _showUs[i] = (7 * _showUs[i] + us + 4) >> 3;
+      if (us > _showUsMax[i]) _showUsMax[i] = us;
+#else
+      bus->show();
+#endif
+      _busMilliAmps[i] = bus->getUsedCurrent();
+      bus->clearDirty();
+    } else _skippedShows++;
+    uint16_t mA = _busMilliAmps[i];
+    _milliAmpsUsed += mA;
+    _currentSum[i] += mA;
   }
+  _heldBusses = 0;
   if (_milliAmpsUsed) _milliAmpsUsed += MA_FOR_ESP;
+
+  // store average current of each bus once per second
+  _currentSamples++;
+  if (millis() - _currentHistoryTime >= 1000) {
+    _currentHistoryTime = millis();
+    for (unsigned i = 0; i < numBusses; i++) {
+      _currentHistory[i][_currentHistoryPos] = _currentSum[i] / _currentSamples;
+      _currentSum[i] = 0;
+    }
+    _currentSamples = 0;
+    _currentHistoryPos = (_currentHistoryPos + 1) % BUS_CURRENT_HISTORY;
+    if (_currentHistoryLen < BUS_CURRENT_HISTORY) _currentHistoryLen++;
+  }
+}
+
+uint16_t BusManager::getCurrentHistory(uint8_t busNr, uint8_t age) {
+  if (busNr >= numBusses || age >= _currentHistoryLen) return 0;
+  return _currentHistory[busNr][(_currentHistoryPos + BUS_CURRENT_HISTORY - 1 - age) % BUS_CURRENT_HISTORY];
+}
+
+#ifndef WLED_DISABLE_PROFILER
+uint32_t BusManager::getShowTime(uint8_t busNr, bool peak) {
+  if (busNr >= numBusses) return 0;
+  return peak ? _showUsMax[busNr] : _showUs[busNr];
 }
 
+void BusManager::resetShowTimes() {
+  memset(_showUs, 0, sizeof(_showUs));
+  memset(_showUsMax, 0, sizeof(_showUsMax));
+}
+#endif
+
 void BusManager::setStatusPixel(uint32_t c) {
   for (unsigned i = 0; i < numBusses; i++) {
     busses[i]->setStatusPixel(c);
@@ -809,10 +999,35 @@ void BusManager::setStatusPixel(uint32_t c) {
 }
 
 void IRAM_ATTR BusManager::setPixelColor(uint16_t pix, uint32_t c) {
+  if (_pixelBus) {
+    if (pix >= _pixelBusLen) return;
+    unsigned b = _pixelBus[pix];
+    if (b == PIXEL_BUS_NONE) return;
+    if (b != PIXEL_BUS_MULTI) {
+      busses[b]->setPixelColor(pix - busses[b]->getStart(), c);
+      busses[b]->markDirty();
+      return;
+    }
+  }
+  // overlapping buses (or no lookup table): set pixel on all buses containing it
   for (unsigned i = 0; i < numBusses; i++) {
     unsigned bstart = busses[i]->getStart();
     if (pix < bstart || pix >= bstart + busses[i]->getLength()) continue;
     busses[i]->setPixelColor(pix - bstart, c);
+    busses[i]->markDirty();
+  }
+}
+
+void BusManager::setPixelRange(uint16_t start, uint16_t len, const uint32_t *c) {
+  unsigned end = start + len;
+  for (unsigned i = 0; i < numBusses; i++) {
+    unsigned bstart = busses[i]->getStart();
+    unsigned bend   = bstart + busses[i]->getLength();
+    unsigned s = start > bstart ? start : bstart;
+    unsigned e = end   < bend   ? end   : bend;
+    if (s >= e) continue;
+    busses[i]->setPixelRange(s - bstart, e - s, c + (s - start));
+    busses[i]->markDirty();
   }
 }
 
@@ -832,6 +1047,12 @@ void BusManager::setSegmentCCT(int16_t cct, bool allowWBCorrection) {
 }
 
 uint32_t BusManager::getPixelColor(uint16_t pix) {
+  if (_pixelBus) {
+    if (pix >= _pixelBusLen) return 0;
+    unsigned b = _pixelBus[pix];
+    if (b == PIXEL_BUS_NONE) return 0;
+    if (b != PIXEL_BUS_MULTI) return busses[b]->getPixelColor(pix - busses[b]->getStart());
+  }
   for (unsigned i = 0; i < numBusses; i++) {
     unsigned bstart = busses[i]->getStart();
     if (pix < bstart || pix >= bstart + busses[i]->getLength()) continue;
@@ -871,6 +1092,22 @@ uint16_t BusDigital::_milliAmpsTotal = 0;
 uint8_t       BusManager::numBusses = 0;
 Bus*          BusManager::busses[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES];
 ColorOrderMap BusManager::colorOrderMap = {};
+uint8_t BusManager::_colorOrderMapVersion = 0;
 uint16_t      BusManager::_milliAmpsUsed = 0;
 uint16_t      BusManager::_milliAmpsMax = ABL_MILLIAMPS_DEFAULT;
 uint8_t       BusManager::_parallelOutputs = 1;
+uint8_t*      BusManager::_pixelBus = nullptr;
+uint16_t      BusManager::_pixelBusLen = 0;
+uint16_t      BusManager::_busMilliAmps[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES];
+uint32_t      BusManager::_skippedShows = 0;
+uint32_t      BusManager::_heldBusses = 0;
+uint16_t      BusManager::_currentHistory[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES][BUS_CURRENT_HISTORY];
+uint32_t      BusManager::_currentSum[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES];
+#ifndef WLED_DISABLE_PROFILER
+uint32_t      BusManager::_showUs[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES];
+uint32_t      BusManager::_showUsMax[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES];
+#endif
+uint16_t      BusManager::_currentSamples = 0;
+uint8_t       BusManager::_currentHistoryPos = 0;
+uint8_t       BusManager::_currentHistoryLen = 0;
+unsigned long BusManager::_currentHistoryTime = 0;
@@ -6,6 +6,7 @@
  */
 
 #include "const.h"
+#include <vector>
 
 //colors.cpp
 uint16_t approximateKelvinFromRGB(uint32_t rgb);
@@ -21,6 +22,13 @@ uint16_t approximateKelvinFromRGB(uint32_t rgb);
 #define IC_INDEX_WS2812_2CH_3X(i)  ((i)*2/3)
 #define WS2812_2CH_3X_SPANS_2_ICS(i) ((i)&0x01)    // every other LED zone is on two different ICs
 
+#define PIXEL_BUS_NONE  255 // no bus owns the pixel
+#define PIXEL_BUS_MULTI 254 // pixel is shared by overlapping buses
+
+#ifndef BUS_CURRENT_HISTORY
+  #define BUS_CURRENT_HISTORY 16 // seconds of per-bus current history kept for JSON info
+#endif
+
 //temporary struct for passing bus configuration to bus
 struct BusConfig {
   uint8_t type;
@@ -115,6 +123,7 @@ class Bus {
     , _reversed(reversed)
     , _valid(false)
     , _needsRefresh(refresh)
+    , _dirty(true)
     , _data(nullptr) // keep data access consistent across all types of buses
     {
       _autoWhiteMode = Bus::hasWhite(type) ? aw : RGBW_MODE_MANUAL_ONLY;
@@ -126,8 +135,9 @@ class Bus {
     virtual bool     canShow()                   { return true; }
     virtual void     setStatusPixel(uint32_t c)  {}
     virtual void     setPixelColor(uint16_t pix, uint32_t c) = 0;
+    virtual void     setPixelRange(uint16_t pix, uint16_t len, const uint32_t *c) { for (unsigned i = 0; i < len; i++) setPixelColor(pix + i, c[i]); }
     virtual uint32_t getPixelColor(uint16_t pix) { return 0; }
-    virtual void     setBrightness(uint8_t b)    { _bri = b; };
+    virtual void     setBrightness(uint8_t b)    { _bri = b; _dirty = true; };
     virtual uint8_t  getPins(uint8_t* pinArray)  { return 0; }
     virtual uint16_t getLength()                 { return isOk() ? _len : 0; }
     virtual void     setColorOrder(uint8_t co)   {}
@@ -146,6 +156,9 @@ class Bus {
     inline  bool     isOk()                      { return _valid; }
     inline  bool     isReversed()                { return _reversed; }
     inline  bool     isOffRefreshRequired()      { return _needsRefresh; }
+    inline  void     markDirty()                 { _dirty = true; }
+    inline  bool     isDirty()                   { return _dirty; }
+    inline  void     clearDirty()                { _dirty = false; }
             bool     containsPixel(uint16_t pix) { return pix >= _start && pix < _start+_len; }
 
     virtual bool hasRGB(void) { return Bus::hasRGB(_type); }
@@ -215,6 +228,7 @@ class Bus {
     bool     _reversed;
     bool     _valid;
     bool     _needsRefresh;
+    bool     _dirty;        // pixels or brightness changed since last show()
     uint8_t  _autoWhiteMode;
     uint8_t  *_data;
     // global Auto White Calculation override
@@ -246,6 +260,7 @@ class BusDigital : public Bus {
     void setBrightness(uint8_t b) override;
     void setStatusPixel(uint32_t c) override;
     void setPixelColor(uint16_t pix, uint32_t c) override;
+    void setPixelRange(uint16_t pix, uint16_t len, const uint32_t *c) override;
     void setColorOrder(uint8_t colorOrder) override;
     uint32_t getPixelColor(uint16_t pix) override;
     uint8_t  getColorOrder() override  { return _colorOrder; }
@@ -269,9 +284,22 @@ class BusDigital : public Bus {
     uint16_t _milliAmpsMax;
     void * _busPtr;
     const ColorOrderMap &_colorOrderMap;
+    uint32_t _colorSum; // sum of channel values in _data (using current power model), maintained as pixels are set
+    std::vector<ColorOrderMapEntry> _colorOrderRuns; // contiguous runs of bus pixels (0-based, see buildColorOrderRuns()) sharing the same color order
+    uint8_t _colorOrderRunsVersion;                   // color order map version the runs were built for
 
     static uint16_t _milliAmpsTotal; // is overwitten/recalculated on each show()
 
+    void buildColorOrderRuns();
+
+    // channel value sum of a pixel in _data as used for current estimation
+    inline uint32_t pixelPower(size_t offset) {
+      const uint8_t *d = _data + offset;
+      if (!hasRGB()) return _milliAmpsPerLed == 255 ? d[0]*3 : d[0]*4; // single channel is returned as R=G=B=W by getPixelColor()
+      if (_milliAmpsPerLed == 255) return max(max(d[0],d[1]),d[2]) * 3; // WS2815 model ignores white
+      return d[0] + d[1] + d[2] + (hasWhite() ? d[3] : 0);
+    }
+
     inline uint32_t restoreColorLossy(uint32_t c, uint8_t restoreBri) {
       if (restoreBri < 255) {
         uint8_t* chan = (uint8_t*) &c;
@@ -336,6 +364,7 @@ class BusNetwork : public Bus {
     bool hasWhite() override { return _rgbw; }
     bool canShow() override  { return !_broadcastLock; } // this should be a return value from UDP routine if it is still sending data out
     void setPixelColor(uint16_t pix, uint32_t c) override;
+    void setPixelRange(uint16_t pix, uint16_t len, const uint32_t *c) override;
     uint32_t getPixelColor(uint16_t pix) override;
     uint8_t  getPins(uint8_t* pinArray) override;
     void show() override;
@@ -349,6 +378,30 @@ class BusNetwork : public Bus {
     bool      _broadcastLock;
 };
 
+#ifdef WLED_ENABLE_FX_BENCHMARK
+// headless LED sink: keeps the last frame in RAM and does not drive any hardware
+// it is not managed by BusManager, WS2812FX routes pixels to it while benchmarking effects
+class BusCapture : public Bus {
+  public:
+    BusCapture(uint16_t len);
+    ~BusCapture() { cleanup(); }
+
+    bool hasRGB() override   { return true; }
+    bool hasWhite() override { return true; }
+    void setPixelColor(uint16_t pix, uint32_t c) override;
+    void setPixelRange(uint16_t pix, uint16_t len, const uint32_t *c) override;
+    uint32_t getPixelColor(uint16_t pix) override;
+    void show() override     { _frames++; }
+    void cleanup();
+
+    inline uint32_t getFrameCount() const { return _frames; }
+    inline const uint32_t *getFrame() const { return reinterpret_cast<const uint32_t*>(_data); }
+
+  private:
+    uint32_t _frames;
+};
+#endif
+
 
 class BusManager {
   public:
@@ -358,6 +411,13 @@ class BusManager {
     static uint32_t memUsage(BusConfig &bc);
     static uint32_t memUsage(unsigned channels, unsigned count, unsigned buses = 1);
     static uint16_t currentMilliamps(void) { return _milliAmpsUsed; }
+    static uint32_t getSkippedShows(void)  { return _skippedShows; } // number of bus updates skipped because bus was unchanged
+    static uint16_t getCurrentHistory(uint8_t busNr, uint8_t age); // average current of a bus age+1 seconds ago (0 if not available)
+    static uint8_t  getCurrentHistoryLen(void) { return _currentHistoryLen; }
+#ifndef WLED_DISABLE_PROFILER
+    static uint32_t getShowTime(uint8_t busNr, bool peak = false); // smoothed (or peak) time in us spent in bus show() (asynchronous buses only account for setup)
+    static void     resetShowTimes(void);
+#endif
     static uint16_t ablMilliampsMax(void)  { return _milliAmpsMax; }
 
     static int add(BusConfig &bc);
@@ -370,9 +430,11 @@ class BusManager {
     static void off(void);
 
     static void show();
+    static void holdRange(unsigned start, unsigned len); // buses covering range are not shown by next show() (they stay dirty)
     static bool canAllShow();
     static void setStatusPixel(uint32_t c);
     static void setPixelColor(uint16_t pix, uint32_t c);
+    static void setPixelRange(uint16_t start, uint16_t len, const uint32_t *c); // copies a run of pixels into owning bus(es)
     static void setBrightness(uint8_t b);
     // for setSegmentCCT(), cct can only be in [-1,255] range; allowWBCorrection will convert it to K
     // WARNING: setSegmentCCT() is a misleading name!!! much better would be setGlobalCCT() or just setCCT()
@@ -387,17 +449,36 @@ class BusManager {
     static uint16_t getTotalLength();
     static uint8_t getNumBusses() { return numBusses; }
 
-    static void                 updateColorOrderMap(const ColorOrderMap &com) { memcpy(&colorOrderMap, &com, sizeof(ColorOrderMap)); }
+    static void                 updateColorOrderMap(const ColorOrderMap &com) { memcpy(&colorOrderMap, &com, sizeof(ColorOrderMap)); _colorOrderMapVersion++; }
     static const ColorOrderMap& getColorOrderMap() { return colorOrderMap; }
+    static uint8_t              getColorOrderMapVersion() { return _colorOrderMapVersion; } // changes each time color order map is updated
 
   private:
     static uint8_t numBusses;
     static Bus* busses[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES];
     static ColorOrderMap colorOrderMap;
+    static uint8_t _colorOrderMapVersion;
     static uint16_t _milliAmpsUsed;
+    static uint16_t _busMilliAmps[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES]; // current of each bus at its last show()
+    static uint32_t _skippedShows;
+    static uint32_t _heldBusses;    // bitmap of buses skipped by next show()
     static uint16_t _milliAmpsMax;
     static uint8_t _parallelOutputs;
+    static uint8_t *_pixelBus;      // index of the bus owning each pixel (PIXEL_BUS_NONE/PIXEL_BUS_MULTI if none/overlapping)
+    static uint16_t _pixelBusLen;   // number of entries in _pixelBus
+    // per bus current history (one sample per second, averaged over show() calls)
+    static uint16_t _currentHistory[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES][BUS_CURRENT_HISTORY];
+    static uint32_t _currentSum[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES];
+#ifndef WLED_DISABLE_PROFILER
+    static uint32_t _showUs[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES];    // exponentially smoothed show() time
+    static uint32_t _showUsMax[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES];
+#endif
+    static uint16_t _currentSamples;
+    static uint8_t  _currentHistoryPos;
+    static uint8_t  _currentHistoryLen;
+    static unsigned long _currentHistoryTime;
 
+    static void    rebuildPixelMap(void);
     #ifdef ESP32_DATA_IDLE_HIGH
     static void    esp32RMTInvertIdle();
     #endif
@@ -307,6 +307,9 @@
 #define toRGBW32(c) (RGBW32((c>>40)&0xFF, (c>>24)&0xFF, (c>>8)&0xFF, (c>>56)&0xFF))
 #define RGBW32(r,g,b,w) (uint32_t((byte(w) << 24) | (byte(r) << 16) | (byte(g) << 8) | (byte(b))))
 
+// writes one (already reordered) pixel into a bus of a known type, see PolyBus::getPixelSetter()
+typedef void (*pixel_setter_t)(void* busPtr, uint16_t pix, const RgbwColor &col, uint8_t cctWW, uint8_t cctCW);
+
 //handles pointer type conversion for all possible bus types
 class PolyBus {
   private:
@@ -777,13 +780,13 @@ class PolyBus {
     return true;
   }
 
-  static void setPixelColor(void* busPtr, uint8_t busType, uint16_t pix, uint32_t c, uint8_t co, uint16_t wwcw = 0) {
+  // reorders channels of a color according to color order (lower nibble) and W swap (upper nibble)
+  static inline RgbwColor reorderColor(uint32_t c, uint8_t co) {
     uint8_t r = c >> 16;
     uint8_t g = c >> 8;
     uint8_t b = c >> 0;
     uint8_t w = c >> 24;
     RgbwColor col;
-    uint8_t cctWW = wwcw & 0xFF, cctCW = (wwcw>>8) & 0xFF;
 
     // reorder channels to selected order
     switch (co & 0x0F) {
@@ -801,6 +804,129 @@ class PolyBus {
       case  2: col.W = col.G; col.G = w; break; // swap W & G
       case  3: col.W = col.R; col.R = w; break; // swap W & R
     }
+    return col;
+  }
+
+  // conversion of (reordered) color into color object of the bus
+  static inline RgbColor    toBusColor(const RgbwColor &col, uint8_t, uint8_t, RgbColor*)    { return RgbColor(col); }
+  static inline RgbwColor   toBusColor(const RgbwColor &col, uint8_t, uint8_t, RgbwColor*)   { return col; }
+  static inline Rgb48Color  toBusColor(const RgbwColor &col, uint8_t, uint8_t, Rgb48Color*)  { return Rgb48Color(RgbColor(col)); }
+  static inline Rgbw64Color toBusColor(const RgbwColor &col, uint8_t, uint8_t, Rgbw64Color*) { return Rgbw64Color(col); }
+  static inline RgbwwColor  toBusColor(const RgbwColor &col, uint8_t cctWW, uint8_t cctCW, RgbwwColor*) { return RgbwwColor(col.R, col.G, col.B, cctWW, cctCW); }
+
+  template <class T, class C>
+  static void setPixelTyped(void* busPtr, uint16_t pix, const RgbwColor &col, uint8_t cctWW, uint8_t cctCW) {
+    (static_cast<T*>(busPtr))->SetPixelColor(pix, toBusColor(col, cctWW, cctCW, (C*)nullptr));
+  }
+
+  // returns setter for a single (reordered) pixel of given bus type so a bus can be filled without resolving its type for each pixel
+  static pixel_setter_t getPixelSetter(uint8_t busType) {
+    switch (busType) {
+    #ifdef ESP8266
+      case I_8266_U0_NEO_3: return &setPixelTyped<B_8266_U0_NEO_3,RgbColor>;
+      case I_8266_U1_NEO_3: return &setPixelTyped<B_8266_U1_NEO_3,RgbColor>;
+      case I_8266_DM_NEO_3: return &setPixelTyped<B_8266_DM_NEO_3,RgbColor>;
+      case I_8266_BB_NEO_3: return &setPixelTyped<B_8266_BB_NEO_3,RgbColor>;
+      case I_8266_U0_NEO_4: return &setPixelTyped<B_8266_U0_NEO_4,RgbwColor>;
+      case I_8266_U1_NEO_4: return &setPixelTyped<B_8266_U1_NEO_4,RgbwColor>;
+      case I_8266_DM_NEO_4: return &setPixelTyped<B_8266_DM_NEO_4,RgbwColor>;
+      case I_8266_BB_NEO_4: return &setPixelTyped<B_8266_BB_NEO_4,RgbwColor>;
+      case I_8266_U0_400_3: return &setPixelTyped<B_8266_U0_400_3,RgbColor>;
+      case I_8266_U1_400_3: return &setPixelTyped<B_8266_U1_400_3,RgbColor>;
+      case I_8266_DM_400_3: return &setPixelTyped<B_8266_DM_400_3,RgbColor>;
+      case I_8266_BB_400_3: return &setPixelTyped<B_8266_BB_400_3,RgbColor>;
+      case I_8266_U0_TM1_4: return &setPixelTyped<B_8266_U0_TM1_4,RgbwColor>;
+      case I_8266_U1_TM1_4: return &setPixelTyped<B_8266_U1_TM1_4,RgbwColor>;
+      case I_8266_DM_TM1_4: return &setPixelTyped<B_8266_DM_TM1_4,RgbwColor>;
+      case I_8266_BB_TM1_4: return &setPixelTyped<B_8266_BB_TM1_4,RgbwColor>;
+      case I_8266_U0_TM2_3: return &setPixelTyped<B_8266_U0_TM2_3,RgbColor>;
+      case I_8266_U1_TM2_3: return &setPixelTyped<B_8266_U1_TM2_3,RgbColor>;
+      case I_8266_DM_TM2_3: return &setPixelTyped<B_8266_DM_TM2_3,RgbColor>;
+      case I_8266_BB_TM2_3: return &setPixelTyped<B_8266_BB_TM2_3,RgbColor>;
+      case I_8266_U0_UCS_3: return &setPixelTyped<B_8266_U0_UCS_3,Rgb48Color>;
+      case I_8266_U1_UCS_3: return &setPixelTyped<B_8266_U1_UCS_3,Rgb48Color>;
+      case I_8266_DM_UCS_3: return &setPixelTyped<B_8266_DM_UCS_3,Rgb48Color>;
+      case I_8266_BB_UCS_3: return &setPixelTyped<B_8266_BB_UCS_3,Rgb48Color>;
+      case I_8266_U0_UCS_4: return &setPixelTyped<B_8266_U0_UCS_4,Rgbw64Color>;
+      case I_8266_U1_UCS_4: return &setPixelTyped<B_8266_U1_UCS_4,Rgbw64Color>;
+      case I_8266_DM_UCS_4: return &setPixelTyped<B_8266_DM_UCS_4,Rgbw64Color>;
+      case I_8266_BB_UCS_4: return &setPixelTyped<B_8266_BB_UCS_4,Rgbw64Color>;
+      case I_8266_U0_APA106_3: return &setPixelTyped<B_8266_U0_APA106_3,RgbColor>;
+      case I_8266_U1_APA106_3: return &setPixelTyped<B_8266_U1_APA106_3,RgbColor>;
+      case I_8266_DM_APA106_3: return &setPixelTyped<B_8266_DM_APA106_3,RgbColor>;
+      case I_8266_BB_APA106_3: return &setPixelTyped<B_8266_BB_APA106_3,RgbColor>;
+      case I_8266_U0_FW6_5: return &setPixelTyped<B_8266_U0_FW6_5,RgbwwColor>;
+      case I_8266_U1_FW6_5: return &setPixelTyped<B_8266_U1_FW6_5,RgbwwColor>;
+      case I_8266_DM_FW6_5: return &setPixelTyped<B_8266_DM_FW6_5,RgbwwColor>;
+      case I_8266_BB_FW6_5: return &setPixelTyped<B_8266_BB_FW6_5,RgbwwColor>;
+      case I_8266_U0_2805_5: return &setPixelTyped<B_8266_U0_2805_5,RgbwwColor>;
+      case I_8266_U1_2805_5: return &setPixelTyped<B_8266_U1_2805_5,RgbwwColor>;
+      case I_8266_DM_2805_5: return &setPixelTyped<B_8266_DM_2805_5,RgbwwColor>;
+      case I_8266_BB_2805_5: return &setPixelTyped<B_8266_BB_2805_5,RgbwwColor>;
+      case I_8266_U0_TM1914_3: return &setPixelTyped<B_8266_U0_TM1914_3,RgbColor>;
+      case I_8266_U1_TM1914_3: return &setPixelTyped<B_8266_U1_TM1914_3,RgbColor>;
+      case I_8266_DM_TM1914_3: return &setPixelTyped<B_8266_DM_TM1914_3,RgbColor>;
+      case I_8266_BB_TM1914_3: return &setPixelTyped<B_8266_BB_TM1914_3,RgbColor>;
+    #endif
+    #ifdef ARDUINO_ARCH_ESP32
+      // RMT buses
+      case I_32_RN_NEO_3: return &setPixelTyped<B_32_RN_NEO_3,RgbColor>;
+      case I_32_RN_NEO_4: return &setPixelTyped<B_32_RN_NEO_4,RgbwColor>;
+      case I_32_RN_400_3: return &setPixelTyped<B_32_RN_400_3,RgbColor>;
+      case I_32_RN_TM1_4: return &setPixelTyped<B_32_RN_TM1_4,RgbwColor>;
+      case I_32_RN_TM2_3: return &setPixelTyped<B_32_RN_TM2_3,RgbColor>;
+      case I_32_RN_UCS_3: return &setPixelTyped<B_32_RN_UCS_3,Rgb48Color>;
+      case I_32_RN_UCS_4: return &setPixelTyped<B_32_RN_UCS_4,Rgbw64Color>;
+      case I_32_RN_APA106_3: return &setPixelTyped<B_32_RN_APA106_3,RgbColor>;
+      case I_32_RN_FW6_5: return &setPixelTyped<B_32_RN_FW6_5,RgbwwColor>;
+      case I_32_RN_2805_5: return &setPixelTyped<B_32_RN_2805_5,RgbwwColor>;
+      case I_32_RN_TM1914_3: return &setPixelTyped<B_32_RN_TM1914_3,RgbColor>;
+      // I2S1 bus or paralell buses
+      #ifndef WLED_NO_I2S1_PIXELBUS
+      case I_32_I1_NEO_3: return useParallelI2S ? &setPixelTyped<B_32_I1_NEO_3P,RgbColor> : &setPixelTyped<B_32_I1_NEO_3,RgbColor>;
+      case I_32_I1_NEO_4: return useParallelI2S ? &setPixelTyped<B_32_I1_NEO_4P,RgbColor> : &setPixelTyped<B_32_I1_NEO_4,RgbwColor>;
+      case I_32_I1_400_3: return useParallelI2S ? &setPixelTyped<B_32_I1_400_3P,RgbColor> : &setPixelTyped<B_32_I1_400_3,RgbColor>;
+      case I_32_I1_TM1_4: return useParallelI2S ? &setPixelTyped<B_32_I1_TM1_4P,RgbColor> : &setPixelTyped<B_32_I1_TM1_4,RgbwColor>;
+      case I_32_I1_TM2_3: return useParallelI2S ? &setPixelTyped<B_32_I1_TM2_3P,RgbColor> : &setPixelTyped<B_32_I1_TM2_3,RgbColor>;
+      case I_32_I1_UCS_3: return useParallelI2S ? &setPixelTyped<B_32_I1_UCS_3P,RgbColor> : &setPixelTyped<B_32_I1_UCS_3,Rgb48Color>;
+      case I_32_I1_UCS_4: return useParallelI2S ? &setPixelTyped<B_32_I1_UCS_4P,RgbColor> : &setPixelTyped<B_32_I1_UCS_4,Rgbw64Color>;
+      case I_32_I1_APA106_3: return useParallelI2S ? &setPixelTyped<B_32_I1_APA106_3P,RgbColor> : &setPixelTyped<B_32_I1_APA106_3,RgbColor>;
+      case I_32_I1_FW6_5: return useParallelI2S ? &setPixelTyped<B_32_I1_FW6_5P,RgbColor> : &setPixelTyped<B_32_I1_FW6_5,RgbwwColor>;
+      case I_32_I1_2805_5: return useParallelI2S ? &setPixelTyped<B_32_I1_2805_5P,RgbColor> : &setPixelTyped<B_32_I1_2805_5,RgbwwColor>;
+      case I_32_I1_TM1914_3: return useParallelI2S ? &setPixelTyped<B_32_I1_TM1914_3P,RgbColor> : &setPixelTyped<B_32_I1_TM1914_3,RgbColor>;
+      #endif
+      // I2S0 bus
+      #ifndef WLED_NO_I2S0_PIXELBUS
+      case I_32_I0_NEO_3: return &setPixelTyped<B_32_I0_NEO_3,RgbColor>;
+      case I_32_I0_NEO_4: return &setPixelTyped<B_32_I0_NEO_4,RgbwColor>;
+      case I_32_I0_400_3: return &setPixelTyped<B_32_I0_400_3,RgbColor>;
+      case I_32_I0_TM1_4: return &setPixelTyped<B_32_I0_TM1_4,RgbwColor>;
+      case I_32_I0_TM2_3: return &setPixelTyped<B_32_I0_TM2_3,RgbColor>;
+      case I_32_I0_UCS_3: return &setPixelTyped<B_32_I0_UCS_3,Rgb48Color>;
+      case I_32_I0_UCS_4: return &setPixelTyped<B_32_I0_UCS_4,Rgbw64Color>;
+      case I_32_I0_APA106_3: return &setPixelTyped<B_32_I0_APA106_3,RgbColor>;
+      case I_32_I0_FW6_5: return &setPixelTyped<B_32_I0_FW6_5,RgbwwColor>;
+      case I_32_I0_2805_5: return &setPixelTyped<B_32_I0_2805_5,RgbwwColor>;
+      case I_32_I0_TM1914_3: return &setPixelTyped<B_32_I0_TM1914_3,RgbColor>;
+      #endif
+    #endif
+      case I_HS_DOT_3: return &setPixelTyped<B_HS_DOT_3,RgbColor>;
+      case I_SS_DOT_3: return &setPixelTyped<B_SS_DOT_3,RgbColor>;
+      case I_HS_LPD_3: return &setPixelTyped<B_HS_LPD_3,RgbColor>;
+      case I_SS_LPD_3: return &setPixelTyped<B_SS_LPD_3,RgbColor>;
+      case I_HS_LPO_3: return &setPixelTyped<B_HS_LPO_3,RgbColor>;
+      case I_SS_LPO_3: return &setPixelTyped<B_SS_LPO_3,RgbColor>;
+      case I_HS_WS1_3: return &setPixelTyped<B_HS_WS1_3,RgbColor>;
+      case I_SS_WS1_3: return &setPixelTyped<B_SS_WS1_3,RgbColor>;
+      case I_HS_P98_3: return &setPixelTyped<B_HS_P98_3,RgbColor>;
+      case I_SS_P98_3: return &setPixelTyped<B_SS_P98_3,RgbColor>;
+    }
+    return nullptr;
+  }
+
+  static void setPixelColor(void* busPtr, uint8_t busType, uint16_t pix, uint32_t c, uint8_t co, uint16_t wwcw = 0) {
+    RgbwColor col = reorderColor(c, co);
+    uint8_t cctWW = wwcw & 0xFF, cctCW = (wwcw>>8) & 0xFF;
 
     switch (busType) {
       case I_NONE: break;
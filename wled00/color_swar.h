@@ -0,0 +1,71 @@
+#ifndef WLED_COLOR_SWAR_H
+#define WLED_COLOR_SWAR_H
+
+/*
+ * packed (SWAR) channel math used by color_blend(), color_add(), color_fade() and their span versions
+ *
+ * R & B (and W & G) are processed together, each in its own 16 bit lane of a 32 bit word, so every
+ * operation below handles two channels at once. Depends only on <stdint.h> so results can be checked
+ * against per channel math on host (test/test_color_swar).
+ */
+
+#include <stdint.h>
+
+#define SWAR_LANES 0x00FF00FFU
+
+// (c * scale) >> 8 for each channel, scale 0-256
+static inline uint32_t swar_scale(uint32_t c, uint32_t scale) {
+  uint32_t rb = ((( c       & SWAR_LANES) * scale) >> 8) & SWAR_LANES;
+  uint32_t wg = ((((c >> 8) & SWAR_LANES) * scale)     ) & ~SWAR_LANES;
+  return rb | wg;
+}
+
+// (c2 * blend + c1 * (255 - blend)) >> 8 for each channel, blend 0-255
+static inline uint32_t swar_blend8(uint32_t c1, uint32_t c2, uint32_t blend) {
+  uint32_t inv = 255 - blend;
+  uint32_t rb = ((( c1       & SWAR_LANES) * inv + ( c2       & SWAR_LANES) * blend) >> 8) & SWAR_LANES;
+  uint32_t wg = ((((c1 >> 8) & SWAR_LANES) * inv + ((c2 >> 8) & SWAR_LANES) * blend)     ) & ~SWAR_LANES;
+  return rb | wg;
+}
+
+// per channel sum (up to 9 bits per lane), returns non-zero overflow bits if any channel exceeds 255
+static inline uint32_t swar_sum(uint32_t c1, uint32_t c2, uint32_t &rb, uint32_t &wg) {
+  rb = ( c1       & SWAR_LANES) + ( c2       & SWAR_LANES);
+  wg = ((c1 >> 8) & SWAR_LANES) + ((c2 >> 8) & SWAR_LANES);
+  return (rb | wg) & 0x01000100U;
+}
+
+// packs lanes of swar_sum() saturating each channel (same as qadd8()): overflowing lanes get all 8 bits set
+static inline uint32_t swar_saturate(uint32_t rb, uint32_t wg) {
+  rb = (rb | (((rb >> 8) & 0x00010001U) * 0xFF)) & SWAR_LANES;
+  wg = (wg | (((wg >> 8) & 0x00010001U) * 0xFF)) & SWAR_LANES;
+  return rb | (wg << 8);
+}
+
+// color_add(): saturating (fast) or scaled so that the brightest channel is 255 (keeps hue)
+static inline uint32_t swar_add(uint32_t c1, uint32_t c2, bool fast) {
+  uint32_t rb, wg;
+  if (!swar_sum(c1, c2, rb, wg)) return rb | (wg << 8); // no channel saturated, same result for both methods
+  if (fast) return swar_saturate(rb, wg);
+  uint32_t b = rb & 0x1FF, r = rb >> 16, g = wg & 0x1FF, w = wg >> 16;
+  uint32_t max = r;
+  if (g > max) max = g;
+  if (b > max) max = b;
+  if (w > max) max = w;
+  return (w * 255 / max) << 24 | (r * 255 / max) << 16 | (g * 255 / max) << 8 | (b * 255 / max);
+}
+
+// dst[i] = swar_add(a[i], b[i], fast), dst may be a or b
+static inline void swar_add_span(uint32_t *dst, const uint32_t *a, const uint32_t *b, unsigned n, bool fast) {
+  if (fast) {
+    for (unsigned i = 0; i < n; i++) {
+      uint32_t rb, wg;
+      swar_sum(a[i], b[i], rb, wg);
+      dst[i] = swar_saturate(rb, wg); // without overflow same as packing rb and wg
+    }
+  } else {
+    for (unsigned i = 0; i < n; i++) dst[i] = swar_add(a[i], b[i], false);
+  }
+}
+
+#endif
@@ -1,4 +1,5 @@
 #include "wled.h"
+#include "color_swar.h"
 
 /*
  * Color conversion & utility methods
@@ -11,6 +12,7 @@ uint32_t color_blend(uint32_t color1, uint32_t color2, uint16_t blend, bool b16)
   if(blend == 0)   return color1;
   unsigned blendmax = b16 ? 0xFFFF : 0xFF;
   if(blend == blendmax) return color2;
+  if (!b16) return swar_blend8(color1, color2, blend); // 8 bit products fit into 16 bit lanes
   uint8_t shift = b16 ? 16 : 8;
 
   uint32_t w1 = W(color1);
@@ -37,28 +39,7 @@ uint32_t color_blend(uint32_t color1, uint32_t color2, uint16_t blend, bool b16)
  */
 uint32_t color_add(uint32_t c1, uint32_t c2, bool fast)
 {
-  if (fast) {
-    uint8_t r = R(c1);
-    uint8_t g = G(c1);
-    uint8_t b = B(c1);
-    uint8_t w = W(c1);
-    r = qadd8(r, R(c2));
-    g = qadd8(g, G(c2));
-    b = qadd8(b, B(c2));
-    w = qadd8(w, W(c2));
-    return RGBW32(r,g,b,w);
-  } else {
-    uint32_t r = R(c1) + R(c2);
-    uint32_t g = G(c1) + G(c2);
-    uint32_t b = B(c1) + B(c2);
-    uint32_t w = W(c1) + W(c2);
-    unsigned max = r;
-    if (g > max) max = g;
-    if (b > max) max = b;
-    if (w > max) max = w;
-    if (max < 256) return RGBW32(r, g, b, w);
-    else           return RGBW32(r * 255 / max, g * 255 / max, b * 255 / max, w * 255 / max);
-  }
+  return swar_add(c1, c2, fast);
 }
 
 /*
@@ -68,29 +49,44 @@ uint32_t color_add(uint32_t c1, uint32_t c2, bool fast)
 
 uint32_t color_fade(uint32_t c1, uint8_t amount, bool video)
 {
+  if (!video) return swar_scale(c1, 1 + amount);
   uint32_t scaledcolor; // color order is: W R G B from MSB to LSB
   uint32_t r = R(c1);
   uint32_t g = G(c1);
   uint32_t b = B(c1);
   uint32_t w = W(c1);
-  if (video)  {
-    uint32_t scale = amount; // 32bit for faster calculation
-    scaledcolor = (((r * scale) >> 8) << 16) + ((r && scale) ? 1 : 0);
-    scaledcolor |= (((g * scale) >> 8) << 8) + ((g && scale) ? 1 : 0);
-    scaledcolor |= ((b * scale) >> 8) + ((b && scale) ? 1 : 0);
-    scaledcolor |= (((w * scale) >> 8) << 24) + ((w && scale) ? 1 : 0);
-    return scaledcolor;
-  }
-  else  {
-    uint32_t scale = 1 + amount;
-    scaledcolor = ((r * scale) >> 8) << 16;
-    scaledcolor |= ((g * scale) >> 8) << 8;
-    scaledcolor |= (b * scale) >> 8;
-    scaledcolor |= ((w * scale) >> 8) << 24;
-    return scaledcolor;
+  uint32_t scale = amount; // 32bit for faster calculation
+  scaledcolor = (((r * scale) >> 8) << 16) + ((r && scale) ? 1 : 0);
+  scaledcolor |= (((g * scale) >> 8) << 8) + ((g && scale) ? 1 : 0);
+  scaledcolor |= ((b * scale) >> 8) + ((b && scale) ? 1 : 0);
+  scaledcolor |= (((w * scale) >> 8) << 24) + ((w && scale) ? 1 : 0);
+  return scaledcolor;
+}
+
+/*
+ * span versions of the above, operate on n consecutive colors (dst may be the same as source)
+ */
+void blend_span(uint32_t *dst, const uint32_t *a, const uint32_t *b, size_t n, uint16_t blend, bool b16)
+{
+  if (!b16 && blend > 0 && blend < 255) {
+    for (size_t i = 0; i < n; i++) dst[i] = swar_blend8(a[i], b[i], blend);
+  } else {
+    for (size_t i = 0; i < n; i++) dst[i] = color_blend(a[i], b[i], blend, b16);
   }
 }
 
+void fade_span(uint32_t *dst, const uint32_t *src, size_t n, uint8_t amount)
+{
+  if (amount == 255) { if (dst != src) memmove(dst, src, n * sizeof(uint32_t)); return; }
+  const uint32_t scale = 1 + amount;
+  for (size_t i = 0; i < n; i++) dst[i] = swar_scale(src[i], scale);
+}
+
+void add_span(uint32_t *dst, const uint32_t *a, const uint32_t *b, size_t n, bool fast)
+{
+  swar_add_span(dst, a, b, n, fast);
+}
+
 void setRandomColor(byte* rgb)
 {
   lastRandomIndex = get_random_wheel_index(lastRandomIndex);
@@ -0,0 +1,78 @@
+#ifndef WLED_DDP_QUEUE_H
+#define WLED_DDP_QUEUE_H
+
+/*
+ * Presentation schedule of DDP frames carrying a timecode (used by e131.cpp, frame data lives there)
+ * Frames are received into one of SLOTS slots, completed frames wait in their slot until their timecode is reached.
+ * Timecodes are NTP 16.16 (lower 16 bits of seconds, upper 16 bits of fraction) and wrap every 18 hours.
+ * Depends only on <stdint.h> so network jitter can be simulated on host (test/test_ddp_queue).
+ */
+
+#include <stdint.h>
+
+#define DDP_MAX_PRESENT_DELAY 1000  // ms; timecodes further off are considered unsynchronized and presented at once
+
+// milliseconds until timecode (negative if already due)
+static inline int32_t ddpMsUntil(uint32_t timecode, uint32_t now) {
+  return (int64_t(int32_t(timecode - now)) * 1000) >> 16;
+}
+
+template <unsigned SLOTS>
+class DDPSchedule {
+  public:
+    uint32_t timecode[SLOTS];
+    uint8_t  queued = 0;    // bitmap of slots waiting for presentation
+    uint8_t  receiving = 0; // slot incoming data is written to
+    bool     presented = false;
+    uint32_t lastPresented = 0; // timecode of last frame returned by due()
+
+    inline void reset() { queued = 0; receiving = 0; presented = false; }
+
+    // queues frame in receiving slot for presentation at tc, returns slot next frame is received into
+    // (caller copies completed frame into it, DDP allows partial updates); dropped is set to -1 or slot of a frame dropped
+    // because all slots were in use (the one due first, other than the one just queued)
+    unsigned push(uint32_t tc, uint32_t now, int &dropped) {
+      const unsigned cur = receiving;
+      timecode[cur] = tc;
+      queued |= 1 << cur;
+      int next = -1;
+      dropped = -1;
+      for (unsigned i = 0; i < SLOTS; i++) if (!(queued & (1 << i))) { next = i; break; }
+      if (next < 0) {
+        for (unsigned i = 0; i < SLOTS; i++) {
+          if (i == cur) continue;
+          if (next < 0 || ddpMsUntil(timecode[i], now) < ddpMsUntil(timecode[next], now)) next = i;
+        }
+        queued &= ~(1 << next);
+        dropped = next;
+      }
+      receiving = next;
+      return next;
+    }
+
+    // returns slot of latest frame whose timecode has been reached (or that is too far off to wait for) and dequeues it,
+    // older due frames and frames older than the one presented last (reordered by the network) are dropped; -1 if nothing is due
+    int due(uint32_t now) {
+      int d = -1;
+      for (unsigned i = 0; i < SLOTS; i++) {
+        if (!(queued & (1 << i))) continue;
+        if (presented) {
+          int32_t age = ddpMsUntil(timecode[i], lastPresented);
+          if (age < 0 && age >= -DDP_MAX_PRESENT_DELAY) { queued &= ~(1 << i); continue; } // larger jumps back: sender restarted
+        }
+        int32_t wait = ddpMsUntil(timecode[i], now);
+        if (wait > 0 && wait <= DDP_MAX_PRESENT_DELAY) continue; // not yet
+        if (d >= 0 && ddpMsUntil(timecode[i], timecode[d]) < 0) { queued &= ~(1 << i); continue; } // older than another due frame
+        if (d >= 0) queued &= ~(1 << d);
+        d = i;
+      }
+      if (d >= 0) {
+        queued &= ~(1 << d);
+        presented = true;
+        lastPresented = timecode[d];
+      }
+      return d;
+    }
+};
+
+#endif
@@ -1,17 +1,97 @@
 #include "wled.h"
+#include "ddp_queue.h"
 
 #define MAX_3_CH_LEDS_PER_UNIVERSE 170
 #define MAX_4_CH_LEDS_PER_UNIVERSE 128
 #define MAX_CHANNELS_PER_UNIVERSE 512
 
+#ifndef E131_FRAME_TIMEOUT
+  #define E131_FRAME_TIMEOUT 25   // ms to wait for missing universes before an incomplete frame is shown
+#endif
+#define E131_SYNC_TIMEOUT 4000    // ms without sync packet after which frames are shown as soon as they are complete
+
+static_assert(E131_MAX_UNIVERSE_COUNT <= 32, "E1.31 universe bitmap is limited to 32 universes");
+
+// assembly of frames spanning multiple universes
+static uint32_t      frameUniverses = 0; // universes (bit 0 = e131Universe) received for the frame being assembled
+static unsigned long frameStart = 0;     // arrival of first universe of the frame being assembled
+static unsigned long lastSync = 0;       // arrival of last E1.31 synchronization or ArtSync packet
+static bool          frameHeld = false;  // complete frame waiting for sync packet
+static uint32_t      lastFrameUniverses = 0; // universes the previous frame consisted of (0: not known yet)
+static uint16_t      syncUniverse = 0;   // E1.31 synchronization address requested by data packets
+
 /*
  * E1.31 handler
  */
 
+#define DDP_QUEUE_SLOTS 3           // frame being received + frames waiting for their timecode
+
+// DDP frames carrying a timecode are collected in slots and presented when their time has come
+static struct {
+  uint8_t *data = nullptr;            // DDP_QUEUE_SLOTS frames of frameLen*4 bytes
+  unsigned frameLen = 0;              // LEDs per frame
+  uint8_t  channels[DDP_QUEUE_SLOTS];
+  DDPSchedule<DDP_QUEUE_SLOTS> schedule;
+} ddpQueue;
+
+// current time as DDP timecode
+static uint32_t ddpTimecodeNow() {
+  Toki::Time t = toki.getTime();
+  return ((t.sec + YEARS_70) << 16) | ((uint32_t(t.ms) << 16) / 1000);
+}
+
+static void ddpQueueRelease() {
+  free(ddpQueue.data);
+  ddpQueue.data = nullptr;
+  ddpQueue.schedule.reset();
+}
+
+// allocates queue for current LED count, returns false if frames can not be buffered
+static bool ddpQueueReady() {
+  unsigned len = strip.getLengthTotal();
+  if (ddpQueue.data && ddpQueue.frameLen == len) return true;
+  ddpQueueRelease();
+  ddpQueue.data = (uint8_t*)calloc(DDP_QUEUE_SLOTS, len * 4);
+  if (!ddpQueue.data) {
+    DEBUG_PRINTLN(F("DDP: no memory for timecode queue."));
+    return false;
+  }
+  ddpQueue.frameLen = len;
+  ddpQueue.schedule.reset();
+  ddpQueue.channels[0] = 3;
+  return true;
+}
+
+static inline uint8_t *ddpQueueSlot(unsigned i) { return ddpQueue.data + i * ddpQueue.frameLen * 4; }
+
+// completed frame is queued for presentation at its timecode, next frame starts as a copy of it (DDP allows partial updates)
+static void ddpQueuePush(uint32_t timecode) {
+  const unsigned cur = ddpQueue.schedule.receiving;
+  int dropped;
+  const unsigned next = ddpQueue.schedule.push(timecode, ddpTimecodeNow(), dropped);
+  if (dropped >= 0) DEBUG_PRINTLN(F("DDP: queue full, frame dropped."));
+  memcpy(ddpQueueSlot(next), ddpQueueSlot(cur), ddpQueue.frameLen * 4);
+  ddpQueue.channels[next] = ddpQueue.channels[cur];
+}
+
+// called from main loop: presents the latest frame whose timecode has been reached
+void handleDDPQueue() {
+  if (!ddpQueue.data) return;
+  if (realtimeMode != REALTIME_MODE_DDP) { ddpQueueRelease(); return; }
+  if (!ddpQueue.schedule.queued) return;
+  const int due = ddpQueue.schedule.due(ddpTimecodeNow());
+  if (due < 0) return;
+  if (!realtimeOverride || (realtimeMode && useMainSegmentOnly)) {
+    setRealtimePixels(0, ddpQueue.frameLen, ddpQueueSlot(due), ddpQueue.channels[due]);
+  }
+  strip.show(); // no rate limiting, nodes presenting the same timecode should flip together
+}
+
 //DDP protocol support, called by handleE131Packet
 //handles RGB data only
 void handleDDPPacket(e131_packet_t* p) {
   static bool ddpSeenPush = false;  // have we seen a push yet?
+  static bool ddpSeenTimecode = false; // sender provides presentation times
   int lastPushSeq = e131LastSequenceNumber[0];
 
   //reject late packets belonging to previous frame (assuming 4 packets max. before push)
@@ -33,18 +113,38 @@ void handleDDPPacket(e131_packet_t* p) {
   unsigned stop = start + htons(p->dataLen) / ddpChannelsPerLed;
   uint8_t* data = p->data;
   unsigned c = 0;
-  if (p->flags & DDP_TIMECODE_FLAG) c = 4; //packet has timecode flag, we do not support it, but data starts 4 bytes later
+  uint32_t timecode = 0;
+  if (p->flags & DDP_TIMECODE_FLAG) { //packet has timecode, data starts 4 bytes later
+    timecode = (uint32_t(data[0]) << 24) | (uint32_t(data[1]) << 16) | (uint32_t(data[2]) << 8) | data[3];
+    c = 4;
+  }
 
-  if (realtimeMode != REALTIME_MODE_DDP) ddpSeenPush = false; // just starting, no push yet
+  if (realtimeMode != REALTIME_MODE_DDP) ddpSeenPush = ddpSeenTimecode = false; // just starting, no push yet
   realtimeLock(realtimeTimeoutMs, REALTIME_MODE_DDP);
 
-  if (!realtimeOverride || (realtimeMode && useMainSegmentOnly)) {
-    for (unsigned i = start; i < stop; i++, c += ddpChannelsPerLed) {
-      setRealtimePixel(i, data[c], data[c+1], data[c+2], ddpChannelsPerLed >3 ? data[c+3] : 0);
+  bool push = p->flags & DDP_PUSH_FLAG;
+  ddpSeenTimecode |= (timecode != 0);
+
+  // timecoded frames are buffered and presented by handleDDPQueue(), this requires millisecond accurate (NTP) time
+  if (ddpSeenTimecode && toki.getTimeSource() > 99 && ddpQueueReady()) {
+    const unsigned len = ddpQueue.frameLen;
+    if (start < len) {
+      if (stop > len) stop = len;
+      ddpQueue.channels[ddpQueue.schedule.receiving] = ddpChannelsPerLed;
+      memcpy(ddpQueueSlot(ddpQueue.schedule.receiving) + start * ddpChannelsPerLed, data + c, (stop - start) * ddpChannelsPerLed);
+    }
+    if (push) {
+      ddpQueuePush(timecode ? timecode : ddpTimecodeNow()); // push without timecode is due now
+      int sn = p->sequenceNum & 0xF;
+      if (sn) e131LastSequenceNumber[0] = sn;
     }
+    return;
+  }
+
+  if (!realtimeOverride || (realtimeMode && useMainSegmentOnly)) {
+    if (stop > start) setRealtimePixels(start, stop - start, data + c, ddpChannelsPerLed);
   }
 
-  bool push = p->flags & DDP_PUSH_FLAG;
   ddpSeenPush |= push;
   if (!ddpSeenPush || push) { // if we've never seen a push, or this is one, render display
     e131NewData = true;
@@ -53,6 +153,59 @@ void handleDDPPacket(e131_packet_t* p) {
   }
 }
 
+// bitmap of universes (relative to e131Universe) needed to cover all LEDs, upper bound for one frame
+static uint32_t configuredUniverses() {
+  if (DMXMode != DMX_MODE_MULTIPLE_RGB && DMXMode != DMX_MODE_MULTIPLE_DRGB && DMXMode != DMX_MODE_MULTIPLE_RGBW) return 1;
+  const bool is4Chan = (DMXMode == DMX_MODE_MULTIPLE_RGBW);
+  const unsigned dmxChannelsPerLed = is4Chan ? 4 : 3;
+  const unsigned ledsPerUniverse = is4Chan ? MAX_4_CH_LEDS_PER_UNIVERSE : MAX_3_CH_LEDS_PER_UNIVERSE;
+  const unsigned dmxLenOffset = (DMXAddress == 0) ? 0 : 1;
+  const unsigned dimmerOffset = (DMXMode == DMX_MODE_MULTIPLE_DRGB) ? 1 : 0;
+  const unsigned totalLen = strip.getLengthTotal();
+  unsigned leds = (((MAX_CHANNELS_PER_UNIVERSE - DMXAddress) + dmxLenOffset) - dimmerOffset) / dmxChannelsPerLed;
+  unsigned n = 1;
+  while (leds < totalLen && n < E131_MAX_UNIVERSE_COUNT) { leds += ledsPerUniverse; n++; }
+  return n < 32 ? (1UL << n) - 1 : 0xFFFFFFFFUL;
+}
+
+// senders often cover fewer LEDs than configured, so a frame is expected to consist of the universes
+// the previous frame consisted of; it is learned whenever a frame ends (universe repeated, timeout)
+static inline uint32_t expectedUniverses() {
+  return lastFrameUniverses ? lastFrameUniverses : configuredUniverses();
+}
+
+static inline bool isSynchronized() {
+  return lastSync && millis() - lastSync < E131_SYNC_TIMEOUT;
+}
+
+// E1.31 synchronization or ArtSync packet: show whatever has been received
+static void handleSyncPacket() {
+  lastSync = millis() | 1; // never 0
+  if (frameUniverses) lastFrameUniverses = frameUniverses; // frame was not complete: sender covers fewer universes
+  frameUniverses = 0;
+  frameHeld = false;
+  e131Frames[2]++;
+  e131NewData = true;
+}
+
+// called from main loop: shows frames that can not be completed (missing universes or sync packets stopped)
+void handleE131Frame() {
+  // E1.31 sync packets are sent to the multicast group of the synchronization address (E1.31: 6.6.1)
+  if (e131Multicast) e131.joinUniverse(syncUniverse);
+  if (isSynchronized()) return;
+  if (frameHeld) {
+    frameHeld = false;
+    e131Frames[0]++;
+    e131NewData = true;
+  }
+  if (frameUniverses && millis() - frameStart > E131_FRAME_TIMEOUT) {
+    lastFrameUniverses = frameUniverses; // sender covers fewer universes than expected
+    frameUniverses = 0;
+    e131Frames[1]++;
+    e131NewData = true;
+  }
+}
+
 //E1.31 and Art-Net protocol support
 void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
 
@@ -66,12 +219,22 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
       handleArtnetPollReply(clientIP);
       return;
     }
+    if (p->art_opcode == ARTNET_OPCODE_OPSYNC) {
+      // ArtSync is broadcast: only act on it while receiving Art-Net data from the same controller
+      if (realtimeMode == REALTIME_MODE_ARTNET && clientIP == realtimeIP) handleSyncPacket();
+      return;
+    }
     uni = p->art_universe;
     dmxChannels = htons(p->art_length);
     e131_data = p->art_data;
     seq = p->art_sequence_number;
     mde = REALTIME_MODE_ARTNET;
   } else if (protocol == P_E131) {
+    if (htonl(p->root_vector) == E131_VECTOR_ROOT_EXTENDED) {
+      // only act on synchronization packets for the address our data packets refer to
+      if (syncUniverse && htons(p->sync_universe) == syncUniverse) handleSyncPacket();
+      return;
+    }
     // Ignore PREVIEW data (E1.31: 6.2.6)
     if ((p->options & 0x80) != 0) return;
     dmxChannels = htons(p->property_value_count) - 1;
@@ -106,6 +269,14 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
 
   unsigned previousUniverses = uni - e131Universe;
 
+  // statistics (Art-Net sequence 0 means sequencing is disabled, Art-Net sequence wraps from 255 to 1)
+  if (e131Packets[previousUniverses]++ && (protocol == P_E131 || seq)) {
+    int diff = int8_t(seq - e131LastSequenceNumber[previousUniverses]);
+    if (protocol == P_ARTNET && seq < e131LastSequenceNumber[previousUniverses]) diff--;
+    if (diff > 1)       e131Dropped[previousUniverses] += diff - 1;
+    else if (diff <= 0) e131OutOfOrder[previousUniverses]++;
+  }
+
   if (e131SkipOutOfSequence)
     if (seq < e131LastSequenceNumber[previousUniverses] && seq > 20 && e131LastSequenceNumber[previousUniverses] < 250){
       DEBUG_PRINT(F("skipping E1.31 frame (last seq="));
@@ -119,6 +290,22 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
     }
   e131LastSequenceNumber[previousUniverses] = seq;
 
+  if (protocol == P_E131) syncUniverse = htons(p->sync_address);
+
+  // frame assembly: a universe arriving a second time means the previous frame will never be completed
+  uint32_t expected = expectedUniverses();
+  const uint32_t universeBit = 1UL << previousUniverses;
+  if (configuredUniverses() & universeBit) {
+    if (frameUniverses & universeBit) {
+      lastFrameUniverses = expected = frameUniverses; // frame consisted of other universes than expected
+      frameUniverses = 0;
+      e131Frames[1]++;
+      if (!isSynchronized()) e131NewData = true;
+    }
+    if (!frameUniverses) frameStart = millis();
+    frameUniverses |= universeBit;
+  }
+
   // update status info
   realtimeIP = clientIP;
   byte wChannel = 0;
@@ -314,17 +501,7 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
           }
         }
 
-        if (!is4Chan) {
-          for (unsigned i = previousLeds; i < ledsTotal; i++) {
-            setRealtimePixel(i, e131_data[dmxOffset], e131_data[dmxOffset+1], e131_data[dmxOffset+2], 0);
-            dmxOffset+=3;
-          }
-        } else {
-          for (unsigned i = previousLeds; i < ledsTotal; i++) {
-            setRealtimePixel(i, e131_data[dmxOffset], e131_data[dmxOffset+1], e131_data[dmxOffset+2], e131_data[dmxOffset+3]);
-            dmxOffset+=4;
-          }
-        }
+        if (ledsTotal > previousLeds) setRealtimePixels(previousLeds, ledsTotal - previousLeds, e131_data + dmxOffset, dmxChannelsPerLed);
         break;
       }
     default:
@@ -333,7 +510,14 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
       break;
   }
 
-  e131NewData = true;
+  if (frameUniverses == expected) { // all universes of the frame arrived
+    frameUniverses = 0;
+    if (isSynchronized()) frameHeld = true; // wait for sync packet
+    else {
+      e131Frames[0]++;
+      e131NewData = true;
+    }
+  }
 }
 
 void handleArtnetPollReply(IPAddress ipAddress) {
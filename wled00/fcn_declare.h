@@ -81,6 +81,9 @@ class NeoGammaWLEDMethod {
 uint32_t color_blend(uint32_t,uint32_t,uint16_t,bool b16=false);
 uint32_t color_add(uint32_t,uint32_t, bool fast=false);
 uint32_t color_fade(uint32_t c1, uint8_t amount, bool video=false);
+void blend_span(uint32_t *dst, const uint32_t *a, const uint32_t *b, size_t n, uint16_t blend, bool b16=false); // dst[i] = color_blend(a[i], b[i], blend)
+void fade_span(uint32_t *dst, const uint32_t *src, size_t n, uint8_t amount);       // dst[i] = color_fade(src[i], amount)
+void add_span(uint32_t *dst, const uint32_t *a, const uint32_t *b, size_t n, bool fast=false); // dst[i] = color_add(a[i], b[i], fast)
 CRGBPalette16 generateHarmonicRandomPalette(CRGBPalette16 &basepalette);
 CRGBPalette16 generateRandomPalette(void);
 inline uint32_t colorFromRgbw(byte* rgbw) { return uint32_t((byte(rgbw[3]) << 24) | (byte(rgbw[0]) << 16) | (byte(rgbw[1]) << 8) | (byte(rgbw[2]))); }
@@ -101,6 +104,8 @@ void handleDMX();
 
 //e131.cpp
 void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol);
+void handleE131Frame();
+void handleDDPQueue();
 void handleArtnetPollReply(IPAddress ipAddress);
 void prepareArtnetPollReply(ArtPollReply* reply);
 void sendArtnetPollReply(ArtPollReply* reply, IPAddress ipAddress, uint16_t portAddress);
@@ -137,6 +142,7 @@ int fileReadBlockCallback(void * buffer, int numberOfBytes);
 int fileSizeCallback(void);
 byte renderImageToSegment(Segment &seg);
 void endImagePlayback(Segment* seg);
+void serializeImageStats(JsonObject root);
 #endif
 
 //improv.cpp
@@ -257,6 +263,7 @@ void realtimeLock(uint32_t timeoutMs, byte md = REALTIME_MODE_GENERIC);
 void exitRealtime();
 void handleNotifications();
 void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w);
+void setRealtimePixels(unsigned i, unsigned count, const uint8_t *data, unsigned channelsPerLed);
 void refreshNodeList();
 void sendSysInfoUDP();
 #ifndef WLED_DISABLE_ESPNOW
@@ -416,26 +423,41 @@ void clearEEPROM();
 #endif
 
 //wled_math.cpp
+int16_t  sin16_t(uint16_t angle);          // angle: 0-65535 for full turn, returns -32767 to 32767
+int16_t  cos16_t(uint16_t angle);
+uint16_t atan2_16_t(int32_t y, int32_t x); // returns angle 0-65535 counterclockwise from positive X axis
+float sin_lut(float x);
+float cos_lut(float phi);
+float tan_lut(float x);
 #if defined(ESP8266) && !defined(WLED_USE_REAL_MATH)
   template <typename T> T atan_t(T x);
+  #ifndef WLED_USE_TRIG_LUT
   float cos_t(float phi);
   float sin_t(float x);
   float tan_t(float x);
+  #endif
   float acos_t(float x);
   float asin_t(float x);
   float floor_t(float x);
   float fmod_t(float num, float denom);
 #else
   #include <math.h>
+  #ifndef WLED_USE_TRIG_LUT
   #define sin_t sinf
   #define cos_t cosf
   #define tan_t tanf
+  #endif
   #define asin_t asinf
   #define acos_t acosf
   #define atan_t atanf
   #define fmod_t fmodf
   #define floor_t floorf
 #endif
+#ifdef WLED_USE_TRIG_LUT
+  #define sin_t sin_lut
+  #define cos_t cos_lut
+  #define tan_t tan_lut
+#endif
 
 //wled_serial.cpp
 void handleSerial();
@@ -0,0 +1,56 @@
+#ifndef WLED_FRAME_HANDOFF_H
+#define WLED_FRAME_HANDOFF_H
+
+/*
+ * Lock-free handoff of frames between a single producer (renderer) and a single consumer (output)
+ * running on different cores or threads (triple buffering).
+ *
+ * Producer always owns a buffer to render into and never waits, consumer always gets the newest
+ * complete frame (frames it did not pick up in time are dropped). The only shared state is the index
+ * of the middle buffer with a "fresh" flag which is exchanged atomically by both sides.
+ *
+ * Depends only on <atomic> so it can be exercised on host, i.e. one std::thread calling publish()
+ * after filling back() and another calling acquire() and reading front().
+ */
+
+#include <atomic>
+#include <stdint.h>
+
+template <typename T>
+class FrameHandoff {
+  public:
+    FrameHandoff(T *a, T *b, T *c) : _back(0), _front(1), _middle(2) { _buf[0] = a; _buf[1] = b; _buf[2] = c; }
+
+    // producer: buffer to render next frame into
+    inline T *back() const { return _buf[_back]; }
+
+    // producer: hands over rendered back buffer, returns buffer to render next frame into
+    T *publish() {
+      _back = _middle.exchange(_back | FRESH, std::memory_order_acq_rel) & INDEX;
+      return _buf[_back];
+    }
+
+    // consumer: returns true if a new frame was published since last call, front() then holds it
+    bool acquire() {
+      if (!(_middle.load(std::memory_order_acquire) & FRESH)) return false;
+      _front = _middle.exchange(_front, std::memory_order_acq_rel) & INDEX;
+      return true;
+    }
+
+    // consumer: last acquired frame
+    inline T *front() const { return _buf[_front]; }
+
+    // buffer as passed to constructor (i.e. for releasing memory once both sides stopped)
+    inline T *buffer(unsigned n) const { return _buf[n]; }
+
+  private:
+    static const uint32_t INDEX = 0x03;
+    static const uint32_t FRESH = 0x04;
+
+    T *_buf[3];
+    uint32_t _back;                 // only touched by producer
+    uint32_t _front;                // only touched by consumer
+    std::atomic<uint32_t> _middle;  // shared: index of middle buffer | FRESH
+};
+
+#endif
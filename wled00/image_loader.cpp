@@ -7,60 +7,514 @@
 
 /*
  * Functions to render images from filesystem to segments, used by the "Image" effect
+ *
+ * Each segment playing an image gets its own context (decoder, file, canvas, frame cache).
+ * Context and canvas memory is accounted against segment data (MAX_SEGMENT_DATA, canvas only if not in PSRAM).
+ * Decoders are accounted with a fixed footprint (IMAGE_DECODER_SIZE).
+ * Number of concurrently decoded images is limited by WLED_MAX_IMAGE_SEGMENTS (WLED_MAX_IMAGE_SEGMENTS_NO_PSRAM without PSRAM).
+ * Canvas and raw frames are drawn a row at a time (Segment::setPixelRowXY()).
+ * If there is no memory for a canvas GIF rows are drawn to the segment as they are decoded (no frame cache/conversion).
+ *
+ * Supported formats:
+ *  .gif  - decoded on the fly, scaled to segment size
+ *  .wfs  - WLED frame sequence: frames already scaled and gamma corrected, raw or RLE encoded
+ *          (little endian, 24 byte header followed by frames)
+ *            0: "WFS2", 4: width (16), 6: height (16), 8: frame count (16), 10: flags (bit 0: gamma corrected),
+ *           11: gamma * 10, 12: offset of first looping frame (32), 16: size of source GIF (32),
+ *           20: last write time of source GIF (32, 0 if file system has none)
+ *          each frame: delay in ms (16), encoding (8, 0 = RGB, 1 = RLE count+RGB), payload length (32), payload
+ *          When a GIF has played a complete loop it is converted to <name>.wfs which is used on subsequent
+ *          playback of the same GIF (same size and time) at the same segment size and gamma (disable with
+ *          WLED_DISABLE_IMAGE_CONVERT). Uploading a GIF removes its converted file.
+ *  .fseq - xLights sequence (v1 or uncompressed v2), 3 channels per pixel starting at channel 1
  */
 
-File file;
-char lastFilename[34] = "/";
-GifDecoder<320,320,12,true> decoder;
-bool gifDecodeFailed = false;
-unsigned long lastFrameDisplayTime = 0, currentFrameDelay = 0;
+#ifndef IMAGE_READ_BUFFER_SIZE
+  #define IMAGE_READ_BUFFER_SIZE 512          // bytes read from FS at once
+#endif
+#ifndef IMAGE_CACHE_MAX_SIZE
+  #define IMAGE_CACHE_MAX_SIZE (1024*1024)    // max. PSRAM used for decoded frames of one image
+#endif
+#ifdef ESP8266
+  #define WLED_DISABLE_IMAGE_CONVERT          // not enough RAM/FS
+#endif
+#ifndef IMAGE_MAX_DROP
+  #define IMAGE_MAX_DROP 4                    // max. frames decoded without drawing in one call when behind
+#endif
+#ifndef IMAGE_RESYNC_TIME
+  #define IMAGE_RESYNC_TIME 1000              // ms behind timeline after which it is restarted instead of catching up
+#endif
+#ifndef WLED_MAX_IMAGE_SEGMENTS
+  #ifdef ESP8266
+    #define WLED_MAX_IMAGE_SEGMENTS 1
+  #else
+    #define WLED_MAX_IMAGE_SEGMENTS 4
+  #endif
+#endif
+
+#ifndef WLED_MAX_IMAGE_SEGMENTS_NO_PSRAM
+  #define WLED_MAX_IMAGE_SEGMENTS_NO_PSRAM 2  // decoders and canvases compete with segment buffers for internal RAM
+#endif
+
+#define IMAGE_LZW_BITS 12
+typedef GifDecoder<320,320,IMAGE_LZW_BITS,true> gif_decoder_t;
+// memory taken by a decoder: the object and LZW tables allocated by alloc() (stack and suffix bytes, prefix words)
+#define IMAGE_DECODER_TABLE_SIZE ((1 << IMAGE_LZW_BITS) * sizeof(uint16_t)) // largest table
+#define IMAGE_DECODER_TABLES     ((1 << IMAGE_LZW_BITS) * 4)
+#define IMAGE_DECODER_SIZE       (sizeof(gif_decoder_t) + IMAGE_DECODER_TABLES)
+
+// decoded frame cache (PSRAM only): after the first loop of an animation frames are played from memory
+// frames are identified by decoder input position at which their decoding started, when a known
+// position is seen again the animation has looped and decoding stops
+typedef struct CachedFrame {
+  uint16_t delay;   // frame delay in ms
+  uint8_t *rgb;     // canvas snapshot (3 bytes per pixel)
+} cached_frame_t;
+
+typedef struct FrameCache {
+  std::vector<cached_frame_t> frames;
+  char     filename[33] = "";
+  uint16_t width = 0, height = 0;
+  size_t   size = 0;
+  int      loopStart = -1; // >= 0 if cache contains complete animation (index of first looping frame)
+
+  ~FrameCache() { for (cached_frame_t &f : frames) free(f.rgb); }
+} frame_cache_t;
+
+#define IMAGE_FORMAT_GIF  0
+#define IMAGE_FORMAT_WFS  1
+#define IMAGE_FORMAT_FSEQ 2
+
+#define WFS_HEADER_SIZE       24
+#define WFS_FLAG_GAMMA        0x01
+#define WFS_FRAME_HEADER_SIZE 7
+#define WFS_ENCODING_RGB      0
+#define WFS_ENCODING_RLE      1
+
+typedef struct FramePos {
+  uint32_t gifPos;  // decoder input position before the frame was decoded
+  uint32_t wfsPos;  // offset of the frame in converted file
+} frame_pos_t;
+
+typedef struct ImageContext {
+  Segment       *seg = nullptr;
+  gif_decoder_t *decoder = nullptr;       // released once animation is cached
+  File           file;
+  char           filename[34] = "/";
+  bool           decodeFailed = false;
+  bool           deferred = false;        // frame was postponed due to decode budget
+  unsigned long  nextFrameTime = 0;       // animation timeline: when next frame is due (ms)
+  uint32_t       framesShown = 0, framesDropped = 0, framesLate = 0;
+  uint16_t       gifWidth = 0, gifHeight = 0;
+  uint8_t        format = IMAGE_FORMAT_GIF;
+  uint16_t       segWidth = 0, segHeight = 0; // segment size image was started with
+  uint32_t       sourceSize = 0;          // size of GIF file
+  uint32_t       sourceTime = 0;          // last write time of GIF file
+  size_t         accounted = 0;           // bytes added to Segment::_usedSegmentData (excluding context itself)
+
+  // buffered file access (decoder reads LZW stream byte by byte which is very slow on LittleFS)
+  uint8_t        readBuf[IMAGE_READ_BUFFER_SIZE];
+  uint32_t       readBufPos = 0;          // file position of readBuf[0]
+  uint16_t       readBufLen = 0;          // number of valid bytes in readBuf
+  uint32_t       readPos    = 0;          // position of next byte decoder will read
+
+  // decoded image scaled to (virtual) segment size and gamma corrected; persists between frames as GIF frames may update only part of the image
+  uint32_t      *canvas = nullptr;          // nullptr: rows are drawn directly to segment
+  uint16_t       canvasWidth = 0, canvasHeight = 0;
+  bool           canvasInPSRAM = false;
+
+  // decoder delivers pixels row by row, rows are collected and scaled as a whole instead of per pixel
+  // nearest neighbour is used for upscaling, area averaging if image is larger than segment in both dimensions
+  uint8_t       *rowBuf = nullptr;        // single allocation holding all of the below
+  uint32_t      *rowAcc;                  // area averaging: R,G,B sums and pixel count per canvas pixel of current canvas row
+  uint16_t      *rowXMap;                 // nearest: canvas x -> GIF x, area averaging: GIF x -> canvas x
+  uint8_t       *rowRGB;                  // current GIF row
+  uint8_t       *rowValid;                // bitmap of pixels set in current GIF row (transparent pixels are not drawn)
+  size_t         rowBufLen = 0;
+  uint16_t       rowValidCount = 0;
+  int16_t        rowY = -1, accY = -1;    // GIF row being collected, canvas row being averaged
+  uint16_t       mapGifW = 0, mapGifH = 0, mapCanvasW = 0, mapCanvasH = 0;
+  bool           areaAverage = false;
+
+  frame_cache_t *cache = nullptr;
+  int            cachePlayIndex = -1;     // >= 0 when playing from cache (index of next frame)
+  bool           cacheRecording = false;
+  std::vector<frame_pos_t> framePos;      // frames of first loop, used to detect when GIF loops
+
+  // raw frame playback (.wfs, .fseq)
+  uint16_t       rawWidth = 0, rawHeight = 0;
+  uint32_t       dataStart = 0;           // .wfs: offset of first looping frame, .fseq: offset of channel data
+  uint32_t       frameSize = 0;           // .fseq: channels per frame
+  uint32_t       frameCount = 0, frameIndex = 0;
+  uint8_t        stepTime = 0;            // .fseq: frame time in ms
+
+  // conversion of GIF to .wfs
+  File           convFile;
+  uint32_t       convPos = 0;             // bytes written
+} image_context_t;
+
+static image_context_t *images[WLED_MAX_IMAGE_SEGMENTS] = {nullptr};
+static image_context_t *ctx = nullptr;       // context being decoded, decoder callbacks do not carry a user pointer
+static frame_cache_t   *keptCache = nullptr; // complete animation of last ended playback, reused if same image is started again
+
+// frame scheduling of current call
+static unsigned long frameNow = 0;        // ms
+static uint32_t      delayScale = 256;    // frame delay multiplier (x256) derived from segment speed
+static bool          allowDrop = false;
+
+// decode time budget per strip frame shared by all image segments
+static unsigned long budgetFrame = 0;     // strip.now of current budget period
+static uint32_t      budgetUsed = 0;      // us
+
+// memory accounting against segment data
+static bool accountMemory(size_t len) {
+  if (Segment::getUsedSegmentData() + len > MAX_SEGMENT_DATA) {
+    DEBUG_PRINTF_P(PSTR("Image: no segment data for %u bytes (%u used).\n"), (unsigned)len, (unsigned)Segment::getUsedSegmentData());
+    errorFlag = ERR_NORAM;
+    return false;
+  }
+  Segment::addUsedSegmentData(len);
+  ctx->accounted += len;
+  return true;
+}
+
+static void releaseMemory(size_t len) {
+  if (len > ctx->accounted) len = ctx->accounted;
+  Segment::addUsedSegmentData(-(int)MIN(len, (size_t)Segment::getUsedSegmentData()));
+  ctx->accounted -= len;
+}
+
+static bool fillReadBuffer(void) {
+  if (ctx->file.position() != ctx->readPos) ctx->file.seek(ctx->readPos);
+  ctx->readBufPos = ctx->readPos;
+  int len = ctx->file.read(ctx->readBuf, sizeof(ctx->readBuf));
+  ctx->readBufLen = len > 0 ? len : 0;
+  return ctx->readBufLen > 0;
+}
 
 bool fileSeekCallback(unsigned long position) {
-  return file.seek(position);
+  ctx->readPos = position;
+  if (position >= ctx->readBufPos && position <= ctx->readBufPos + ctx->readBufLen) return true; // still within buffer
+  ctx->readBufPos = position;
+  ctx->readBufLen = 0;
+  return ctx->file.seek(position);
 }
 
 unsigned long filePositionCallback(void) {
-  return file.position();
+  return ctx->readPos;
 }
 
 int fileReadCallback(void) {
-  return file.read();
+  if (ctx->readPos >= ctx->readBufPos + ctx->readBufLen && !fillReadBuffer()) return -1;
+  return ctx->readBuf[ctx->readPos++ - ctx->readBufPos];
 }
 
 int fileReadBlockCallback(void * buffer, int numberOfBytes) {
-  return file.read((uint8_t*)buffer, numberOfBytes);
+  uint8_t *dst = (uint8_t*)buffer;
+  int total = 0;
+  while (numberOfBytes > 0) {
+    unsigned avail = ctx->readBufPos + ctx->readBufLen - ctx->readPos;
+    if (avail == 0) {
+      if (numberOfBytes >= (int)sizeof(ctx->readBuf)) { // large block, bypass buffer
+        if (ctx->file.position() != ctx->readPos) ctx->file.seek(ctx->readPos);
+        int len = ctx->file.read(dst, numberOfBytes);
+        if (len <= 0) break;
+        ctx->readPos += len;
+        ctx->readBufPos = ctx->readPos;
+        ctx->readBufLen = 0;
+        total += len;
+        break;
+      }
+      if (!fillReadBuffer()) break;
+      avail = ctx->readBufLen;
+    }
+    unsigned len = MIN((unsigned)numberOfBytes, avail);
+    memcpy(dst, ctx->readBuf + (ctx->readPos - ctx->readBufPos), len);
+    ctx->readPos += len;
+    dst += len;
+    total += len;
+    numberOfBytes -= len;
+  }
+  return total;
 }
 
 int fileSizeCallback(void) {
-  return file.size();
+  return ctx->file.size();
 }
 
 bool openGif(const char *filename) {
-  file = WLED_FS.open(filename, "r");
+  ctx->file = WLED_FS.open(filename, "r");
+  ctx->readPos = ctx->readBufPos = ctx->readBufLen = 0;
 
-  if (!file) return false;
+  if (!ctx->file) return false;
   return true;
 }
 
-Segment* activeSeg;
-uint16_t gifWidth, gifHeight;
+static void freeCanvasBuffer(void) {
+  if (ctx->canvas && !ctx->canvasInPSRAM) releaseMemory(ctx->canvasWidth * ctx->canvasHeight * sizeof(uint32_t));
+  free(ctx->canvas);
+  ctx->canvas = nullptr;
+  ctx->canvasInPSRAM = false;
+}
 
-void screenClearCallback(void) {
-  activeSeg->fill(0);
+// sets up canvas of given size, if there is no memory for it (PSRAM or segment data) image is drawn directly to segment
+static void allocateCanvas(uint16_t width, uint16_t height) {
+  if (ctx->canvas && ctx->canvasWidth == width && ctx->canvasHeight == height) return;
+  freeCanvasBuffer();
+  ctx->canvasWidth  = width;
+  ctx->canvasHeight = height;
+  #if defined(ARDUINO_ARCH_ESP32)
+  if (psramSafe && psramFound()) {
+    ctx->canvas = (uint32_t*)ps_calloc(width * height, sizeof(uint32_t));
+    ctx->canvasInPSRAM = ctx->canvas != nullptr;
+    if (ctx->canvas) return;
+  }
+  #endif
+  size_t len = width * height * sizeof(uint32_t);
+  if (Segment::getUsedSegmentData() + len > MAX_SEGMENT_DATA) {
+    DEBUG_PRINTLN(F("Image: no segment data for canvas, drawing directly."));
+    return;
+  }
+  Segment::addUsedSegmentData(len);
+  ctx->accounted += len;
+  ctx->canvas = (uint32_t*)calloc(width * height, sizeof(uint32_t));
+  if (!ctx->canvas) {
+    releaseMemory(len);
+    DEBUG_PRINTLN(F("Image: no memory for canvas, drawing directly."));
+  }
 }
 
-void updateScreenCallback(void) {}
+// canvas row y, or segment row y if there is no canvas
+static inline void putCanvasPixel(unsigned x, unsigned y, uint32_t col) {
+  if (ctx->canvas) ctx->canvas[y * ctx->canvasWidth + x] = col;
+  else             ctx->seg->setPixelColorXY((int)x, (int)y, col);
+}
 
-void drawPixelCallback(int16_t x, int16_t y, uint8_t red, uint8_t green, uint8_t blue) {
-  // simple nearest-neighbor scaling 
-  int16_t outY = y * activeSeg->height() / gifHeight;
-  int16_t outX = x * activeSeg->width()  / gifWidth;
-  // set multiple pixels if upscaling
-  for (int16_t i = 0; i < (activeSeg->width()+(gifWidth-1)) / gifWidth; i++) {
-    for (int16_t j = 0; j < (activeSeg->height()+(gifHeight-1)) / gifHeight; j++) {
-      activeSeg->setPixelColorXY(outX + i, outY + j, gamma8(red), gamma8(green), gamma8(blue));
+static void freeRowScaling(void) {
+  if (!ctx->rowBuf) return;
+  releaseMemory(ctx->rowBufLen);
+  free(ctx->rowBuf);
+  ctx->rowBuf = nullptr;
+  ctx->rowBufLen = 0;
+  ctx->mapGifW = ctx->mapGifH = ctx->mapCanvasW = ctx->mapCanvasH = 0;
+}
+
+static bool prepareRowScaling(uint16_t gifW, uint16_t gifH) {
+  image_context_t &c = *ctx;
+  if (c.rowBuf && c.mapGifW == gifW && c.mapGifH == gifH && c.mapCanvasW == c.canvasWidth && c.mapCanvasH == c.canvasHeight) return true;
+  freeRowScaling();
+  if (!gifW || !gifH || !c.canvasWidth || !c.canvasHeight) return false;
+  c.areaAverage = gifW >= c.canvasWidth && gifH >= c.canvasHeight && (gifW > c.canvasWidth || gifH > c.canvasHeight);
+  size_t accLen = c.areaAverage ? c.canvasWidth * 4 : 0;
+  size_t mapLen = c.areaAverage ? gifW : c.canvasWidth;
+  size_t len = accLen * sizeof(uint32_t) + mapLen * sizeof(uint16_t) + gifW * 3 + (gifW + 7) / 8;
+  if (!accountMemory(len)) return false;
+  c.rowBuf = (uint8_t*)malloc(len);
+  if (!c.rowBuf) { releaseMemory(len); return false; }
+  c.rowBufLen = len;
+  c.rowAcc   = (uint32_t*)c.rowBuf;
+  c.rowXMap  = (uint16_t*)(c.rowBuf + accLen * sizeof(uint32_t));
+  c.rowRGB   = (uint8_t*)(c.rowXMap + mapLen);
+  c.rowValid = c.rowRGB + gifW * 3;
+  if (c.areaAverage) for (unsigned x = 0; x < gifW; x++) c.rowXMap[x] = x * c.canvasWidth / gifW;
+  else               for (unsigned x = 0; x < c.canvasWidth; x++) c.rowXMap[x] = x * gifW / c.canvasWidth;
+  memset(c.rowAcc, 0, accLen * sizeof(uint32_t));
+  memset(c.rowValid, 0, (gifW + 7) / 8);
+  c.rowValidCount = 0;
+  c.rowY = c.accY = -1;
+  c.mapGifW = gifW; c.mapGifH = gifH;
+  c.mapCanvasW = c.canvasWidth; c.mapCanvasH = c.canvasHeight;
+  return true;
+}
+
+// write averaged canvas row
+static void finishAccRow(void) {
+  image_context_t &c = *ctx;
+  if (c.accY < 0) return;
+  const uint32_t *acc = c.rowAcc;
+  for (unsigned x = 0; x < c.canvasWidth; x++, acc += 4) {
+    unsigned n = acc[3];
+    if (n) putCanvasPixel(x, c.accY, RGBW32(gamma8(acc[0] / n), gamma8(acc[1] / n), gamma8(acc[2] / n), 0));
+  }
+  memset(c.rowAcc, 0, c.canvasWidth * 4 * sizeof(uint32_t));
+  c.accY = -1;
+}
+
+// scale collected GIF row onto canvas
+static void flushRow(void) {
+  image_context_t &c = *ctx;
+  if (c.rowY < 0) return;
+  unsigned y = c.rowY;
+  c.rowY = -1;
+  if (c.rowValidCount == 0) return;
+  if (c.areaAverage) {
+    int dy = y * c.canvasHeight / c.mapGifH;
+    if (dy != c.accY) { finishAccRow(); c.accY = dy; }
+    for (unsigned x = 0; x < c.mapGifW; x++) {
+      if (!(c.rowValid[x >> 3] & (1 << (x & 7)))) continue;
+      uint32_t *acc = c.rowAcc + c.rowXMap[x] * 4;
+      acc[0] += c.rowRGB[3*x];
+      acc[1] += c.rowRGB[3*x+1];
+      acc[2] += c.rowRGB[3*x+2];
+      acc[3]++;
+    }
+  } else {
+    // canvas rows whose nearest GIF row is y
+    unsigned dyStart = (y * c.canvasHeight + c.mapGifH - 1) / c.mapGifH;
+    unsigned dyEnd   = ((y + 1) * c.canvasHeight + c.mapGifH - 1) / c.mapGifH;
+    if (dyEnd > c.canvasHeight) dyEnd = c.canvasHeight;
+    if (dyStart < dyEnd && !c.canvas) {
+      for (unsigned x = 0; x < c.canvasWidth; x++) {
+        unsigned sx = c.rowXMap[x];
+        if (!(c.rowValid[sx >> 3] & (1 << (sx & 7)))) continue;
+        uint32_t col = RGBW32(gamma8(c.rowRGB[3*sx]), gamma8(c.rowRGB[3*sx+1]), gamma8(c.rowRGB[3*sx+2]), 0);
+        for (unsigned dy = dyStart; dy < dyEnd; dy++) putCanvasPixel(x, dy, col);
+      }
+    } else if (dyStart < dyEnd) {
+      uint32_t *dst = c.canvas + dyStart * c.canvasWidth;
+      for (unsigned x = 0; x < c.canvasWidth; x++) {
+        unsigned sx = c.rowXMap[x];
+        if (!(c.rowValid[sx >> 3] & (1 << (sx & 7)))) continue;
+        dst[x] = RGBW32(gamma8(c.rowRGB[3*sx]), gamma8(c.rowRGB[3*sx+1]), gamma8(c.rowRGB[3*sx+2]), 0);
+      }
+      // replicate complete rows, partial rows have to be drawn separately as underlying pixels may differ
+      for (unsigned dy = dyStart + 1; dy < dyEnd; dy++) {
+        if (c.rowValidCount == c.mapGifW) memcpy(c.canvas + dy * c.canvasWidth, dst, c.canvasWidth * sizeof(uint32_t));
+        else for (unsigned x = 0; x < c.canvasWidth; x++) {
+          unsigned sx = c.rowXMap[x];
+          if (c.rowValid[sx >> 3] & (1 << (sx & 7))) c.canvas[dy * c.canvasWidth + x] = dst[x];
+        }
+      }
     }
   }
+  memset(c.rowValid, 0, (c.mapGifW + 7) / 8);
+  c.rowValidCount = 0;
+}
+
+// finish all pending rows of current frame
+static void flushFrame(void) {
+  if (!ctx->rowBuf) return;
+  flushRow();
+  if (ctx->areaAverage) finishAccRow();
+}
+
+static void freeCanvas(void) {
+  freeCanvasBuffer();
+  ctx->canvasWidth = ctx->canvasHeight = 0;
+  freeRowScaling();
+}
+
+static void blitCanvas(Segment &seg) {
+  if (!ctx->canvas) return; // already drawn while decoding
+  for (unsigned y = 0; y < ctx->canvasHeight; y++)
+    seg.setPixelRowXY(0, (int)y, ctx->canvas + y * ctx->canvasWidth, ctx->canvasWidth);
+}
+
+static void freeDecoder(void) {
+  if (ctx->file) ctx->file.close();
+  std::vector<frame_pos_t>().swap(ctx->framePos);
+  if (!ctx->decoder) return;
+  ctx->decoder->dealloc();
+  delete ctx->decoder;
+  ctx->decoder = nullptr;
+  releaseMemory(IMAGE_DECODER_SIZE);
+}
+
+static size_t freeHeap(void) {
+  #ifdef ARDUINO_ARCH_ESP32
+  return heap_caps_get_free_size(MALLOC_CAP_8BIT); // includes PSRAM malloc() may use
+  #else
+  return ESP.getFreeHeap();
+  #endif
+}
+
+static size_t largestFreeBlock(void) {
+  #ifdef ARDUINO_ARCH_ESP32
+  return heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+  #else
+  return ESP.getMaxFreeBlockSize();
+  #endif
+}
+
+// accounted decoder with LZW tables; alloc() does not report failure, so tables have to fit and have to be taken from heap
+static bool createDecoder(void) {
+  if (largestFreeBlock() < IMAGE_DECODER_TABLE_SIZE + sizeof(gif_decoder_t)) return false;
+  if (!accountMemory(IMAGE_DECODER_SIZE)) return false;
+  ctx->decoder = new(std::nothrow) gif_decoder_t();
+  if (!ctx->decoder) { releaseMemory(IMAGE_DECODER_SIZE); return false; }
+  size_t before = freeHeap();
+  ctx->decoder->alloc();
+  if (before < freeHeap() + IMAGE_DECODER_TABLES / 2) { // a table is missing (heap may change in between, so not exact)
+    DEBUG_PRINTLN(F("Image: decoder allocation failed."));
+    freeDecoder();
+    return false;
+  }
+  return true;
+}
+
+static void freeFrameCache(void) {
+  delete ctx->cache;
+  ctx->cache = nullptr;
+  ctx->cachePlayIndex = -1;
+  ctx->cacheRecording = false;
+}
+
+static void startFrameCache(const char *name) {
+  freeFrameCache();
+  #if defined(ARDUINO_ARCH_ESP32)
+  if (!psramSafe || !psramFound() || !ctx->canvas) return; // decoded frames are too large for internal RAM
+  ctx->cache = new(std::nothrow) frame_cache_t();
+  if (!ctx->cache) return;
+  strlcpy(ctx->cache->filename, name, sizeof(ctx->cache->filename));
+  ctx->cache->width  = ctx->canvasWidth;
+  ctx->cache->height = ctx->canvasHeight;
+  ctx->cacheRecording = true;
+  #endif
+}
+
+static void storeFrame(uint16_t delay) {
+  #if defined(ARDUINO_ARCH_ESP32)
+  frame_cache_t *cache = ctx->cache;
+  size_t len = ctx->canvasWidth * ctx->canvasHeight * 3;
+  uint8_t *rgb = (cache->size + len <= IMAGE_CACHE_MAX_SIZE) ? (uint8_t*)ps_malloc(len) : nullptr;
+  if (!rgb) { freeFrameCache(); return; } // animation does not fit, keep decoding from FS
+  for (unsigned i = 0; i < ctx->canvasWidth * ctx->canvasHeight; i++) {
+    rgb[3*i]   = R(ctx->canvas[i]);
+    rgb[3*i+1] = G(ctx->canvas[i]);
+    rgb[3*i+2] = B(ctx->canvas[i]);
+  }
+  cache->frames.push_back({delay, rgb});
+  cache->size += len;
+  #endif
+}
+
+static void loadFrame(const cached_frame_t &f) {
+  for (unsigned i = 0; i < ctx->canvasWidth * ctx->canvasHeight; i++) ctx->canvas[i] = RGBW32(f.rgb[3*i], f.rgb[3*i+1], f.rgb[3*i+2], 0);
+}
+
+static bool isCompleteCache(const frame_cache_t *cache, const char *name, uint16_t width, uint16_t height) {
+  return cache && cache->loopStart >= 0 && cache->width == width && cache->height == height && strncmp(cache->filename, name, 32) == 0;
+}
+
+void screenClearCallback(void) {
+  if (ctx->canvas) memset(ctx->canvas, 0, ctx->canvasWidth * ctx->canvasHeight * sizeof(uint32_t));
+  else             ctx->seg->fill(BLACK);
+}
+
+void updateScreenCallback(void) {
+  flushFrame();
+}
+
+void drawPixelCallback(int16_t x, int16_t y, uint8_t red, uint8_t green, uint8_t blue) {
+  image_context_t &c = *ctx;
+  if (!c.rowBuf) return;
+  if (y != c.rowY) { flushRow(); c.rowY = y; }
+  if ((uint16_t)x >= c.mapGifW || (uint16_t)y >= c.mapGifH) { c.rowY = -1; return; }
+  c.rowRGB[3*x]   = red;
+  c.rowRGB[3*x+1] = green;
+  c.rowRGB[3*x+2] = blue;
+  uint8_t bit = 1 << (x & 7);
+  if (!(c.rowValid[x >> 3] & bit)) { c.rowValid[x >> 3] |= bit; c.rowValidCount++; }
 }
 
 #define IMAGE_ERROR_NONE 0
@@ -74,71 +528,499 @@ void drawPixelCallback(int16_t x, int16_t y, uint8_t red, uint8_t green, uint8_t
 #define IMAGE_ERROR_WAITING 254
 #define IMAGE_ERROR_PREV 255
 
-// renders an image (.gif only; .bmp and .fseq to be added soon) from FS to a segment
+// segments live in a vector and may move or be removed without reset, release contexts of segments no longer playing images
+static void releaseStaleContexts(void) {
+  for (image_context_t *img : images) {
+    if (!img) continue;
+    bool found = false;
+    for (unsigned i = 0; i < strip.getSegmentsNum(); i++) {
+      Segment &seg = strip.getSegment(i);
+      if (&seg == img->seg) { found = seg.mode == FX_MODE_IMAGE; break; }
+    }
+    if (!found) endImagePlayback(img->seg);
+  }
+}
+
+static image_context_t* getImageContext(Segment &seg) {
+  unsigned slots = WLED_MAX_IMAGE_SEGMENTS;
+  #if defined(ARDUINO_ARCH_ESP32)
+  if (!psramSafe || !psramFound())
+  #endif
+    slots = MIN(slots, WLED_MAX_IMAGE_SEGMENTS_NO_PSRAM);
+  image_context_t **freeSlot = nullptr;
+  for (image_context_t *&img : images) {
+    if (img && img->seg == &seg) return img;
+    if (!img && !freeSlot && &img - images < (int)slots) freeSlot = &img;
+  }
+  if (!freeSlot) {
+    releaseStaleContexts();
+    for (unsigned i = 0; i < slots; i++) if (!images[i]) { freeSlot = &images[i]; break; }
+    if (!freeSlot) return nullptr;
+  }
+  if (Segment::getUsedSegmentData() + sizeof(image_context_t) > MAX_SEGMENT_DATA) { errorFlag = ERR_NORAM; return nullptr; }
+  image_context_t *img = new(std::nothrow) image_context_t();
+  if (!img) return nullptr;
+  img->seg = &seg;
+  Segment::addUsedSegmentData(sizeof(image_context_t));
+  *freeSlot = img;
+  return img;
+}
+
+
+static inline uint16_t readLE16(const uint8_t *b) { return b[0] | (b[1] << 8); }
+static inline uint32_t readLE32(const uint8_t *b) { return b[0] | (b[1] << 8) | (b[2] << 16) | ((uint32_t)b[3] << 24); }
+static inline void writeLE16(uint8_t *b, uint16_t v) { b[0] = v; b[1] = v >> 8; }
+static inline void writeLE32(uint8_t *b, uint32_t v) { b[0] = v; b[1] = v >> 8; b[2] = v >> 16; b[3] = v >> 24; }
+
+// gamma baked into converted frames (gamma8() table is calculated from gammaCorrectVal)
+static inline uint8_t wfsGamma(void) { return gammaCorrectVal * 10.0f + 0.5f; }
+
+// name of converted GIF: /name.gif -> /name.wfs
+static void getWfsName(char *wfsName) {
+  strlcpy(wfsName, ctx->filename, sizeof(ctx->filename));
+  strcpy_P(wfsName + strlen(wfsName) - 4, PSTR(".wfs"));
+}
+
+#ifndef WLED_DISABLE_IMAGE_CONVERT
+static void abortConversion(void) {
+  if (!ctx->convFile) return;
+  ctx->convFile.close();
+  char name[sizeof(ctx->filename)];
+  getWfsName(name);
+  WLED_FS.remove(name);
+  DEBUG_PRINTLN(F("Image conversion aborted."));
+}
+
+static void startConversion(void) {
+  if (!ctx->canvas) return; // frames are not kept
+  char name[sizeof(ctx->filename)];
+  getWfsName(name);
+  updateFSInfo();
+  if (fsBytesTotal - fsBytesUsed < ctx->canvasWidth * ctx->canvasHeight * 3U + 9000) return; // not even space for a single frame
+  ctx->convFile = WLED_FS.open(name, "w");
+  if (!ctx->convFile) return;
+  uint8_t hdr[WFS_HEADER_SIZE] = {'W','F','S','2'}; // frame count 0 marks incomplete file
+  writeLE16(hdr+4, ctx->canvasWidth);
+  writeLE16(hdr+6, ctx->canvasHeight);
+  hdr[10] = WFS_FLAG_GAMMA; // canvas holds gamma8() colors
+  hdr[11] = wfsGamma();
+  writeLE32(hdr+16, ctx->sourceSize);
+  writeLE32(hdr+20, ctx->sourceTime);
+  ctx->convPos = ctx->convFile.write(hdr, sizeof(hdr));
+  if (ctx->convPos != sizeof(hdr)) abortConversion();
+}
+
+// appends decoded canvas as a frame to converted file
+static void convertFrame(uint16_t delay) {
+  if (!ctx->convFile) return;
+  const uint32_t *px = ctx->canvas;
+  const unsigned len = ctx->canvasWidth * ctx->canvasHeight;
+  unsigned rleLen = 0;
+  for (unsigned i = 0; i < len; ) {
+    unsigned run = 1;
+    while (i + run < len && run < 255 && px[i+run] == px[i]) run++;
+    rleLen += 4;
+    i += run;
+  }
+  uint8_t  encoding = rleLen < len * 3 ? WFS_ENCODING_RLE : WFS_ENCODING_RGB;
+  uint32_t payload  = encoding == WFS_ENCODING_RLE ? rleLen : len * 3;
+  if (ctx->framePos.size() >= UINT16_MAX || ctx->convPos + WFS_FRAME_HEADER_SIZE + payload + 9000 > fsBytesTotal - fsBytesUsed) { abortConversion(); return; }
+
+  uint8_t buf[128];
+  writeLE16(buf, delay);
+  buf[2] = encoding;
+  writeLE32(buf+3, payload);
+  unsigned b = WFS_FRAME_HEADER_SIZE;
+  size_t written = 0;
+  for (unsigned i = 0; i < len; ) {
+    unsigned run = 1;
+    if (encoding == WFS_ENCODING_RLE) {
+      while (i + run < len && run < 255 && px[i+run] == px[i]) run++;
+      buf[b++] = run;
+    }
+    buf[b++] = R(px[i]);
+    buf[b++] = G(px[i]);
+    buf[b++] = B(px[i]);
+    i += run;
+    if (b > sizeof(buf) - 4) { written += ctx->convFile.write(buf, b); b = 0; }
+  }
+  if (b) written += ctx->convFile.write(buf, b);
+  if (written != WFS_FRAME_HEADER_SIZE + payload) { abortConversion(); return; }
+  ctx->convPos += written;
+}
+
+// GIF has looped, complete header of converted file
+static bool finishConversion(unsigned loopFrame) {
+  if (!ctx->convFile) return false;
+  uint8_t hdr[2];
+  writeLE16(hdr, ctx->framePos.size());
+  uint8_t pos[4];
+  writeLE32(pos, ctx->framePos[loopFrame].wfsPos);
+  bool ok = ctx->convFile.seek(8)  && ctx->convFile.write(hdr, sizeof(hdr)) == sizeof(hdr)
+         && ctx->convFile.seek(12) && ctx->convFile.write(pos, sizeof(pos)) == sizeof(pos);
+  if (!ok) { abortConversion(); return false; }
+  ctx->convFile.close();
+  updateFSInfo();
+  DEBUG_PRINTF_P(PSTR("Image converted: %u frames, %u bytes\n"), (unsigned)ctx->framePos.size(), (unsigned)ctx->convPos);
+  return true;
+}
+#else
+static inline void abortConversion(void) {}
+static inline void startConversion(void) {}
+static inline void convertFrame(uint16_t delay) {}
+static inline bool finishConversion(unsigned loopFrame) { return false; }
+#endif
+
+// opens .wfs file, if sourceSize is given it has to be a conversion of that GIF (size and time) for current segment size and gamma
+static byte openWfs(const char *name, uint32_t sourceSize, uint32_t sourceTime) {
+  image_context_t &c = *ctx;
+  c.file = WLED_FS.open(name, "r");
+  c.readPos = c.readBufPos = c.readBufLen = 0;
+  if (!c.file) return IMAGE_ERROR_FILE_MISSING;
+  uint8_t hdr[WFS_HEADER_SIZE];
+  if (fileReadBlockCallback(hdr, sizeof(hdr)) != sizeof(hdr) || memcmp_P(hdr, PSTR("WFS2"), 4) != 0
+      || readLE16(hdr+4) == 0 || readLE16(hdr+6) == 0 || readLE16(hdr+8) == 0
+      || (sourceSize && (readLE32(hdr+16) != sourceSize || readLE32(hdr+20) != sourceTime
+                         || !(hdr[10] & WFS_FLAG_GAMMA) || hdr[11] != wfsGamma()
+                         || readLE16(hdr+4) != c.segWidth || readLE16(hdr+6) != c.segHeight))) {
+    c.file.close();
+    return IMAGE_ERROR_UNSUPPORTED_FORMAT;
+  }
+  c.rawWidth   = readLE16(hdr+4);
+  c.rawHeight  = readLE16(hdr+6);
+  c.frameCount = readLE16(hdr+8);
+  c.dataStart  = MAX(readLE32(hdr+12), (uint32_t)WFS_HEADER_SIZE);
+  c.format     = IMAGE_FORMAT_WFS;
+  return IMAGE_ERROR_NONE;
+}
+
+// opens xLights .fseq file (v1 or uncompressed v2)
+static byte openFseq(const char *name) {
+  image_context_t &c = *ctx;
+  c.file = WLED_FS.open(name, "r");
+  c.readPos = c.readBufPos = c.readBufLen = 0;
+  if (!c.file) return IMAGE_ERROR_FILE_MISSING;
+  uint8_t hdr[28];
+  if (fileReadBlockCallback(hdr, sizeof(hdr)) != sizeof(hdr) || memcmp_P(hdr, PSTR("PSEQ"), 4) != 0
+      || hdr[7] < 1 || hdr[7] > 2 || (hdr[7] == 2 && (hdr[20] & 0x0F) != 0)       // compressed sequences are not supported
+      || readLE32(hdr+10) < 3 || readLE32(hdr+14) == 0) {
+    c.file.close();
+    return IMAGE_ERROR_UNSUPPORTED_FORMAT;
+  }
+  c.dataStart  = readLE16(hdr+4);
+  c.frameSize  = readLE32(hdr+10);
+  c.frameCount = readLE32(hdr+14);
+  c.stepTime   = hdr[18] ? hdr[18] : 50;
+  c.frameIndex = 0;
+  c.rawWidth   = c.segWidth;
+  c.rawHeight  = c.segHeight;
+  c.format     = IMAGE_FORMAT_FSEQ;
+  return IMAGE_ERROR_NONE;
+}
+
+#define RAW_CHUNK_PIXELS 32
+
+// draws n pixels continuing at x,y, a row of the raw frame at a time
+static void drawPixels(Segment &seg, const uint32_t *px, unsigned n, unsigned &x, unsigned &y) {
+  while (n > 0) {
+    unsigned k = MIN(n, (unsigned)ctx->rawWidth - x);
+    seg.setPixelRowXY((int)x, (int)y, px, k);
+    px += k; n -= k; x += k;
+    if (x >= ctx->rawWidth) { x = 0; y++; }
+  }
+}
+
+// reads RGB pixels from file and draws them row by row starting at x,y
+static bool drawRawPixels(Segment &seg, unsigned count, unsigned &x, unsigned &y) {
+  uint8_t buf[RAW_CHUNK_PIXELS * 3];
+  uint32_t px[RAW_CHUNK_PIXELS];
+  while (count > 0) {
+    unsigned n = MIN(count, (unsigned)RAW_CHUNK_PIXELS);
+    if (fileReadBlockCallback(buf, n * 3) != (int)(n * 3)) return false;
+    for (unsigned i = 0; i < n; i++) px[i] = RGBW32(buf[3*i], buf[3*i+1], buf[3*i+2], 0);
+    drawPixels(seg, px, n, x, y);
+    count -= n;
+  }
+  return true;
+}
+
+// GIF has returned to an already decoded frame: continue from cache or converted file
+static void handleGifLoop(unsigned loopFrame) {
+  image_context_t &c = *ctx;
+  bool converted = finishConversion(loopFrame);
+  uint32_t wfsPos = c.framePos[loopFrame].wfsPos;
+  if (c.cache) {
+    DEBUG_PRINTF_P(PSTR("Image cached: %u frames, %u bytes\n"), (unsigned)c.cache->frames.size(), (unsigned)c.cache->size);
+    c.cacheRecording = false;
+    c.cache->loopStart = loopFrame;
+    c.cachePlayIndex = loopFrame;
+    freeDecoder(); // release decoder memory, it is no longer needed
+    freeRowScaling();
+  } else if (converted) {
+    char wfsName[sizeof(c.filename)];
+    getWfsName(wfsName);
+    freeDecoder();
+    if (openWfs(wfsName, c.sourceSize, c.sourceTime) == IMAGE_ERROR_NONE) {
+      freeCanvas();
+      fileSeekCallback(wfsPos);
+    } else {
+      c.decodeFailed = true;
+    }
+  } else {
+    std::vector<frame_pos_t>().swap(c.framePos); // nothing to record anymore
+  }
+}
+
+// places frame with given delay on animation timeline, returns false if it would already be over (frame is dropped)
+static bool scheduleFrame(uint16_t delay) {
+  image_context_t &c = *ctx;
+  unsigned long d = (delay * delayScale) >> 8;
+  c.nextFrameTime += d;
+  return !(allowDrop && d > 0 && (long)(frameNow - c.nextFrameTime) >= 0);
+}
+
+#define FRAME_ERROR   -1
+#define FRAME_DROPPED  0
+#define FRAME_DRAWN    1
+
+static int renderWfsFrame(Segment &seg) {
+  image_context_t &c = *ctx;
+  uint8_t hdr[WFS_FRAME_HEADER_SIZE];
+  if (fileReadBlockCallback(hdr, sizeof(hdr)) != sizeof(hdr)) {
+    fileSeekCallback(c.dataStart); // end of file, continue with first looping frame
+    if (fileReadBlockCallback(hdr, sizeof(hdr)) != sizeof(hdr)) return FRAME_ERROR;
+  }
+  uint32_t next = c.readPos + readLE32(hdr+3);
+  if (!scheduleFrame(readLE16(hdr))) { fileSeekCallback(next); return FRAME_DROPPED; }
+  unsigned pixels = c.rawWidth * c.rawHeight;
+  unsigned x = 0, y = 0;
+  if (hdr[2] == WFS_ENCODING_RLE) {
+    uint32_t px[RAW_CHUNK_PIXELS];
+    for (unsigned i = 0; i < pixels && c.readPos + 4 <= next; ) {
+      uint8_t run[4];
+      if (fileReadBlockCallback(run, 4) != 4) return FRAME_ERROR;
+      uint32_t col = RGBW32(run[1], run[2], run[3], 0);
+      unsigned len = MIN((unsigned)run[0], pixels - i);
+      i += len;
+      for (unsigned k = 0; k < MIN(len, (unsigned)RAW_CHUNK_PIXELS); k++) px[k] = col;
+      while (len > 0) {
+        unsigned n = MIN(len, (unsigned)RAW_CHUNK_PIXELS);
+        drawPixels(seg, px, n, x, y);
+        len -= n;
+      }
+    }
+  } else {
+    if (!drawRawPixels(seg, MIN(pixels, (unsigned)((next - c.readPos) / 3)), x, y)) return FRAME_ERROR;
+  }
+  fileSeekCallback(next);
+  return FRAME_DRAWN;
+}
+
+static int renderFseqFrame(Segment &seg) {
+  image_context_t &c = *ctx;
+  if (c.frameIndex >= c.frameCount) c.frameIndex = 0;
+  uint32_t frame = c.frameIndex++;
+  if (!scheduleFrame(c.stepTime)) return FRAME_DROPPED;
+  fileSeekCallback(c.dataStart + frame * c.frameSize);
+  unsigned x = 0, y = 0;
+  if (!drawRawPixels(seg, MIN((unsigned)(c.frameSize / 3), (unsigned)(c.rawWidth * c.rawHeight)), x, y)) return FRAME_ERROR;
+  return FRAME_DRAWN;
+}
+
+static int renderGifFrame(Segment &seg) {
+  image_context_t &c = *ctx;
+  if (!c.framePos.empty()) {
+    // has decoder returned to an already decoded frame (animation looped)?
+    for (size_t i = 0; i < c.framePos.size(); i++) {
+      if (c.framePos[i].gifPos != c.readPos) continue;
+      handleGifLoop(i);
+      if (c.decodeFailed) return FRAME_ERROR;
+      if (c.format == IMAGE_FORMAT_WFS) return renderWfsFrame(seg);
+      break;
+    }
+  }
+
+  if (c.cachePlayIndex >= 0) {
+    const cached_frame_t &f = c.cache->frames[c.cachePlayIndex];
+    if (++c.cachePlayIndex >= (int)c.cache->frames.size()) c.cachePlayIndex = c.cache->loopStart;
+    if (!scheduleFrame(f.delay)) return FRAME_DROPPED;
+    loadFrame(f);
+  } else {
+    // GIF frames build on each other, a dropped frame is still decoded (and recorded) but not drawn
+    bool recording = (c.cacheRecording && c.cache) || c.convFile;
+    if (recording) c.framePos.push_back({c.readPos, c.convPos});
+    int result = c.decoder->decodeFrame(false);
+    flushFrame();
+    if (result < 0) { abortConversion(); return FRAME_ERROR; }
+
+    uint16_t delay = c.decoder->getFrameDelay_ms();
+    if (c.cacheRecording && c.cache) storeFrame(delay);
+    convertFrame(delay);
+    if (!scheduleFrame(delay)) return FRAME_DROPPED;
+  }
+  blitCanvas(seg);
+  return FRAME_DRAWN;
+}
+
+static byte startImage(Segment &seg) {
+  image_context_t &c = *ctx;
+  strncpy(c.filename +1, seg.name, 32);
+  c.filename[33] = '\0';
+  c.decodeFailed = false;
+  c.cachePlayIndex = -1;
+  c.cacheRecording = false;
+  c.format = IMAGE_FORMAT_GIF;
+  c.segWidth  = seg.virtualWidth();
+  c.segHeight = seg.virtualHeight();
+  c.nextFrameTime = millis();
+  c.framesShown = c.framesDropped = c.framesLate = 0;
+  abortConversion();
+  freeDecoder();
+
+  const char *ext = strrchr(c.filename, '.');
+  byte err = IMAGE_ERROR_UNSUPPORTED_FORMAT;
+  if (ext && strcmp_P(ext, PSTR(".wfs")) == 0)  err = openWfs(c.filename, 0, 0);
+  if (ext && strcmp_P(ext, PSTR(".fseq")) == 0) err = openFseq(c.filename);
+  if (c.format != IMAGE_FORMAT_GIF) { freeCanvas(); return IMAGE_ERROR_NONE; } // raw frames are drawn directly
+  if (!ext || strcmp_P(ext, PSTR(".gif")) != 0) {
+    c.decodeFailed = true;
+    return err;
+  }
+
+  allocateCanvas(c.segWidth, c.segHeight);
+  if (!c.canvas || !isCompleteCache(c.cache, seg.name, c.canvasWidth, c.canvasHeight)) {
+    freeFrameCache();
+    if (c.canvas && isCompleteCache(keptCache, seg.name, c.canvasWidth, c.canvasHeight)) { c.cache = keptCache; keptCache = nullptr; }
+  }
+  if (c.cache) {
+    // complete animation is in cache, no need to decode
+    c.cachePlayIndex = 0;
+    return IMAGE_ERROR_NONE;
+  }
+  openGif(c.filename);
+  if (!c.file) { c.decodeFailed = true; return IMAGE_ERROR_FILE_MISSING; }
+  c.sourceSize = c.file.size();
+  c.sourceTime = c.file.getLastWrite();
+
+  // play previously converted frames if available
+  char wfsName[sizeof(c.filename)];
+  getWfsName(wfsName);
+  if (WLED_FS.exists(wfsName)) {
+    c.file.close();
+    if (openWfs(wfsName, c.sourceSize, c.sourceTime) == IMAGE_ERROR_NONE) { freeCanvas(); return IMAGE_ERROR_NONE; }
+    openGif(c.filename);
+    if (!c.file) { c.decodeFailed = true; return IMAGE_ERROR_FILE_MISSING; }
+  }
+
+  if (!createDecoder()) { c.decodeFailed = true; return IMAGE_ERROR_DECODER_ALLOC; }
+  gif_decoder_t &decoder = *c.decoder;
+  decoder.setScreenClearCallback(screenClearCallback);
+  decoder.setUpdateScreenCallback(updateScreenCallback);
+  decoder.setDrawPixelCallback(drawPixelCallback);
+  decoder.setFileSeekCallback(fileSeekCallback);
+  decoder.setFilePositionCallback(filePositionCallback);
+  decoder.setFileReadCallback(fileReadCallback);
+  decoder.setFileReadBlockCallback(fileReadBlockCallback);
+  decoder.setFileSizeCallback(fileSizeCallback);
+  DEBUG_PRINTLN(F("Starting decoding"));
+  if(decoder.startDecoding() < 0) { c.decodeFailed = true; return IMAGE_ERROR_GIF_DECODE; }
+  DEBUG_PRINTLN(F("Decoding started"));
+  decoder.getSize(&c.gifWidth, &c.gifHeight);
+  if (!prepareRowScaling(c.gifWidth, c.gifHeight)) { c.decodeFailed = true; return IMAGE_ERROR_DECODER_ALLOC; }
+  startFrameCache(seg.name);
+  startConversion();
+  return IMAGE_ERROR_NONE;
+}
+
+// renders an image (.gif, .wfs or .fseq) from FS to a segment
 byte renderImageToSegment(Segment &seg) {
   if (!seg.name) return IMAGE_ERROR_NO_NAME;
   // disable during effect transition, causes flickering, multiple allocations and depending on image, part of old FX remaining
   if (seg.mode != seg.currentMode()) return IMAGE_ERROR_WAITING;
-  if (activeSeg && activeSeg != &seg) return IMAGE_ERROR_SEG_LIMIT; // only one segment at a time
-  activeSeg = &seg;
-
-  if (strncmp(lastFilename +1, seg.name, 32) != 0) { // segment name changed, load new image
-    strncpy(lastFilename +1, seg.name, 32);
-    gifDecodeFailed = false;
-    if (strcmp(lastFilename + strlen(lastFilename) - 4, ".gif") != 0) {
-      gifDecodeFailed = true;
-      return IMAGE_ERROR_UNSUPPORTED_FORMAT;
+  ctx = getImageContext(seg);
+  if (!ctx) return IMAGE_ERROR_SEG_LIMIT; // all image slots in use or out of memory
+  image_context_t &c = *ctx;
+
+  if (strncmp(c.filename +1, seg.name, 32) != 0 || c.segWidth != seg.virtualWidth() || c.segHeight != seg.virtualHeight()) { // segment name or size changed, load new image
+    byte err = startImage(seg);
+    if (err != IMAGE_ERROR_NONE) return err;
+  }
+
+  if (c.decodeFailed) return IMAGE_ERROR_PREV;
+  if (c.cachePlayIndex < 0 && !c.file) { c.decodeFailed = true; return IMAGE_ERROR_FILE_MISSING; }
+
+  // animation timeline, frames are due at fixed times independent of effect frame rate
+  frameNow = millis();
+  if ((long)(frameNow - c.nextFrameTime) < 0) return IMAGE_ERROR_WAITING;
+  if (frameNow - c.nextFrameTime > IMAGE_RESYNC_TIME) c.nextFrameTime = frameNow; // image (re)started or stalled, do not catch up
+
+  // decoding of all image segments is limited to half of the frame time, a postponed segment is decoded in the next frame regardless
+  if (budgetFrame != strip.now) { budgetFrame = strip.now; budgetUsed = 0; }
+  if (c.cachePlayIndex < 0 && !c.deferred && budgetUsed > strip.getFrameTime() * 500U) { c.deferred = true; return IMAGE_ERROR_WAITING; }
+  c.deferred = false;
+  unsigned long start = micros();
+
+  // speed 0 = 1/4x, 64 = 1/2x, 128 = normal, 192 = 2x, 255 = 4x (delays are scaled by 2^((128-speed)/64))
+  delayScale = exp2f((128 - (int)seg.speed) / 64.0f) * 256.0f + 0.5f;
+
+  unsigned long due = c.nextFrameTime;
+  int result;
+  for (unsigned dropped = 0; ; dropped++) {
+    allowDrop = dropped < IMAGE_MAX_DROP;
+    due = c.nextFrameTime;
+    switch (c.format) {
+      case IMAGE_FORMAT_WFS:  result = renderWfsFrame(seg);  break;
+      case IMAGE_FORMAT_FSEQ: result = renderFseqFrame(seg); break;
+      default:                result = renderGifFrame(seg);  break;
     }
-    if (file) file.close();
-    openGif(lastFilename);
-    if (!file) { gifDecodeFailed = true; return IMAGE_ERROR_FILE_MISSING; }
-    decoder.setScreenClearCallback(screenClearCallback);
-    decoder.setUpdateScreenCallback(updateScreenCallback);
-    decoder.setDrawPixelCallback(drawPixelCallback);
-    decoder.setFileSeekCallback(fileSeekCallback);
-    decoder.setFilePositionCallback(filePositionCallback);
-    decoder.setFileReadCallback(fileReadCallback);
-    decoder.setFileReadBlockCallback(fileReadBlockCallback);
-    decoder.setFileSizeCallback(fileSizeCallback);
-    decoder.alloc();
-    DEBUG_PRINTLN(F("Starting decoding"));
-    if(decoder.startDecoding() < 0) { gifDecodeFailed = true; return IMAGE_ERROR_GIF_DECODE; }
-    DEBUG_PRINTLN(F("Decoding started"));
-  }
-
-  if (gifDecodeFailed) return IMAGE_ERROR_PREV;
-  if (!file) { gifDecodeFailed = true; return IMAGE_ERROR_FILE_MISSING; }
-  //if (!decoder) { gifDecodeFailed = true; return IMAGE_ERROR_DECODER_ALLOC; }
-
-  // speed 0 = half speed, 128 = normal, 255 = full FX FPS
-  // TODO: 0 = 4x slow, 64 = 2x slow, 128 = normal, 192 = 2x fast, 255 = 4x fast
-  uint32_t wait = currentFrameDelay * 2 - seg.speed * currentFrameDelay / 128;
-
-  // TODO consider handling this on FX level with a different frametime, but that would cause slow gifs to speed up during transitions
-  if (millis() - lastFrameDisplayTime < wait) return IMAGE_ERROR_WAITING;
-
-  decoder.getSize(&gifWidth, &gifHeight);
-
-  int result = decoder.decodeFrame(false);
-  if (result < 0) { gifDecodeFailed = true; return IMAGE_ERROR_FRAME_DECODE; }
-
-  currentFrameDelay = decoder.getFrameDelay_ms();
-  unsigned long tooSlowBy = (millis() - lastFrameDisplayTime) - wait; // if last frame was longer than intended, compensate
-  currentFrameDelay = tooSlowBy > currentFrameDelay ? 0 : currentFrameDelay - tooSlowBy;
-  lastFrameDisplayTime = millis();
+    if (result != FRAME_DROPPED) break;
+    c.framesDropped++;
+  }
+  budgetUsed += micros() - start;
+  if (result == FRAME_ERROR) { c.decodeFailed = true; return IMAGE_ERROR_FRAME_DECODE; }
 
+  c.framesShown++;
+  if (frameNow - due > strip.getFrameTime()) c.framesLate++; // shown more than one effect frame after it was due
   return IMAGE_ERROR_NONE;
 }
 
+// adds playback statistics of active images to info JSON
+void serializeImageStats(JsonObject root) {
+  JsonArray arr;
+  for (image_context_t *img : images) {
+    if (!img) continue;
+    if (arr.isNull()) arr = root.createNestedArray(F("img"));
+    JsonObject o = arr.createNestedObject();
+    for (unsigned i = 0; i < strip.getSegmentsNum(); i++) if (&strip.getSegment(i) == img->seg) { o[F("seg")] = i; break; }
+    o[F("file")]  = img->filename + 1;
+    o[F("shown")] = img->framesShown;
+    o[F("drop")]  = img->framesDropped;
+    o[F("late")]  = img->framesLate;
+  }
+}
+
 void endImagePlayback(Segment *seg) {
-  DEBUG_PRINTLN(F("Image playback end called"));
-  if (!activeSeg || activeSeg != seg) return;
-  if (file) file.close();
-  decoder.dealloc();
-  gifDecodeFailed = false;
-  activeSeg = nullptr;
-  lastFilename[1] = '\0';
-  DEBUG_PRINTLN(F("Image playback ended"));
+  for (image_context_t *&img : images) {
+    if (!img || img->seg != seg) continue;
+    DEBUG_PRINTLN(F("Image playback end called"));
+    image_context_t *prev = ctx;
+    ctx = img;
+    abortConversion(); // incomplete
+    freeDecoder();
+    freeCanvas();
+    if (img->cache && img->cache->loopStart >= 0) { // keep only complete animations
+      delete keptCache;
+      keptCache = img->cache;
+      img->cache = nullptr;
+    }
+    freeFrameCache();
+    releaseMemory(img->accounted); // should already be 0
+    Segment::addUsedSegmentData(-(int)MIN(sizeof(image_context_t), (size_t)Segment::getUsedSegmentData()));
+    delete img;
+    img = nullptr;
+    ctx = (prev == ctx) ? nullptr : prev;
+    DEBUG_PRINTLN(F("Image playback ended"));
+  }
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -10,6 +10,8 @@
 #define JSON_PATH_FXDATA     6
 #define JSON_PATH_NETWORKS   7
 #define JSON_PATH_EFFECTS    8
+#define JSON_PATH_BENCHMARK  9
+#define JSON_PATH_PERF      10
 
 /*
  * JSON API (De)serialization
@@ -105,6 +107,9 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
   uint8_t set = elem[F("set")] | seg.set;
   seg.set = constrain(set, 0, 3);
 
+  uint8_t fps = elem[F("fps")] | seg.fps;
+  seg.fps = MIN(fps, 120); // 0 uses strip frame rate
+
   unsigned len = 1;
   if (stop > start) len = stop - start;
   int offset = elem[F("of")] | INT32_MAX;
@@ -575,6 +580,7 @@ void serializeSegment(JsonObject& root, Segment& seg, byte id, bool forPreset, b
   root["o3"]  = seg.check3;
   root["si"]  = seg.soundSim;
   root["m12"] = seg.map1D2D;
+  root[F("fps")] = seg.fps;
 }
 
 void serializeState(JsonObject root, bool forPreset, bool includeBri, bool segmentBounds, bool selectedSegmentsOnly)
@@ -645,7 +651,18 @@ void serializeInfo(JsonObject root)
   leds[F("count")] = strip.getLengthTotal();
   leds[F("pwr")] = BusManager::currentMilliamps();
   leds["fps"] = strip.getFps();
+  leds[F("skip")] = BusManager::getSkippedShows(); // bus updates skipped because nothing changed
+  #ifdef WLED_ENABLE_PIPELINE
+  leds[F("pipe")] = strip.isPipelined(); // effects rendered on second core
+  #endif
   leds[F("maxpwr")] = BusManager::currentMilliamps()>0 ? BusManager::ablMilliampsMax() : 0;
+  if (BusManager::currentMilliamps() > 0 && BusManager::getCurrentHistoryLen() > 0) {
+    JsonArray bpwr = leds.createNestedArray(F("bpwr")); // per bus current history (mA, 1 sample per second, newest first)
+    for (unsigned b = 0; b < BusManager::getNumBusses(); b++) {
+      JsonArray hist = bpwr.createNestedArray();
+      for (unsigned age = 0; age < BusManager::getCurrentHistoryLen(); age++) hist.add(BusManager::getCurrentHistory(b, age));
+    }
+  }
   leds[F("maxseg")] = strip.getMaxSegments();
   //leds[F("actseg")] = strip.getActiveSegmentsNum();
   //leds[F("seglock")] = false; //might be used in the future to prevent modifications to segment config
@@ -707,6 +724,19 @@ void serializeInfo(JsonObject root)
 
   root[F("lip")] = realtimeIP[0] == 0 ? "" : realtimeIP.toString();
 
+  JsonObject e131info = root.createNestedObject(F("e131"));
+  JsonArray e131frames = e131info.createNestedArray(F("frames")); // complete, incomplete, synchronized
+  for (size_t i = 0; i < 3; i++) e131frames.add(e131Frames[i]);
+  JsonArray e131uni = e131info.createNestedArray(F("uni"));       // [universe, packets, dropped, out of order]
+  for (size_t i = 0; i < E131_MAX_UNIVERSE_COUNT; i++) {
+    if (!e131Packets[i]) continue;
+    JsonArray u = e131uni.createNestedArray();
+    u.add(e131Universe + i);
+    u.add(e131Packets[i]);
+    u.add(e131Dropped[i]);
+    u.add(e131OutOfOrder[i]);
+  }
+
   #ifdef WLED_ENABLE_WEBSOCKETS
   root[F("ws")] = ws.count();
   #else
@@ -780,6 +810,10 @@ void serializeInfo(JsonObject root)
   #endif
   root[F("uptime")] = millis()/1000 + rolloverMillis*4294967;
 
+  #ifndef WLED_DISABLE_GIF
+  serializeImageStats(root);
+  #endif
+
   char time[32];
   getTimeString(time);
   root[F("time")] = time;
@@ -999,6 +1033,81 @@ void serializeNetworks(JsonObject root)
   }
 }
 
+#ifdef WLED_ENABLE_FX_BENCHMARK
+// results of headless effect benchmark (see FX_bench.cpp), array index is effect ID
+void serializeBenchmark(JsonObject root)
+{
+  uint16_t w, h, n;
+  const std::vector<WS2812FX::bench_result_t> &results = strip.getBenchmarkResults(w, h, n);
+  root[F("run")] = strip.isBenchmarking();
+  root["w"] = w;
+  root["h"] = h;
+  root["n"] = n;
+  JsonArray avg   = root.createNestedArray(F("avg"));   // us per frame
+  JsonArray max   = root.createNestedArray(F("max"));   // slowest frame in us
+  JsonArray data  = root.createNestedArray(F("data"));  // SEGENV.data bytes
+  JsonArray alloc = root.createNestedArray(F("alloc")); // allocateData() (re)allocations
+  JsonArray bytes = root.createNestedArray(F("ab"));    // bytes requested by those allocations
+  JsonArray fail  = root.createNestedArray(F("fail"));  // effect IDs that ran out of effect RAM
+  for (size_t i = 0; i < results.size(); i++) {
+    avg.add(results[i].usAvg);
+    max.add(results[i].usMax);
+    data.add(results[i].dataBytes);
+    alloc.add(results[i].allocs);
+    bytes.add(results[i].allocBytes);
+    if (results[i].failed) fail.add(i);
+  }
+  // fill, fadeToBlackBy, fade_out, blur: [us per call pixel by pixel, us per call on render buffer]
+  JsonArray prim = root.createNestedArray(F("prim"));
+  for (unsigned p = 0; p < BENCH_PRIMITIVES; p++) {
+    JsonArray t = prim.createNestedArray();
+    t.add(strip.getBenchmarkPrimitive(p, false));
+    t.add(strip.getBenchmarkPrimitive(p, true));
+  }
+}
+#endif
+
+#ifndef WLED_DISABLE_PROFILER
+// runtime profiler: render time per segment, show() time per bus and effect data allocations (times in us)
+void serializePerf(JsonObject root)
+{
+  root[F("ft")]      = strip.getFrameTime() * 1000; // frame budget
+  root[F("svc")]     = strip.getServiceTime();
+  root[F("svcmax")]  = strip.getServiceTime(true);
+  root[F("show")]    = strip.getShowTime();
+  root[F("showmax")] = strip.getShowTime(true);
+
+  JsonArray segs = root.createNestedArray("seg");
+  for (size_t s = 0; s < strip.getSegmentsNum(); s++) {
+    const WS2812FX::perf_stat_t *p = strip.getPerfStats(s);
+    if (!p) continue;
+    JsonObject seg = segs.createNestedObject();
+    seg["id"]       = s;
+    seg["fx"]       = p->mode;
+    seg["n"]        = p->frames;
+    seg[F("min")]   = p->usMin;
+    seg[F("avg")]   = p->usSum / p->frames;
+    seg[F("max")]   = p->usMax;
+    seg["tr"]       = p->usTrans / p->frames; // previous mode during transition (included in avg)
+    seg[F("data")]  = strip.getSegment(s).dataSize();
+  }
+
+  JsonArray bus = root.createNestedArray(F("bus")); // [average, peak] per bus
+  for (unsigned b = 0; b < BusManager::getNumBusses(); b++) {
+    JsonArray t = bus.createNestedArray();
+    t.add(BusManager::getShowTime(b));
+    t.add(BusManager::getShowTime(b, true));
+  }
+
+  JsonObject alloc = root.createNestedObject(F("alloc"));
+  alloc["n"]       = Segment::getAllocCount();
+  alloc[F("fail")] = Segment::getAllocFails();
+  alloc[F("max")]  = Segment::getAllocMax();
+  alloc[F("used")] = Segment::getUsedSegmentData();
+  alloc[F("lim")]  = MAX_SEGMENT_DATA;
+}
+#endif
+
 void serializeNodes(JsonObject root)
 {
   JsonArray nodes = root.createNestedArray("nodes");
@@ -1084,6 +1193,23 @@ void serveJson(AsyncWebServerRequest* request)
   else if (url.indexOf(F("palx"))  > 0) subJson = JSON_PATH_PALETTES;
   else if (url.indexOf(F("fxda"))  > 0) subJson = JSON_PATH_FXDATA;
   else if (url.indexOf(F("net"))   > 0) subJson = JSON_PATH_NETWORKS;
+  #ifdef WLED_ENABLE_FX_BENCHMARK
+  else if (url.indexOf(F("bench")) > 0) {
+    subJson = JSON_PATH_BENCHMARK;
+    if (request->hasParam(F("run"))) {
+      uint16_t w = request->hasParam("w") ? request->getParam("w")->value().toInt() : 300;
+      uint16_t h = request->hasParam("h") ? request->getParam("h")->value().toInt() : 1;
+      uint16_t n = request->hasParam("n") ? request->getParam("n")->value().toInt() : 100;
+      strip.startBenchmark(w, h, n);
+    }
+  }
+  #endif
+  #ifndef WLED_DISABLE_PROFILER
+  else if (url.indexOf(F("perf"))  > 0) {
+    subJson = JSON_PATH_PERF;
+    if (request->hasParam(F("reset"))) strip.resetPerf();
+  }
+  #endif
   #ifdef WLED_ENABLE_JSONLIVE
   else if (url.indexOf("live")     > 0) {
     serveLiveLeds(request);
@@ -1128,6 +1254,14 @@ void serveJson(AsyncWebServerRequest* request)
       serializeModeData(lDoc); break;
     case JSON_PATH_NETWORKS:
       serializeNetworks(lDoc); break;
+    #ifdef WLED_ENABLE_FX_BENCHMARK
+    case JSON_PATH_BENCHMARK:
+      serializeBenchmark(lDoc); break;
+    #endif
+    #ifndef WLED_DISABLE_PROFILER
+    case JSON_PATH_PERF:
+      serializePerf(lDoc); break;
+    #endif
     default: //all
       JsonObject state = lDoc.createNestedObject("state");
       serializeState(state);
@@ -0,0 +1,57 @@
+#ifndef WLED_REALTIME_INGEST_H
+#define WLED_REALTIME_INGEST_H
+
+/*
+ * Pixel conversion used by setRealtimePixels() (udp.cpp) for DDP, E1.31/Art-Net, TPM2 and UDP realtime packets.
+ * Depends only on <stdint.h> so captured traffic can be replayed and timed on host (test/test_realtime_ingest).
+ */
+
+#include <stdint.h>
+
+// clips count LEDs starting at strip index first (negative if realtime LED offset is) to strip length total
+// returns number of LEDs to write, skip is set to number of leading LEDs that fall before the start of the strip
+static inline unsigned clipRealtimeRun(int first, unsigned count, unsigned total, unsigned &skip) {
+  skip = 0;
+  if (first < 0) {
+    skip = unsigned(-first);
+    if (skip >= count) return 0;
+    count -= skip;
+    first = 0;
+  }
+  if (unsigned(first) >= total) return 0;
+  if (first + count > total) count = total - first;
+  return count;
+}
+
+// packs n LEDs of RGB (3) or RGBW (4) channel data into WRGB colors, every channel is passed through gamma()
+template <typename G>
+static inline void packRealtimePixels(uint32_t *dst, const uint8_t *data, unsigned n, unsigned channelsPerLed, G gamma) {
+  for (unsigned j = 0; j < n; j++, data += channelsPerLed) {
+    uint32_t w = channelsPerLed > 3 ? gamma(data[3]) : gamma(0);
+    dst[j] = w << 24 | uint32_t(gamma(data[0])) << 16 | uint32_t(gamma(data[1])) << 8 | gamma(data[2]);
+  }
+}
+
+#define REALTIME_CHUNK_LEDS 64 // LEDs converted at a time, keeps stack usage bounded
+
+// setRealtimePixels() without strip: count LEDs of channel data for strip index first (realtime LED offset applied)
+// are clipped to total, converted and passed to sink(pix, n, colors) in runs of consecutive LEDs (strip.setPixelRange())
+template <typename G, typename S>
+static inline void ingestRealtimeRun(int first, unsigned count, const uint8_t *data, unsigned channelsPerLed, unsigned total, G gamma, S sink) {
+  unsigned skip;
+  count = clipRealtimeRun(first, count, total, skip);
+  if (!count) return;
+  data += skip * channelsPerLed;
+  unsigned pix = first + skip;
+  uint32_t chunk[REALTIME_CHUNK_LEDS];
+  while (count) {
+    unsigned n = count < REALTIME_CHUNK_LEDS ? count : REALTIME_CHUNK_LEDS;
+    packRealtimePixels(chunk, data, n, channelsPerLed, gamma);
+    sink(pix, n, chunk);
+    data  += n * channelsPerLed;
+    pix   += n;
+    count -= n;
+  }
+}
+
+#endif
@@ -139,6 +139,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
     Bus::setGlobalAWMode(request->arg(F("AW")).toInt());
     strip.setTargetFps(request->arg(F("FR")).toInt());
     useGlobalLedBuffer = request->hasArg(F("LD"));
+    useSegmentBuffer = request->hasArg(F("VB"));
 
     bool busesChanged = false;
     for (int s = 0; s < WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES; s++) {
@@ -388,6 +389,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
     notifyButton = request->hasArg(F("SB"));
     notifyAlexa = request->hasArg(F("SA"));
     notifyHue = request->hasArg(F("SH"));
+    udpSyncDelta = request->hasArg(F("DL"));
 
     t = request->arg(F("UR")).toInt();
     if ((t>=0) && (t<30)) udpNumRetries = t;
@@ -405,7 +407,12 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
     t = request->arg(F("EP")).toInt();
     if (t > 0) e131Port = t;
     t = request->arg(F("EU")).toInt();
-    if (t >= 0  && t <= 63999) e131Universe = t;
+    if (t >= 0  && t <= 63999 && t != e131Universe) {
+      e131Universe = t;
+      memset(e131Packets, 0, sizeof(e131Packets)); // statistics are relative to start universe
+      memset(e131Dropped, 0, sizeof(e131Dropped));
+      memset(e131OutOfOrder, 0, sizeof(e131OutOfOrder));
+    }
     t = request->arg(F("DA")).toInt();
     if (t >= 0  && t <= 510) DMXAddress = t;
     t = request->arg(F("XX")).toInt();
@@ -46,10 +46,33 @@ bool ESPAsyncE131::begin(bool multicast, uint16_t port, uint16_t universe, uint8
 	} else {
     success = initUnicast(port);
 	}
+  _multicast = multicast && success;
+  _universe = universe;
+  _count = n;
+  _extraUniverse = 0;
 
   return success;
 }
 
+bool ESPAsyncE131::joinUniverse(uint16_t universe) {
+  if (!_multicast || universe == _extraUniverse) return true;
+
+  ip4_addr_t ifaddr;
+  ip4_addr_t multicast_addr;
+  ifaddr.addr = static_cast<uint32_t>(Network.localIP());
+  if (_extraUniverse) {
+    multicast_addr.addr = static_cast<uint32_t>(IPAddress(239, 255, ((_extraUniverse >> 8) & 0xff), ((_extraUniverse >> 0) & 0xff)));
+    igmp_leavegroup(&ifaddr, &multicast_addr);
+    _extraUniverse = 0;
+  }
+  if (universe == 0 || (universe >= _universe && universe < _universe + _count)) return true; // nothing to join
+
+  multicast_addr.addr = static_cast<uint32_t>(IPAddress(239, 255, ((universe >> 8) & 0xff), ((universe >> 0) & 0xff)));
+  if (igmp_joingroup(&ifaddr, &multicast_addr) != ERR_OK) return false;
+  _extraUniverse = universe;
+  return true;
+}
+
 /////////////////////////////////////////////////////////
 //
 // Private init() members
@@ -110,8 +133,11 @@ void ESPAsyncE131::parsePacket(AsyncUDPPacket _packet) {
 	if (protocol == P_ARTNET) {
 		if (memcmp(sbuff->art_id, ESPAsyncE131::ART_ID, sizeof(sbuff->art_id)))
 			error = true; //not "Art-Net"
-		if (sbuff->art_opcode != ARTNET_OPCODE_OPDMX && sbuff->art_opcode != ARTNET_OPCODE_OPPOLL)
-			error = true; //not a DMX or poll packet
+		if (sbuff->art_opcode != ARTNET_OPCODE_OPDMX && sbuff->art_opcode != ARTNET_OPCODE_OPPOLL && sbuff->art_opcode != ARTNET_OPCODE_OPSYNC)
+			error = true; //not a DMX, poll or sync packet
+	} else if (htonl(sbuff->root_vector) == E131_VECTOR_ROOT_EXTENDED) { //E1.31 synchronization packet
+		if (htonl(sbuff->sync_vector) != E131_VECTOR_EXTENDED_SYNCHRONIZATION)
+			error = true;
 	} else { //E1.31 error handling
 		if (htonl(sbuff->root_vector) != ESPAsyncE131::VECTOR_ROOT)
 			error = true;
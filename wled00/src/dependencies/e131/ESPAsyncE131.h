@@ -59,6 +59,11 @@ typedef struct ip_addr ip4_addr_t;
 #define ARTNET_OPCODE_OPDMX 0x5000
 #define ARTNET_OPCODE_OPPOLL 0x2000
 #define ARTNET_OPCODE_OPPOLLREPLY 0x2100
+#define ARTNET_OPCODE_OPSYNC 0x5200
+
+// E1.31 extended (synchronization) packet vectors
+#define E131_VECTOR_ROOT_EXTENDED 0x00000008
+#define E131_VECTOR_EXTENDED_SYNCHRONIZATION 0x00000001
 
 #define P_E131   0
 #define P_ARTNET 1
@@ -105,7 +110,7 @@ typedef union {
       uint32_t frame_vector;
       uint8_t  source_name[64];
       uint8_t  priority;
-      uint16_t reserved;
+      uint16_t sync_address;  // universe of synchronization packets (0 = not synchronized)
       uint8_t  sequence_number;
       uint8_t  options;
       uint16_t universe;
@@ -120,6 +125,15 @@ typedef union {
       uint8_t  property_values[513];
     } __attribute__((packed));
 	
+    struct { //E1.31 synchronization packet
+      uint8_t  sync_root[38]; // same root layer as above
+      uint16_t sync_flength;
+      uint32_t sync_vector;
+      uint8_t  sync_sequence_number;
+      uint16_t sync_universe;
+      uint16_t sync_reserved;
+    } __attribute__((packed));
+
 	struct { //Art-Net packet
     uint8_t  art_id[8];
     uint16_t art_opcode;
@@ -221,11 +235,21 @@ class ESPAsyncE131 {
     
     e131_packet_callback_function _callback = nullptr;
 
+    // Multicast groups joined by begin() and joinUniverse()
+    bool            _multicast = false;
+    uint16_t        _universe = 0;
+    uint8_t         _count = 0;
+    uint16_t        _extraUniverse = 0;
+
  public:
     ESPAsyncE131(e131_packet_callback_function callback);
 
     // Generic UDP listener, no physical or IP configuration
     bool begin(bool multicast, uint16_t port = E131_DEFAULT_PORT, uint16_t universe = 1, uint8_t n = 1);
+
+    // Multicast: also receive universe outside the range given to begin() (i.e. E1.31 synchronization address),
+    // replaces universe joined by previous call, 0 leaves it
+    bool joinUniverse(uint16_t universe);
 };
 
 // Class to track e131 package priority
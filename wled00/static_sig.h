@@ -0,0 +1,76 @@
+#ifndef WLED_STATIC_SIG_H
+#define WLED_STATIC_SIG_H
+
+/*
+ * Solid segments are only repainted when their signature (hash of everything Solid output depends on) changes.
+ * Repaint epoch is part of the signature: WS2812FX::repaintUnchanged() bumps it whenever LEDs were painted by
+ * something else (realtime data, re-created buses) so every Solid segment is repainted once.
+ * Depends only on <stdint.h> so it can be tested on host (test/test_static_sig).
+ */
+
+#include <stdint.h>
+
+// FNV-1a of epoch and n values, never 0 (reserved for "not rendered")
+static inline uint32_t staticSignatureHash(const uint32_t *v, unsigned n, uint32_t epoch) {
+  uint32_t h = 2166136261UL;
+  h ^= epoch; h *= 16777619UL;
+  for (unsigned i = 0; i < n; i++) { h ^= v[i]; h *= 16777619UL; }
+  return h ? h : 1;
+}
+
+// true if segment last rendered with signature sig (rendered is 0 if it needs rendering)
+static inline bool staticSignatureMatches(uint32_t rendered, uint32_t sig) { return rendered && rendered == sig; }
+
+// Solid effect output only depends on these (filled by Segment::staticSignature())
+typedef struct StaticSignatureInput {
+  uint32_t color;        // colors[0]
+  uint8_t  mode;
+  uint8_t  opacity;
+  uint8_t  cct;
+  uint16_t options;      // without SELECTED; includes on, mirroring and 1D to 2D mapping
+  uint16_t start, stop;
+  uint8_t  startY, stopY;
+  uint8_t  grouping, spacing;
+  uint16_t offset;
+  bool     gammaCorrectCol, cctFromRgb, correctWB; // global color settings
+  uint8_t  cctBlending;
+} static_sig_input_t;
+
+static inline uint32_t staticSignature(const static_sig_input_t &in, uint32_t epoch) {
+  const uint32_t v[] = {
+    in.color,
+    (uint32_t)in.mode | (uint32_t)in.opacity << 8 | (uint32_t)in.cct << 16,
+    (uint32_t)in.options,
+    (uint32_t)in.start | (uint32_t)in.stop << 16,
+    (uint32_t)in.startY | (uint32_t)in.stopY << 8 | (uint32_t)in.grouping << 16 | (uint32_t)in.spacing << 24,
+    (uint32_t)in.offset | (uint32_t)in.gammaCorrectCol << 16 | (uint32_t)in.cctFromRgb << 17 | (uint32_t)in.correctWB << 18 | (uint32_t)in.cctBlending << 24
+  };
+  return staticSignatureHash(v, sizeof(v)/sizeof(v[0]), epoch);
+}
+
+// unchanged Solid segments can only be skipped if nothing else may paint over their LEDs
+// (realtime data, overlays, usermods, TM1814 type buses that need periodic refresh)
+static inline bool staticSkipEnabled(bool realtime, bool offRefreshRequired, bool overlay, unsigned usermods) {
+  return !realtime && !offRefreshRequired && !overlay && !usermods;
+}
+
+// segment whose output can be described by its signature (frozen and transitioning segments always render)
+static inline bool staticSkipCandidate(bool solid, bool frozen, bool inTransition) {
+  return solid && !frozen && !inTransition;
+}
+
+enum StaticState {
+  STATIC_CHANGED,   // never rendered or signature changed: repaint immediately
+  STATIC_DUE,       // unchanged but its pixels are not kept: render when due
+  STATIC_UNCHANGED  // unchanged and pixels still shown: skip rendering
+};
+
+// rendered: signature of last rendered frame, sig: current signature, called: segment rendered before (seg.call)
+// without segment buffer strip pixels of an overlapped segment may have been overwritten by the other segment
+static inline StaticState staticState(uint32_t rendered, uint32_t sig, bool called, bool useSegmentBuffer, bool hasBuffer, bool overlapped) {
+  if (!called || !staticSignatureMatches(rendered, sig)) return STATIC_CHANGED;
+  if (useSegmentBuffer ? hasBuffer : !overlapped) return STATIC_UNCHANGED;
+  return STATIC_DUE;
+}
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef WLED_TRIG_LUT_H
+#define WLED_TRIG_LUT_H
+
+/*
+ * Table driven trigonometry used by sin_lut()/cos_lut()/tan_lut() and sin16_t()/cos16_t()/atan2_16_t() (wled_math.cpp)
+ * Tables hold one quarter wave (2^WLED_TRIG_LUT_BITS+1 entries), other quadrants are mirrored.
+ * Fixed point angles are fractions of a full turn, values are Q15 (32767 = 1.0).
+ * Has no Arduino dependencies besides PROGMEM so accuracy can be checked on host (test/test_trig_lut).
+ */
+
+#include <stdint.h>
+#ifdef ARDUINO
+  #include <Arduino.h> // PROGMEM, pgm_read_word()
+#else
+  #define PROGMEM
+  #define pgm_read_word(addr) (*(const uint16_t*)(addr))
+#endif
+
+#ifndef WLED_TRIG_LUT_BITS
+  #define WLED_TRIG_LUT_BITS 8
+#endif
+
+#if WLED_TRIG_LUT_BITS == 6
+// sin(0..PI/2) * 32767
+static const int16_t sinLUT[] PROGMEM = {
+      0,   804,  1608,  2410,  3212,  4011,  4808,  5602,  6393,  7179,  7962,  8739,
+   9512, 10278, 11039, 11793, 12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+  18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594, 23170, 23731, 24279, 24811,
+  25329, 25832, 26319, 26790, 27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+  30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971, 32137, 32285, 32412, 32521,
+  32609, 32678, 32728, 32757, 32767,
+};
+// atan(0..1) in 1/65536 of a full turn (PI/4 = 8192)
+static const int16_t atanLUT[] PROGMEM = {
+      0,   163,   326,   489,   651,   813,   975,  1136,  1297,  1457,  1617,  1775,
+   1933,  2090,  2246,  2401,  2555,  2708,  2860,  3010,  3159,  3307,  3453,  3599,
+   3742,  3884,  4025,  4164,  4302,  4438,  4572,  4705,  4836,  4966,  5094,  5220,
+   5344,  5467,  5589,  5708,  5826,  5943,  6058,  6171,  6282,  6392,  6500,  6607,
+   6712,  6815,  6917,  7018,  7117,  7214,  7310,  7405,  7498,  7589,  7679,  7768,
+   7856,  7942,  8026,  8110,  8192,
+};
+#elif WLED_TRIG_LUT_BITS == 8
+// sin(0..PI/2) * 32767
+static const int16_t sinLUT[] PROGMEM = {
+      0,   201,   402,   603,   804,  1005,  1206,  1407,  1608,  1809,  2009,  2210,
+   2410,  2611,  2811,  3012,  3212,  3412,  3612,  3811,  4011,  4210,  4410,  4609,
+   4808,  5007,  5205,  5404,  5602,  5800,  5998,  6195,  6393,  6590,  6786,  6983,
+   7179,  7375,  7571,  7767,  7962,  8157,  8351,  8545,  8739,  8933,  9126,  9319,
+   9512,  9704,  9896, 10087, 10278, 10469, 10659, 10849, 11039, 11228, 11417, 11605,
+  11793, 11980, 12167, 12353, 12539, 12725, 12910, 13094, 13279, 13462, 13645, 13828,
+  14010, 14191, 14372, 14553, 14732, 14912, 15090, 15269, 15446, 15623, 15800, 15976,
+  16151, 16325, 16499, 16673, 16846, 17018, 17189, 17360, 17530, 17700, 17869, 18037,
+  18204, 18371, 18537, 18703, 18868, 19032, 19195, 19357, 19519, 19680, 19841, 20000,
+  20159, 20317, 20475, 20631, 20787, 20942, 21096, 21250, 21403, 21554, 21705, 21856,
+  22005, 22154, 22301, 22448, 22594, 22739, 22884, 23027, 23170, 23311, 23452, 23592,
+  23731, 23870, 24007, 24143, 24279, 24413, 24547, 24680, 24811, 24942, 25072, 25201,
+  25329, 25456, 25582, 25708, 25832, 25955, 26077, 26198, 26319, 26438, 26556, 26674,
+  26790, 26905, 27019, 27133, 27245, 27356, 27466, 27575, 27683, 27790, 27896, 28001,
+  28105, 28208, 28310, 28411, 28510, 28609, 28706, 28803, 28898, 28992, 29085, 29177,
+  29268, 29358, 29447, 29534, 29621, 29706, 29791, 29874, 29956, 30037, 30117, 30195,
+  30273, 30349, 30424, 30498, 30571, 30643, 30714, 30783, 30852, 30919, 30985, 31050,
+  31113, 31176, 31237, 31297, 31356, 31414, 31470, 31526, 31580, 31633, 31685, 31736,
+  31785, 31833, 31880, 31926, 31971, 32014, 32057, 32098, 32137, 32176, 32213, 32250,
+  32285, 32318, 32351, 32382, 32412, 32441, 32469, 32495, 32521, 32545, 32567, 32589,
+  32609, 32628, 32646, 32663, 32678, 32692, 32705, 32717, 32728, 32737, 32745, 32752,
+  32757, 32761, 32765, 32766, 32767,
+};
+// atan(0..1) in 1/65536 of a full turn (PI/4 = 8192)
+static const int16_t atanLUT[] PROGMEM = {
+      0,    41,    81,   122,   163,   204,   244,   285,   326,   367,   407,   448,
+    489,   529,   570,   610,   651,   692,   732,   773,   813,   854,   894,   935,
+    975,  1015,  1056,  1096,  1136,  1177,  1217,  1257,  1297,  1337,  1377,  1417,
+   1457,  1497,  1537,  1577,  1617,  1656,  1696,  1736,  1775,  1815,  1854,  1894,
+   1933,  1973,  2012,  2051,  2090,  2129,  2168,  2207,  2246,  2285,  2324,  2363,
+   2401,  2440,  2478,  2517,  2555,  2594,  2632,  2670,  2708,  2746,  2784,  2822,
+   2860,  2897,  2935,  2973,  3010,  3047,  3085,  3122,  3159,  3196,  3233,  3270,
+   3307,  3344,  3380,  3417,  3453,  3490,  3526,  3562,  3599,  3635,  3670,  3706,
+   3742,  3778,  3813,  3849,  3884,  3920,  3955,  3990,  4025,  4060,  4095,  4129,
+   4164,  4199,  4233,  4267,  4302,  4336,  4370,  4404,  4438,  4471,  4505,  4539,
+   4572,  4605,  4639,  4672,  4705,  4738,  4771,  4803,  4836,  4869,  4901,  4933,
+   4966,  4998,  5030,  5062,  5094,  5125,  5157,  5188,  5220,  5251,  5282,  5313,
+   5344,  5375,  5406,  5437,  5467,  5498,  5528,  5559,  5589,  5619,  5649,  5679,
+   5708,  5738,  5768,  5797,  5826,  5856,  5885,  5914,  5943,  5972,  6000,  6029,
+   6058,  6086,  6114,  6142,  6171,  6199,  6227,  6254,  6282,  6310,  6337,  6365,
+   6392,  6419,  6446,  6473,  6500,  6527,  6554,  6580,  6607,  6633,  6660,  6686,
+   6712,  6738,  6764,  6790,  6815,  6841,  6867,  6892,  6917,  6943,  6968,  6993,
+   7018,  7043,  7068,  7092,  7117,  7141,  7166,  7190,  7214,  7238,  7262,  7286,
+   7310,  7334,  7358,  7381,  7405,  7428,  7451,  7475,  7498,  7521,  7544,  7566,
+   7589,  7612,  7635,  7657,  7679,  7702,  7724,  7746,  7768,  7790,  7812,  7834,
+   7856,  7877,  7899,  7920,  7942,  7963,  7984,  8005,  8026,  8047,  8068,  8089,
+   8110,  8131,  8151,  8172,  8192,
+};
+#else
+  #error "WLED_TRIG_LUT_BITS must be 6 or 8"
+#endif
+
+// linear interpolation between table entries, pos has (WLED_TRIG_LUT_BITS + shift) bits per quarter
+static inline int32_t lutLookup(const int16_t *lut, uint32_t pos, unsigned shift)
+{
+  uint32_t idx  = pos >> shift;
+  uint32_t frac = pos & ((1U << shift) - 1);
+  int32_t v = (int16_t)pgm_read_word(lut + idx);
+  if (frac) v += (((int32_t)(int16_t)pgm_read_word(lut + idx + 1) - v) * (int32_t)frac) >> shift; // last entry is never interpolated
+  return v;
+}
+
+// angle has 2 bits for quadrant and quarterBits bits within quadrant
+static inline int32_t sinLookup(uint32_t angle, unsigned quarterBits)
+{
+  const uint32_t quarter = 1U << quarterBits;
+  uint32_t pos = angle & (quarter - 1);
+  if (angle & quarter) pos = quarter - pos; // 2nd and 4th quadrant are mirrored
+  int32_t v = lutLookup(sinLUT, pos, quarterBits - WLED_TRIG_LUT_BITS);
+  return (angle & (quarter << 1)) ? -v : v;  // 3rd and 4th quadrant are negative
+}
+
+// fixed point sin16_t()/cos16_t(): angle 0-65535 for full turn, returns -32767 to 32767
+static inline int16_t lutSin16(uint16_t angle) { return sinLookup(angle, 14); }
+
+static inline int16_t lutCos16(uint16_t angle) { return sinLookup((uint16_t)(angle + 0x4000), 14); }
+
+// atan2_16_t(): angle of vector (x,y) as fraction of full turn, counterclockwise from positive X axis
+static inline uint16_t lutAtan2_16(int32_t y, int32_t x)
+{
+  if (x == 0 && y == 0) return 0;
+  uint32_t ax = x < 0 ? -(uint32_t)x : x;
+  uint32_t ay = y < 0 ? -(uint32_t)y : y;
+  bool swap = ay > ax; // reduce to first octant
+  uint32_t num = swap ? ax : ay;
+  uint32_t den = swap ? ay : ax;
+  while (den >= (1U << 17)) { num >>= 1; den >>= 1; } // keep (num << 14) within 32 bits
+  uint32_t ratio = (num << 14) / den; // 0-16384 for 0-1
+  uint32_t a = lutLookup(atanLUT, ratio, 14 - WLED_TRIG_LUT_BITS);
+  if (swap)  a = 0x4000 - a;
+  if (x < 0) a = 0x8000 - a;
+  if (y < 0) a = 0x10000 - a;
+  return a;
+}
+
+// float angle is converted into 22 bit fraction of full turn (20 bits per quadrant, enough for interpolation)
+#define RAD_TO_ANGLE22 (4194304.0f / 6.28318530717958647692f)
+
+static inline uint32_t lutAngle(float x) { return (uint32_t)(int64_t)(x * RAD_TO_ANGLE22); }
+
+static inline float lutSin(float x) { return sinLookup(lutAngle(x), 20) * (1.0f / 32767.0f); }
+
+static inline float lutCos(float x) { return sinLookup(lutAngle(x) + (1U << 20), 20) * (1.0f / 32767.0f); }
+
+static inline float lutTan(float x)
+{
+  uint32_t angle = lutAngle(x);
+  int32_t c = sinLookup(angle + (1U << 20), 20);
+  if (c == 0) return 0;
+  return float(sinLookup(angle, 20)) / c;
+}
+
+#endif
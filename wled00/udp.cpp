@@ -1,4 +1,5 @@
 #include "wled.h"
+#include "realtime_ingest.h"
 
 /*
  * UDP sync notifier / Realtime / Hyperion / TPM2.NET
@@ -9,6 +10,8 @@
 #define WLEDPACKETSIZE (41+(MAX_NUM_SEGMENTS*UDP_SEG_SIZE)+0)
 #define UDP_IN_MAXSIZE 1472
 #define PRESUMED_NETWORK_DELAY 3 //how many ms could it take on avg to reach the receiver? This will be added to transmitted times
+#define UDP_SYNC_DELTA 13           //v13 delta packet: [13, sequence, (offset MSB, offset LSB, length, data)...] patching the last full state
+#define UDP_SYNC_SNAPSHOT_REQUEST 14 //v13 receiver missed a packet and asks sender for full state
 
 typedef struct PartialEspNowPacket {
   uint8_t magic;
@@ -17,6 +20,33 @@ typedef struct PartialEspNowPacket {
   uint8_t data[247];
 } partial_packet_t;
 
+// v13 sync state (sender): sequence of last state sent and what receivers are expected to have
+static uint8_t syncSequence = 0;
+static byte   *syncBase = nullptr;       // state current sequence is delta encoded against
+static size_t  syncBaseLen = 0;
+static byte   *syncSent = nullptr;       // last state sent
+static size_t  syncSentLen = 0;
+static bool    syncSentFull = false;     // current sequence was first sent as full packet
+static bool    syncSnapshotRequested = false;
+
+// v13 sync state (receiver): last state received from each sender, delta packets patch the one of their sender
+#ifdef ESP8266
+#define SYNC_SOURCES 2
+#else
+#define SYNC_SOURCES 4
+#endif
+typedef struct SyncSource {
+  IPAddress     ip;
+  byte         *image = nullptr;
+  size_t        len = 0;           // 0: no valid state
+  uint8_t       seq = 0;
+  uint32_t      uptime = 0;        // sender millis() + timebase of last state
+  unsigned long lastSeen = 0;
+} sync_source_t;
+static sync_source_t syncSources[SYNC_SOURCES];
+
+static void sendSyncPacket(byte callMode, bool followUp, bool fullSnapshot);
+
 void notify(byte callMode, bool followUp)
 {
 #ifndef WLED_DISABLE_ESPNOW
@@ -37,7 +67,53 @@ void notify(byte callMode, bool followUp)
     case CALL_MODE_ALEXA:         if (!notifyAlexa)  return; break;
     default: return;
   }
-  byte udpOut[WLEDPACKETSIZE];  //TODO: optimize size to use only active segments
+  sendSyncPacket(callMode, followUp, false);
+}
+
+// v13 delta sync: sends only bytes that changed since the state receivers already have
+// returns false if a full packet needs to be sent instead (no common base or delta would not be smaller)
+static bool sendSyncDelta(const byte *image, size_t len, bool followUp, IPAddress broadcastIp) {
+  if (!syncBase) syncBase = (byte*)malloc(WLEDPACKETSIZE+1);
+  if (!syncBase || !syncSent) return false;
+  if (!followUp) { // new sequence: last state sent is what receivers have
+    memcpy(syncBase, syncSent, syncSentLen);
+    syncBaseLen = syncSentLen;
+    syncSentFull = false;
+  }
+  if (!syncBaseLen || syncSentFull) return false;
+
+  // followUp flag and time fields (24-35) are always sent, receivers may have a retransmission with other values
+  auto changed = [&](size_t i) { return (i >= 24 && i <= 35) || i >= syncBaseLen || image[i] != syncBase[i]; };
+  // finds next run of changed bytes at or after i, short gaps of unchanged bytes are included (cheaper than a new run header)
+  auto nextRun = [&](size_t &i, size_t &end) {
+    while (i < len && !changed(i)) i++;
+    if (i >= len) return false;
+    end = i + 1;
+    for (size_t look = end; look < len && look - i < 255 && look - end < 3; look++) if (changed(look)) end = look + 1;
+    return true;
+  };
+  size_t deltaLen = 2, i = 1, end; // byte 0 (protocol) never changes
+  while (nextRun(i, end)) { deltaLen += 3 + end - i; i = end; }
+  if (deltaLen >= len) return false; // delta not smaller than full packet
+
+  DEBUG_PRINTF_P(PSTR("UDP sending delta: %u/%u bytes\n"), (unsigned)deltaLen, (unsigned)len);
+  byte header[3] = {UDP_SYNC_DELTA, syncSequence};
+  notifierUdp.beginPacket(broadcastIp, udpPort);
+  notifierUdp.write(header, 2);
+  for (i = 1; nextRun(i, end); i = end) {
+    header[0] = i >> 8;
+    header[1] = i & 0xFF;
+    header[2] = end - i;
+    notifierUdp.write(header, 3);
+    notifierUdp.write(image + i, end - i);
+  }
+  notifierUdp.endPacket();
+  return true;
+}
+
+static void sendSyncPacket(byte callMode, bool followUp, bool fullSnapshot)
+{
+  byte udpOut[WLEDPACKETSIZE+1]; // +1 for sequence number
   Segment& mainseg = strip.getMainSegment();
   udpOut[0] = 0; //0: wled notifier protocol 1: WARLS protocol
   udpOut[1] = callMode;
@@ -56,8 +132,8 @@ void notify(byte callMode, bool followUp)
   //3: supports FX intensity, 24 byte packet 4: supports transitionDelay 5: sup palette
   //6: supports timebase syncing, 29 byte packet 7: supports tertiary color 8: supports sys time sync, 36 byte packet
   //9: supports sync groups, 37 byte packet 10: supports CCT, 39 byte packet 11: per segment options, variable packet length (40+MAX_NUM_SEGMENTS*3)
-  //12: enhanced effect sliders, 2D & mapping options
-  udpOut[11] = 12;
+  //12: enhanced effect sliders, 2D & mapping options 13: sequence number after segments, delta packets
+  udpOut[11] = 13;
   col = mainseg.colors[1];
   udpOut[12] = R(col);
   udpOut[13] = G(col);
@@ -148,9 +224,22 @@ void notify(byte callMode, bool followUp)
 
   //uint16_t offs = SEG_OFFSET;
   //next value to be added has index: udpOut[offs + 0]
+  size_t packetLen = SEG_OFFSET + s*UDP_SEG_SIZE;
+  if (!syncSent) syncSent = (byte*)malloc(WLEDPACKETSIZE+1);
+  if (!followUp) syncSequence++; // new state, retransmissions keep sequence so receivers can skip them
+  else if (syncSentLen) {
+    // retransmission carries the state first sent with this sequence, only followUp flag and time are refreshed
+    byte fresh[12];
+    memcpy(fresh, udpOut + 24, sizeof(fresh));
+    memcpy(udpOut, syncSent, syncSentLen);
+    memcpy(udpOut + 24, fresh, sizeof(fresh));
+    packetLen = syncSentLen;
+    s = (packetLen - SEG_OFFSET) / UDP_SEG_SIZE;
+  }
+  udpOut[packetLen] = syncSequence;
 
 #ifndef WLED_DISABLE_ESPNOW
-  if (enableESPNow && useESPNowSync && statusESPNow == ESP_NOW_STATE_ON) {
+  if (!fullSnapshot && enableESPNow && useESPNowSync && statusESPNow == ESP_NOW_STATE_ON) {
     partial_packet_t buffer = {'W', 0, 1, {0}};
     // send global data
     DEBUG_PRINTLN(F("ESP-NOW sending first packet."));
@@ -197,16 +286,88 @@ void notify(byte callMode, bool followUp)
   {
     DEBUG_PRINTLN(F("UDP sending packet."));
     IPAddress broadcastIp = ~uint32_t(Network.subnetMask()) | uint32_t(Network.gatewayIP());
-    notifierUdp.beginPacket(broadcastIp, udpPort);
-    notifierUdp.write(udpOut, WLEDPACKETSIZE); // TODO: add actual used buffer size
-    notifierUdp.endPacket();
+    if (!udpSyncDelta || fullSnapshot || !sendSyncDelta(udpOut, packetLen, followUp, broadcastIp)) {
+      notifierUdp.beginPacket(broadcastIp, udpPort);
+      notifierUdp.write(udpOut, packetLen + 1);
+      notifierUdp.endPacket();
+      if (!followUp) syncSentFull = true;
+    }
+  }
+  if (!followUp && syncSent) {
+    memcpy(syncSent, udpOut, packetLen);
+    syncSentLen = packetLen;
   }
   notificationSentCallMode = callMode;
   notificationSentTime = millis();
-  notificationCount = followUp ? notificationCount + 1 : 0;
+  if (!fullSnapshot) notificationCount = followUp ? notificationCount + 1 : 0;
+}
+
+// state kept for sender src; if create is set an entry is made (replacing the sender heard from least recently)
+static sync_source_t *findSyncSource(IPAddress src, bool create) {
+  sync_source_t *oldest = nullptr;
+  for (auto &s : syncSources) {
+    if (s.len && s.ip == src) return &s;
+    if (!oldest) oldest = &s;
+    else if (oldest->len && (!s.len || millis() - s.lastSeen > millis() - oldest->lastSeen)) oldest = &s;
+  }
+  if (!create) return nullptr;
+  if (!oldest->image) oldest->image = (byte*)calloc(WLEDPACKETSIZE+1, 1);
+  if (!oldest->image) return nullptr;
+  oldest->ip  = src;
+  oldest->len = 0;
+  return oldest;
+}
+
+// sender millis() + timebase (packet bytes 25-28), going backwards means the sender restarted and its sequence started over
+static inline uint32_t syncUptime(const byte *t) {
+  return (uint32_t(t[0]) << 24) | (uint32_t(t[1]) << 16) | (uint32_t(t[2]) << 8) | t[3];
+}
+
+// keeps a copy of a full v13 packet as base for following delta packets, returns false if it is a retransmission
+static bool storeSyncImage(const byte *udpIn, size_t len, IPAddress src) {
+  if (len <= SEG_OFFSET || udpIn[11] < 13) return true; // older sender
+  const size_t packetLen = SEG_OFFSET + udpIn[39] * udpIn[40];
+  if (len <= packetLen || packetLen > WLEDPACKETSIZE) return true;
+  const uint8_t seq = udpIn[packetLen];
+  const uint32_t uptime = syncUptime(udpIn + 25);
+  sync_source_t *s = findSyncSource(src, true);
+  if (!s) return true;
+  // retransmissions have the followUp flag set, a first transmission with a known sequence is a restarted sender
+  if (s->len && seq == s->seq && udpIn[24] && int32_t(uptime - s->uptime) >= 0) return false;
+  memcpy(s->image, udpIn, packetLen);
+  s->len      = packetLen;
+  s->seq      = seq;
+  s->uptime   = uptime;
+  s->lastSeen = millis();
+  return true;
+}
+
+// copies n bytes at pos of the state a delta packet patches, returns false if the packet does not contain all of them
+static bool readSyncDelta(const byte *udpIn, size_t len, size_t pos, byte *out, size_t n) {
+  for (size_t i = 2; i + 3 <= len; ) {
+    const size_t ofs = (udpIn[i] << 8) | udpIn[i+1];
+    const size_t cnt = udpIn[i+2];
+    i += 3;
+    if (i + cnt > len) return false;
+    if (ofs <= pos && ofs + cnt >= pos + n) { memcpy(out, udpIn + i + pos - ofs, n); return true; }
+    i += cnt;
+  }
+  return false;
 }
 
-void parseNotifyPacket(uint8_t *udpIn) {
+static void requestSyncSnapshot(IPAddress src) {
+  static unsigned long lastRequest = 0;
+  if (millis() - lastRequest < 250) return; // sender answers with a broadcast, no need to ask for every packet
+  lastRequest = millis();
+  DEBUG_PRINT(F("UDP requesting sync snapshot from: ")); DEBUG_PRINTLN(src);
+  byte request = UDP_SYNC_SNAPSHOT_REQUEST;
+  notifierUdp.beginPacket(src, udpPort);
+  notifierUdp.write(&request, 1);
+  notifierUdp.endPacket();
+}
+
+// segMask: segments (packet slots) to apply, delta packets only apply segments that changed
+void parseNotifyPacket(uint8_t *udpIn, const std::bitset<MAX_NUM_SEGMENTS> &segMask = std::bitset<MAX_NUM_SEGMENTS>().set()) {
   //ignore notification if received within a second after sending a notification ourselves
   if (millis() - notificationSentTime < 1000) return;
   if (udpIn[1] > 199) return; //do not receive custom versions
@@ -290,6 +451,7 @@ void parseNotifyPacket(uint8_t *udpIn) {
           id += inactiveSegs; // adjust id
         }
       }
+      if (!segMask[i]) continue; // unchanged since last packet
       DEBUG_PRINT(F("UDP segment processing: ")); DEBUG_PRINTLN(id);
 
       uint16_t start  = (udpIn[1+ofs] << 8 | udpIn[2+ofs]);
@@ -402,9 +564,50 @@ void parseNotifyPacket(uint8_t *udpIn) {
   stateUpdated(CALL_MODE_NOTIFICATION);
 }
 
+// applies v13 delta packet to last full state received from its sender and parses the result
+static void handleSyncDelta(const byte *udpIn, size_t len, IPAddress src) {
+  if (len < 2) return;
+  const uint8_t seq = udpIn[1];
+  byte head[5]; // followUp flag and uptime (24-28), always part of a delta
+  if (!readSyncDelta(udpIn, len, 24, head, sizeof(head))) return;
+  sync_source_t *s = findSyncSource(src, false);
+  if (s && int32_t(syncUptime(head + 1) - s->uptime) < 0) s->len = 0; // sender restarted, state is not our base
+  if (s && s->len && seq == s->seq && head[0]) return; // retransmission
+  if (!s || !s->len || seq != uint8_t(s->seq + 1)) {
+    requestSyncSnapshot(src); // missed a packet (or never had full state)
+    return;
+  }
+  byte *syncImage = s->image;
+  std::bitset<MAX_NUM_SEGMENTS> segMask;
+  for (size_t i = 2; i < len; ) {
+    if (i + 3 > len) break;
+    const size_t ofs = (udpIn[i] << 8) | udpIn[i+1];
+    const size_t n   = udpIn[i+2];
+    i += 3;
+    if (i + n > len || ofs + n > WLEDPACKETSIZE) { // malformed or from build with more segments
+      s->len = 0;
+      requestSyncSnapshot(src);
+      return;
+    }
+    memcpy(syncImage + ofs, udpIn + i, n);
+    i += n;
+    if (ofs + n > s->len) s->len = ofs + n;
+    if (ofs + n > SEG_OFFSET) {
+      const unsigned first = ofs > SEG_OFFSET ? (ofs - SEG_OFFSET) / UDP_SEG_SIZE : 0;
+      const unsigned last  = (ofs + n - 1 - SEG_OFFSET) / UDP_SEG_SIZE;
+      for (unsigned seg = first; seg <= last && seg < MAX_NUM_SEGMENTS; seg++) segMask.set(seg);
+    }
+  }
+  s->seq      = seq;
+  s->uptime   = syncUptime(head + 1);
+  s->lastSeen = millis();
+  parseNotifyPacket(syncImage, segMask);
+}
+
 void realtimeLock(uint32_t timeoutMs, byte md)
 {
   if (!realtimeMode && !realtimeOverride) {
+    RenderLock lock; // let render task finish its frame, it stops drawing in realtime mode
     unsigned stop, start;
     if (useMainSegmentOnly) {
       Segment& mainseg = strip.getMainSegment();
@@ -446,6 +649,7 @@ void exitRealtime() {
   realtimeTimeout = 0; // cancel realtime mode immediately
   realtimeMode = REALTIME_MODE_INACTIVE; // inform UI immediately
   realtimeIP[0] = 0;
+  strip.repaintUnchanged(); // LEDs still show realtime data, Solid segments did not change since realtime started
   if (useMainSegmentOnly) { // unfreeze live segment again
     strip.getMainSegment().freeze = false;
   } else {
@@ -474,7 +678,16 @@ void handleNotifications()
     notify(notificationSentCallMode,true);
   }
 
-  if (e131NewData && millis() - strip.getLastShow() > 15)
+  //answer v13 receivers that missed a delta packet
+  if (syncSnapshotRequested && udpConnected && (millis()-notificationSentTime) > 100) {
+    syncSnapshotRequested = false;
+    if (udpSyncDelta && syncGroups && sendNotificationsRT) sendSyncPacket(notificationSentCallMode, false, true);
+  }
+
+  handleE131Frame(); // flush incomplete E1.31/Art-Net frames
+  handleDDPQueue();  // present DDP frames at their timecode
+  // assembled E1.31/Art-Net frames are shown at once, DDP without push flag is rate limited
+  if (e131NewData && (realtimeMode != REALTIME_MODE_DDP || millis() - strip.getLastShow() > 15))
   {
     e131NewData = false;
     strip.show();
@@ -505,13 +718,7 @@ void handleNotifications()
       rgbUdp.read(lbuf, packetSize);
       realtimeLock(realtimeTimeoutMs, REALTIME_MODE_HYPERION);
       if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
-      unsigned id = 0;
-      unsigned totalLen = strip.getLengthTotal();
-      for (size_t i = 0; i < packetSize -2; i += 3)
-      {
-        setRealtimePixel(id, lbuf[i], lbuf[i+1], lbuf[i+2], 0);
-        id++; if (id >= totalLen) break;
-      }
+      setRealtimePixels(0, packetSize / 3, lbuf, 3);
       if (!(realtimeMode && useMainSegmentOnly)) strip.show();
       return;
     }
@@ -562,7 +769,17 @@ void handleNotifications()
   if (udpIn[0] == 0 && !realtimeMode && receiveGroups)
   {
     DEBUG_PRINT(F("UDP notification from: ")); DEBUG_PRINTLN(notifierUdp.remoteIP());
-    parseNotifyPacket(udpIn);
+    if (storeSyncImage(udpIn, len, notifierUdp.remoteIP())) parseNotifyPacket(udpIn);
+    return;
+  }
+
+  //v13 sync delta and snapshot request
+  if (udpIn[0] == UDP_SYNC_DELTA && !isSupp && !realtimeMode && receiveGroups) {
+    handleSyncDelta(udpIn, len, notifierUdp.remoteIP());
+    return;
+  }
+  if (udpIn[0] == UDP_SYNC_SNAPSHOT_REQUEST && !isSupp && len == 1) {
+    syncSnapshotRequested = true;
     return;
   }
 
@@ -589,16 +806,7 @@ void handleNotifications()
     byte numPackets = udpIn[5];
 
     unsigned id = (tpmPayloadFrameSize/3)*(packetNum-1); //start LED
-    unsigned totalLen = strip.getLengthTotal();
-    for (size_t i = 6; i < tpmPayloadFrameSize + 4U; i += 3)
-    {
-      if (id < totalLen)
-      {
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], 0);
-        id++;
-      }
-      else break;
-    }
+    setRealtimePixels(id, tpmPayloadFrameSize/3, udpIn + 6, 3);
     if (tpmPacketCount == numPackets) //reset packet count and show if all packets were received
     {
       tpmPacketCount = 0;
@@ -623,7 +831,6 @@ void handleNotifications()
     }
     if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
 
-    unsigned totalLen = strip.getLengthTotal();
     if (udpIn[0] == 1 && packetSize > 5) //warls
     {
       for (size_t i = 2; i < packetSize -3; i += 4)
@@ -632,40 +839,18 @@ void handleNotifications()
       }
     } else if (udpIn[0] == 2 && packetSize > 4) //drgb
     {
-      unsigned id = 0;
-      for (size_t i = 2; i < packetSize -2; i += 3)
-      {
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], 0);
-
-        id++; if (id >= totalLen) break;
-      }
+      setRealtimePixels(0, (packetSize - 2) / 3, udpIn + 2, 3);
     } else if (udpIn[0] == 3 && packetSize > 6) //drgbw
     {
-      unsigned id = 0;
-      for (size_t i = 2; i < packetSize -3; i += 4)
-      {
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], udpIn[i+3]);
-
-        id++; if (id >= totalLen) break;
-      }
+      setRealtimePixels(0, (packetSize - 2) / 4, udpIn + 2, 4);
     } else if (udpIn[0] == 4 && packetSize > 7) //dnrgb
     {
       unsigned id = ((udpIn[3] << 0) & 0xFF) + ((udpIn[2] << 8) & 0xFF00);
-      for (size_t i = 4; i < packetSize -2; i += 3)
-      {
-        if (id >= totalLen) break;
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], 0);
-        id++;
-      }
+      setRealtimePixels(id, (packetSize - 4) / 3, udpIn + 4, 3);
     } else if (udpIn[0] == 5 && packetSize > 8) //dnrgbw
     {
       unsigned id = ((udpIn[3] << 0) & 0xFF) + ((udpIn[2] << 8) & 0xFF00);
-      for (size_t i = 4; i < packetSize -2; i += 4)
-      {
-        if (id >= totalLen) break;
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], udpIn[i+3]);
-        id++;
-      }
+      setRealtimePixels(id, (packetSize - 4) / 4, udpIn + 4, 4);
     }
     strip.show();
     return;
@@ -708,6 +893,23 @@ void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w)
   }
 }
 
+// bulk variant of setRealtimePixel() for packed RGB (3) or RGBW (4) channel data of count consecutive LEDs
+void setRealtimePixels(unsigned i, unsigned count, const uint8_t *data, unsigned channelsPerLed)
+{
+  if (useMainSegmentOnly) { // segment handles its own mapping, use per-pixel path
+    for (unsigned n = 0; n < count; n++, data += channelsPerLed)
+      setRealtimePixel(i + n, data[0], data[1], data[2], channelsPerLed > 3 ? data[3] : 0);
+    return;
+  }
+  // LEDs shifted before the start of the strip by a negative offset are dropped, same as setRealtimePixel()
+  const int first = int(i) + arlsOffset;
+  auto sink = [](unsigned pix, unsigned n, const uint32_t *c) { strip.setPixelRange(pix, n, c); };
+  if (!arlsDisableGammaCorrection && gammaCorrectCol)
+    ingestRealtimeRun(first, count, data, channelsPerLed, strip.getLengthTotal(), [](uint8_t v) { return gamma8(v); }, sink);
+  else
+    ingestRealtimeRun(first, count, data, channelsPerLed, strip.getLengthTotal(), [](uint8_t v) { return v; }, sink);
+}
+
 /*********************************************************************************************\
    Refresh aging for remote units, drop if too old...
 \*********************************************************************************************/
@@ -820,32 +1022,80 @@ void sendSysInfoUDP()
 static       size_t sequenceNumber = 0; // this needs to be shared across all outputs
 static const size_t ART_NET_HEADER_SIZE = 12;
 static const byte   ART_NET_HEADER[] PROGMEM = {0x41,0x72,0x74,0x2d,0x4e,0x65,0x74,0x00,0x00,0x50,0x00,0x0e};
+static const size_t ART_NET_DATA_OFFSET = 18;
+static const byte   E131_ACN_ID[] PROGMEM = {0x41,0x53,0x43,0x2d,0x45,0x31,0x2e,0x31,0x37,0x00,0x00,0x00}; // "ASC-E1.17"
+#define E131_OUT_PRIORITY 100 // default E1.31 priority
+#define NET_OUT_BUFFER_SIZE (DDP_HEADER_LEN + DDP_CHANNELS_PER_PACKET) // largest packet of all protocols
+
+// one socket and one packet buffer shared by all network buses, buses are sent one after another
+static WiFiUDP netOutUdp;
+static byte   *netOutBuffer = nullptr;
+static byte    e131Sequence = 0;
+
+// copies channel data into packet buffer applying brightness
+static inline void copyScaled(byte *dst, const byte *src, size_t len, uint8_t bri) {
+  if (bri == 255) memcpy(dst, src, len); // scale8() is identity for full brightness
+  else for (size_t i = 0; i < len; i++) dst[i] = scale8(src[i], bri);
+}
+
+static inline void putU16(byte *dst, uint16_t v) { dst[0] = v >> 8; dst[1] = v & 0xFF; } // MSB first
+static inline void putU32(byte *dst, uint32_t v) { putU16(dst, v >> 16); putU16(dst + 2, v & 0xFFFF); }
+
+static bool sendNetPacket(IPAddress client, uint16_t port, size_t size) {
+  if (!netOutUdp.beginPacket(client, port)) return false;
+  netOutUdp.write(netOutBuffer, size);
+  return netOutUdp.endPacket();
+}
+
+// writes E1.31 root, framing and DMP layer headers for a packet carrying dataLen channels
+static void prepareE131Header(byte *buf, uint16_t universe, uint16_t dataLen, byte sequence) {
+  static byte cid[16] = {0};
+  if (!cid[0]) { // component identifier has to be stable for a source, derive it from MAC
+    memcpy_P(cid, PSTR("WLED"), 4);
+    WiFi.macAddress(cid + 4);
+    cid[10] = 0x01;
+  }
+  const size_t packetLen = E131_DMP_DATA + 1 + dataLen;
+  memset(buf, 0, E131_DMP_DATA + 1);
+  putU16(buf, 0x0010);                                                         // preamble size
+  memcpy_P(buf + E131_ROOT_ID, E131_ACN_ID, sizeof(E131_ACN_ID));
+  putU16(buf + E131_ROOT_FLENGTH, 0x7000 | (packetLen - E131_ROOT_FLENGTH));
+  putU32(buf + E131_ROOT_VECTOR, 0x00000004);                                  // VECTOR_ROOT_E131_DATA
+  memcpy(buf + E131_ROOT_CID, cid, sizeof(cid));
+  putU16(buf + E131_FRAME_FLENGTH, 0x7000 | (packetLen - E131_FRAME_FLENGTH));
+  putU32(buf + E131_FRAME_VECTOR, 0x00000002);                                 // VECTOR_E131_DATA_PACKET
+  strlcpy((char*)buf + E131_FRAME_SOURCE, serverDescription, 64);
+  buf[E131_FRAME_PRIORITY] = E131_OUT_PRIORITY;
+  buf[E131_FRAME_SEQ] = sequence;
+  putU16(buf + E131_FRAME_UNIVERSE, universe);
+  putU16(buf + E131_DMP_FLENGTH, 0x7000 | (packetLen - E131_DMP_FLENGTH));
+  buf[E131_DMP_VECTOR] = 0x02;                                                 // VECTOR_DMP_SET_PROPERTY
+  buf[E131_DMP_TYPE] = 0xA1;
+  putU16(buf + E131_DMP_ADDR_INC, 0x0001);
+  putU16(buf + E131_DMP_COUNT, dataLen + 1);                                   // including start code (0)
+}
 
 uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri, bool isRGBW)  {
   if (!(apActive || interfacesInited) || !client[0] || !length) return 1;  // network not initialised or dummy/unset IP address  031522 ajn added check for ap
 
-  WiFiUDP ddpUdp;
+  if (!netOutBuffer) netOutBuffer = (byte*)malloc(NET_OUT_BUFFER_SIZE);
+  if (!netOutBuffer) return 1;
+
+  const size_t channelCount = length * (isRGBW? 4:3); // 1 channel for every R,G,B,(W?) value
+  size_t bufferOffset = 0;
 
   switch (type) {
     case 0: // DDP
     {
       // calculate the number of UDP packets we need to send
-      size_t channelCount = length * (isRGBW? 4:3); // 1 channel for every R,G,B value
       size_t packetCount = ((channelCount-1) / DDP_CHANNELS_PER_PACKET) +1;
 
       // there are 3 channels per RGB pixel
       uint32_t channel = 0; // TODO: allow specifying the start channel
-      // the current position in the buffer
-      size_t bufferOffset = 0;
 
       for (size_t currentPacket = 0; currentPacket < packetCount; currentPacket++) {
         if (sequenceNumber > 15) sequenceNumber = 0;
 
-        if (!ddpUdp.beginPacket(client, DDP_DEFAULT_PORT)) {  // port defined in ESPAsyncE131.h
-          //DEBUG_PRINTLN(F("WiFiUDP.beginPacket returned an error"));
-          return 1; // problem
-        }
-
         // the amount of data is AFTER the header in the current packet
         size_t packetSize = DDP_CHANNELS_PER_PACKET;
 
@@ -860,30 +1110,17 @@ uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8
         }
 
         // write the header
-        /*0*/ddpUdp.write(flags);
-        /*1*/ddpUdp.write(sequenceNumber++ & 0x0F); // sequence may be unnecessary unless we are sending twice (as requested in Sync settings)
-        /*2*/ddpUdp.write(isRGBW ?  DDP_TYPE_RGBW32 : DDP_TYPE_RGB24);
-        /*3*/ddpUdp.write(DDP_ID_DISPLAY);
-        // data offset in bytes, 32-bit number, MSB first
-        /*4*/ddpUdp.write(0xFF & (channel >> 24));
-        /*5*/ddpUdp.write(0xFF & (channel >> 16));
-        /*6*/ddpUdp.write(0xFF & (channel >>  8));
-        /*7*/ddpUdp.write(0xFF & (channel      ));
-        // data length in bytes, 16-bit number, MSB first
-        /*8*/ddpUdp.write(0xFF & (packetSize >> 8));
-        /*9*/ddpUdp.write(0xFF & (packetSize     ));
-
-        // write the colors, the write write(const uint8_t *buffer, size_t size)
-        // function is just a loop internally too
-        for (size_t i = 0; i < packetSize; i += (isRGBW?4:3)) {
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // R
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // G
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // B
-          if (isRGBW) ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // W
-        }
-
-        if (!ddpUdp.endPacket()) {
-          //DEBUG_PRINTLN(F("WiFiUDP.endPacket returned an error"));
+        netOutBuffer[0] = flags;
+        netOutBuffer[1] = sequenceNumber++ & 0x0F; // sequence may be unnecessary unless we are sending twice (as requested in Sync settings)
+        netOutBuffer[2] = isRGBW ?  DDP_TYPE_RGBW32 : DDP_TYPE_RGB24;
+        netOutBuffer[3] = DDP_ID_DISPLAY;
+        putU32(netOutBuffer + 4, channel);    // data offset in bytes
+        putU16(netOutBuffer + 8, packetSize); // data length in bytes
+        copyScaled(netOutBuffer + DDP_HEADER_LEN, buffer + bufferOffset, packetSize, bri);
+        bufferOffset += packetSize;
+
+        if (!sendNetPacket(client, DDP_DEFAULT_PORT, DDP_HEADER_LEN + packetSize)) {  // port defined in ESPAsyncE131.h
+          //DEBUG_PRINTLN(F("DDP packet could not be sent"));
           return 1; // problem
         }
 
@@ -893,29 +1130,41 @@ uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8
 
     case 1: //E1.31
     {
+      // whole pixels per universe: 510/3=170 RGB LEDs, 512/4=128 RGBW LEDs
+      const size_t E131_CHANNELS_PER_PACKET = isRGBW?512:510;
+      const size_t packetCount = ((channelCount-1)/E131_CHANNELS_PER_PACKET)+1;
+
+      e131Sequence++; // sequence is per universe, all universes of a frame share it
+
+      for (size_t currentPacket = 0; currentPacket < packetCount; currentPacket++) {
+        size_t packetSize = E131_CHANNELS_PER_PACKET;
+        if (currentPacket == (packetCount - 1U) && (channelCount % E131_CHANNELS_PER_PACKET)) {
+          packetSize = channelCount % E131_CHANNELS_PER_PACKET; // last packet
+        }
+
+        prepareE131Header(netOutBuffer, currentPacket + 1, packetSize, e131Sequence); // universes start at 1
+        copyScaled(netOutBuffer + E131_DMP_DATA + 1, buffer + bufferOffset, packetSize, bri);
+        bufferOffset += packetSize;
+
+        if (!sendNetPacket(client, E131_DEFAULT_PORT, E131_DMP_DATA + 1 + packetSize)) {
+          DEBUG_PRINTLN(F("E1.31 packet could not be sent"));
+          return 1; // borked
+        }
+      }
     } break;
 
     case 2: //ArtNet
     {
       // calculate the number of UDP packets we need to send
-      const size_t channelCount = length * (isRGBW?4:3); // 1 channel for every R,G,B,(W?) value
       const size_t ARTNET_CHANNELS_PER_PACKET = isRGBW?512:510; // 512/4=128 RGBW LEDs, 510/3=170 RGB LEDs
       const size_t packetCount = ((channelCount-1)/ARTNET_CHANNELS_PER_PACKET)+1;
 
-      uint32_t channel = 0; 
-      size_t bufferOffset = 0;
-
       sequenceNumber++;
 
       for (size_t currentPacket = 0; currentPacket < packetCount; currentPacket++) {
 
         if (sequenceNumber > 255) sequenceNumber = 0;
 
-        if (!ddpUdp.beginPacket(client, ARTNET_DEFAULT_PORT)) {
-          DEBUG_PRINTLN(F("Art-Net WiFiUDP.beginPacket returned an error"));
-          return 1; // borked
-        }
-
         size_t packetSize = ARTNET_CHANNELS_PER_PACKET;
 
         if (currentPacket == (packetCount - 1U)) {
@@ -925,28 +1174,19 @@ uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8
           }
         }
 
-        byte header_buffer[ART_NET_HEADER_SIZE];
-        memcpy_P(header_buffer, ART_NET_HEADER, ART_NET_HEADER_SIZE);
-        ddpUdp.write(header_buffer, ART_NET_HEADER_SIZE); // This doesn't change. Hard coded ID, OpCode, and protocol version.
-        ddpUdp.write(sequenceNumber & 0xFF); // sequence number. 1..255
-        ddpUdp.write(0x00); // physical - more an FYI, not really used for anything. 0..3
-        ddpUdp.write((currentPacket) & 0xFF); // Universe LSB. 1 full packet == 1 full universe, so just use current packet number.
-        ddpUdp.write(0x00); // Universe MSB, unused.
-        ddpUdp.write(0xFF & (packetSize >> 8)); // 16-bit length of channel data, MSB
-        ddpUdp.write(0xFF & (packetSize     )); // 16-bit length of channel data, LSB
-
-        for (size_t i = 0; i < packetSize; i += (isRGBW?4:3)) {
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // R
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // G
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // B
-          if (isRGBW) ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // W
-        }
-
-        if (!ddpUdp.endPacket()) {
-          DEBUG_PRINTLN(F("Art-Net WiFiUDP.endPacket returned an error"));
+        memcpy_P(netOutBuffer, ART_NET_HEADER, ART_NET_HEADER_SIZE); // This doesn't change. Hard coded ID, OpCode, and protocol version.
+        netOutBuffer[12] = sequenceNumber & 0xFF; // sequence number. 1..255
+        netOutBuffer[13] = 0x00; // physical - more an FYI, not really used for anything. 0..3
+        netOutBuffer[14] = currentPacket & 0xFF; // Universe LSB. 1 full packet == 1 full universe, so just use current packet number.
+        netOutBuffer[15] = 0x00; // Universe MSB, unused.
+        putU16(netOutBuffer + 16, packetSize); // 16-bit length of channel data
+        copyScaled(netOutBuffer + ART_NET_DATA_OFFSET, buffer + bufferOffset, packetSize, bri);
+        bufferOffset += packetSize;
+
+        if (!sendNetPacket(client, ARTNET_DEFAULT_PORT, ART_NET_DATA_OFFSET + packetSize)) {
+          DEBUG_PRINTLN(F("Art-Net packet could not be sent"));
           return 1; // borked
         }
-        channel += packetSize;
       }
     } break;
   }
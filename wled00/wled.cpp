@@ -112,6 +112,9 @@ void WLED::loop()
     handlePresets();
     yield();
 
+    #ifdef WLED_ENABLE_FX_BENCHMARK
+    strip.handleBenchmark();
+    #endif
     if (!offMode || strip.isOffRefreshRequired() || strip.needsUpdate())
       strip.service();
     #ifdef ESP8266
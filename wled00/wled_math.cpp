@@ -4,9 +4,14 @@
  * This implementation has no extra static memory usage.
  *
  * Source of the cos_t() function: https://web.eecs.utk.edu/~azh/blog/cosine.html (cos_taylor_literal_6terms)
+ *
+ * sin_lut()/cos_lut()/tan_lut() and fixed point sin16_t()/cos16_t()/atan2_16_t() use quarter wave lookup tables in flash
+ * (trig_lut.h) with linear interpolation and need no FPU. Build with -D WLED_USE_TRIG_LUT to use them for sin_t()/cos_t()/tan_t()
+ * (i.e. on ESP32-C3 which has no FPU), -D WLED_TRIG_LUT_BITS=6 reduces table resolution (2x130 bytes instead of 2x514 bytes).
  */
 
 #include <Arduino.h> //PI constant
+#include "trig_lut.h"
 
 //#define WLED_DEBUG_MATH
 
@@ -137,3 +142,45 @@ float fmod_t(float num, float denom) {
   #endif
   return res;
 }
+
+int16_t sin16_t(uint16_t angle)
+{
+  return lutSin16(angle);
+}
+
+int16_t cos16_t(uint16_t angle)
+{
+  return lutCos16(angle);
+}
+
+uint16_t atan2_16_t(int32_t y, int32_t x)
+{
+  return lutAtan2_16(y, x);
+}
+
+float sin_lut(float x)
+{
+  float res = lutSin(x);
+  #ifdef WLED_DEBUG_MATH
+  Serial.printf("sin_lut: %f,%f,%f,(%f)\n",x,res,sin(x),res-sin(x));
+  #endif
+  return res;
+}
+
+float cos_lut(float phi)
+{
+  float res = lutCos(phi);
+  #ifdef WLED_DEBUG_MATH
+  Serial.printf("cos_lut: %f,%f,%f,(%f)\n",phi,res,cos(phi),res-cos(phi));
+  #endif
+  return res;
+}
+
+float tan_lut(float x)
+{
+  float res = lutTan(x);
+  #ifdef WLED_DEBUG_MATH
+  Serial.printf("tan_lut: %f,%f,%f,(%f)\n",x,res,tan(x),res-tan(x));
+  #endif
+  return res;
+}
@@ -165,6 +165,12 @@ static void handleUpload(AsyncWebServerRequest *request, const String& filename,
     request->_tempFile = WLED_FS.open(finalname, "w");
     DEBUG_PRINT(F("Uploading "));
     DEBUG_PRINTLN(finalname);
+    #ifndef WLED_DISABLE_GIF
+    if (finalname.endsWith(F(".gif"))) { // converted frames of previous version are stale
+      String wfsName = finalname.substring(0, finalname.length() - 4) + F(".wfs");
+      if (WLED_FS.exists(wfsName)) WLED_FS.remove(wfsName);
+    }
+    #endif
     if (finalname.equals(FPSTR(getPresetsFileName()))) presetsModifiedTime = toki.second();
   }
   if (len) {
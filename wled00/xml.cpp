@@ -369,6 +369,7 @@ void getSettingsJS(byte subPage, char* dest)
     sappend('v',SET_F("FR"),strip.getTargetFps());
     sappend('v',SET_F("AW"),Bus::getGlobalAWMode());
     sappend('c',SET_F("LD"),useGlobalLedBuffer);
+    sappend('c',SET_F("VB"),useSegmentBuffer);
 
     unsigned sumMa = 0;
     for (int s = 0; s < BusManager::getNumBusses(); s++) {
@@ -514,6 +515,7 @@ void getSettingsJS(byte subPage, char* dest)
     sappend('c',SET_F("SB"),notifyButton);
     sappend('c',SET_F("SH"),notifyHue);
     sappend('v',SET_F("UR"),udpNumRetries);
+    sappend('c',SET_F("DL"),udpSyncDelta);
 
     sappend('c',SET_F("NL"),nodeListEnabled);
     sappend('c',SET_F("NB"),nodeBroadcastEnabled);